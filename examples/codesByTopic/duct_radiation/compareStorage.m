@@ -0,0 +1,27 @@
+% Compares the probe history of a run with structure-of-arrays storage
+% (./duct_radiation soa, or ./duct_radiation soaFloat) with the one of the
+% reference storage (./duct_radiation).
+%
+% The error is the largest difference of the pressure at the probes,
+% relative to the largest pressure of the reference. With soa, the kernels
+% only change the rounding. With soaFloat, the populations are rounded to
+% single precision at every cycle; on a reduced version of this case
+% (examples/codesByTopic/latticeVariants) the error is about 2e-8.
+% The tolerance is 1e-6.
+
+storage = 'soaFloat';
+tolerance = 1e-6;
+
+reference = readProbeHistory('tmp/history_probes.dat');
+candidate = readProbeHistory(['tmp/history_probes_' storage '.dat']);
+pressure = find(strcmp(reference.fields, 'pressure'));
+numSamples = min(size(reference.data, 1), size(candidate.data, 1));
+p_ref = reference.data(1:numSamples, :, pressure);
+p = candidate.data(1:numSamples, :, pressure);
+
+relativeError = max(abs(p(:) - p_ref(:))) / max(abs(p_ref(:)));
+if relativeError <= tolerance
+    fprintf('%s: max |p-p_ref|/max |p_ref| = %g (tolerance %g) PASS\n', storage, relativeError, tolerance);
+else
+    fprintf('%s: max |p-p_ref|/max |p_ref| = %g (tolerance %g) FAIL\n', storage, relativeError, tolerance);
+end
@@ -51,6 +51,26 @@ int main(int argc, char **argv){
     plbInit(&argc, &argv);
     std::string fNameOut = "tmp";
 
+    // Storage of the populations, optional first argument: cells (default),
+    //   soa or soaFloat. The probe history of another storage than cells is
+    //   written to tmp/history_probes_<storage>.dat; compareStorage.m
+    //   compares it with the one of cells.
+    std::string storageName = argc > 1 ? argv[1] : "cells";
+    storage::LayoutT populationStorage = storage::cells;
+    std::string historySuffix;
+    if (storageName == "soa") {
+        populationStorage = storage::soa;
+        historySuffix = "_soa";
+    }
+    else if (storageName == "soaFloat") {
+        populationStorage = storage::soaFloat;
+        historySuffix = "_soaFloat";
+    }
+    else if (storageName != "cells") {
+        pcout << "Unknown storage " << storageName << std::endl;
+        return 1;
+    }
+
     const T radius = 30;
     const T diameter = 2*radius;
 
@@ -130,10 +150,25 @@ int main(int argc, char **argv){
             boundary, flowType, full_domain, borderWidth, extendedEnvelopeWidth, blockSize);
     pcout << getMultiBlockInfo(voxelizedDomain.getVoxelMatrix()) << std::endl;
 
+    // Cut the domain into blocks and distribute them by the cost of their
+    //   cells: the anechoic buffer and the cells along the duct walls cost
+    //   more than the bulk fluid. Blocks without fluid or boundary cells
+    //   would be dropped, but the walls are thinner than the blocks.
+    const T size_anechoic_buffer = 30;
+    CellCostModel3D costModel;
+    costModel.bufferDomain = full_domain;
+    costModel.bufferWidth = (plint) size_anechoic_buffer;
+    const plint loadBalancingBlockSize = (plint) (2*diameter);
+    voxelizedDomain.balanceLoad(costModel, loadBalancingBlockSize);
+    pcout << "After load balancing:" << std::endl;
+    pcout << getMultiBlockInfo(voxelizedDomain.getVoxelMatrix()) << std::endl;
+
     // Build lattice and set default dynamics
     //-------------------------------------
     MultiBlockLattice3D<T,DESCRIPTOR> *lattice = 
     new MultiBlockLattice3D<T,DESCRIPTOR>(voxelizedDomain.getVoxelMatrix());
+    // Before the boundary condition and the source add their processors.
+    lattice->setPopulationStorage(populationStorage);
 
     // Setting anechoic dynamics like this way
     defineDynamics(*lattice, lattice->getBoundingBox(),
@@ -179,7 +214,6 @@ int main(int argc, char **argv){
     const T mach_number = 0.2;
     const T velocity_flow = mach_number*lattice_speed_sound;
     Array<T,3> j_target(0, 0, 0);
-    T size_anechoic_buffer = 30;
     defineAnechoicMRTBoards(nx, ny, nz, *lattice, size_anechoic_buffer,
       omega, j_target, j_target, j_target, j_target, j_target, j_target,
       rhoBar_target);
@@ -208,44 +242,34 @@ int main(int argc, char **argv){
             ny/2 + radius/sqrt(2), 
             nz/2 - radius/sqrt(2), 
             nz/2 + radius/sqrt(2));
-    plb_ofstream history_pressures_3r("tmp/history_pressures_3r.dat");
-    plb_ofstream history_pressures_4r("tmp/history_pressures_4r.dat");
-    plb_ofstream history_pressures_6r("tmp/history_pressures_6r.dat");
-    plb_ofstream history_velocities_3r("tmp/history_velocities_3r.dat");
-    plb_ofstream history_velocities_4r("tmp/history_velocities_4r.dat");
-    plb_ofstream history_velocities_6r("tmp/history_velocities_boca.dat");
+    // Pressure and velocity of all probes, sampled by one reduction and
+    //   written by chunks to tmp/history_probes.dat (see readProbeHistory.m).
+    ProbeSet3D<T,DESCRIPTOR> probes;
+    probes.addProbe(surface_probe_3r, "3r");
+    probes.addProbe(surface_probe_4r, "4r");
+    probes.addProbe(surface_probe_6r, "boca");
+    std::vector<std::string> probe_names;
+    std::vector<Box3D> probe_locations;
+    for (plint iProbe=0; iProbe<probes.getNumProbes(); ++iProbe) {
+        probe_names.push_back(probes.getName(iProbe));
+        probe_locations.push_back(probes.getLocation(iProbe));
+    }
+    ProbeHistoryWriter3D<T> history(fNameOut+"/history_probes"+historySuffix+".dat",
+                                    probe_names, probe_locations, (T) 1);
+    // Source: linear chirp tabulated once and imposed by an internal processor.
+    T initial_frequency = ka_min*lattice_speed_sound/(2*M_PI*radius);
+    T frequency_max_lattice = ka_max*lattice_speed_sound/(2*M_PI*radius);
+    AcousticSignalTable<T> chirp = AcousticSignalTable<T>::linearChirp(
+        initial_frequency, frequency_max_lattice, drho, maxT_final_source);
+    plint source_radius = radius;
+    Box3D test_source(centerLB[0] + 10, centerLB[0] + 15, 
+        ny/2 - source_radius/sqrt(2), 
+        ny/2 + source_radius/sqrt(2), 
+        nz/2 - source_radius/sqrt(2), 
+        nz/2 + source_radius/sqrt(2));
+    setAcousticSource(*lattice, test_source, chirp, rho0, u0, Array<T,3>(0, 0, 0));
+
     for (plint iT=0; iT<maxT; ++iT){
-        
-          if (iT <= maxT_final_source){
-            //drho*sin(2*M_PI*(lattice_speed_sound/20)*iT);
-            //drho*cos((lattice_speed_sound/radius)*(ka_max*((maxT-iT)/maxT)));
-            
-            T initial_frequency = ka_min*lattice_speed_sound/(2*M_PI*radius);
-            T frequency_max_lattice = ka_max*lattice_speed_sound/(2*M_PI*radius);
-            T variation_frequency = (frequency_max_lattice - initial_frequency)/maxT_final_source;
-            T frequency_function = initial_frequency*iT + (variation_frequency*iT*iT)/2;
-            T phase = 2*M_PI*frequency_function;
-            T chirp_hand = 1. + drho*sin(phase);
-
-            T rho_changing = 1. + drho*sin(2*M_PI*(lattice_speed_sound/20)*iT);
-            //Box3D impulse(nx/2 + 50, nx/2 + 50, ny/2 + 50, ny/2 + 50, nz/2 + 50, nz/2 + 50);
-            plint source_radius = radius;
-             Box3D test_source(centerLB[0] + 10, centerLB[0] + 15, 
-                ny/2 - source_radius/sqrt(2), 
-                ny/2 + source_radius/sqrt(2), 
-                nz/2 - source_radius/sqrt(2), 
-                nz/2 + source_radius/sqrt(2));
-            //Box3D impulse(centerLB[0] + 10, centerLB[0] + 10, ny/2, ny/2, nz/2, nz/2);
-            initializeAtEquilibrium( *lattice, test_source, chirp_hand, u0);
-        }else{
-            plint source_radius = radius;
-             Box3D test_source(centerLB[0] + 10, centerLB[0] + 15, 
-                ny/2 - source_radius/sqrt(2), 
-                ny/2 + source_radius/sqrt(2), 
-                nz/2 - source_radius/sqrt(2), 
-                nz/2 + source_radius/sqrt(2));
-            initializeAtEquilibrium( *lattice, test_source, rho0, u0);
-        }
 
         if (iT % 100 == 0 && iT>0) {
             pcout << "Iteration " << iT << endl;
@@ -254,18 +278,8 @@ int main(int argc, char **argv){
         }
 
         // extract values of pressure and velocities
-        history_pressures_3r << setprecision(10) << (computeAverageDensity(*lattice, surface_probe_3r) - rho0)*cs2 << endl;
-        history_pressures_4r << setprecision(10) << (computeAverageDensity(*lattice, surface_probe_4r) - rho0)*cs2 << endl;
-        history_pressures_6r << setprecision(10) << (computeAverageDensity(*lattice, surface_probe_6r) - rho0)*cs2 << endl;
-
-        history_velocities_3r << setprecision(10) << 
-        boundaryCondition.computeAverageVelocityComponent(surface_probe_3r, 0)/lattice_speed_sound << endl;
-
-        history_velocities_4r << setprecision(10) << 
-        boundaryCondition.computeAverageVelocityComponent(surface_probe_4r, 1)/lattice_speed_sound << endl;
-
-        history_velocities_6r << setprecision(10) << 
-        boundaryCondition.computeAverageVelocityComponent(surface_probe_6r, 2)/lattice_speed_sound << endl;
+        probes.sample(*lattice);
+        history.append(probes, rho0, cs2);
 
         lattice->collideAndStream();
 
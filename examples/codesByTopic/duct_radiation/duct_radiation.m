@@ -1,12 +1,12 @@
 % duct radiation
 
 % chirp
-pressures = textread('tmp/history_pressures_3r.dat');
-pressures = [pressures(:)];
-particle_velocity = textread('tmp/history_velocities_3r.dat');
-particle_velocity = [particle_velocity(:)];
+history = readProbeHistory('tmp/history_probes.dat');
+probe = find(strcmp(history.probes, '3r'));
 a = 6;
 cs = 1/sqrt(3);
+pressures = history.data(:, probe, find(strcmp(history.fields, 'pressure')));
+particle_velocity = history.data(:, probe, find(strcmp(history.fields, 'velocity_x')))/cs;
 L = a*3; 
 
 particle_velocity = particle_velocity(1:length(pressures));
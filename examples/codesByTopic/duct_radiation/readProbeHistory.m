@@ -0,0 +1,51 @@
+function history = readProbeHistory(fileName)
+% Reads a probe history written by ProbeHistoryWriter3D.
+%   history.data(iSample, iProbe, iField) holds the samples, and
+%   history.probes / history.fields the names of the probes and fields.
+
+fid = fopen(fileName, 'r');
+if fid < 0
+    error('Could not open %s', fileName);
+end
+if ~strcmp(fread(fid, 8, '*char')', 'PLBPROBE')
+    fclose(fid);
+    error('%s is not a probe history', fileName);
+end
+fread(fid, 1, 'uint32');                     % version
+sizeOfT = fread(fid, 1, 'uint32');
+numProbes = fread(fid, 1, 'uint32');
+numFields = fread(fid, 1, 'uint32');
+history.dt = fread(fid, 1, 'double');
+history.units = readString(fid);
+history.fields = cell(1, numFields);
+for iField = 1:numFields
+    history.fields{iField} = readString(fid);
+end
+history.probes = cell(1, numProbes);
+history.boxes = zeros(numProbes, 6);
+for iProbe = 1:numProbes
+    history.probes{iProbe} = readString(fid);
+    history.boxes(iProbe, :) = fread(fid, 6, 'int64')';
+end
+if sizeOfT == 4
+    precision = 'single';
+else
+    precision = 'double';
+end
+
+history.data = zeros(0, numProbes, numFields);
+numSamples = fread(fid, 1, 'uint32');
+while ~isempty(numSamples)
+    % Inside a chunk, the samples are stored field by field, then probe by probe.
+    chunk = fread(fid, numSamples*numProbes*numFields, precision);
+    chunk = reshape(chunk, numSamples, numProbes, numFields);
+    history.data = [history.data; chunk];
+    numSamples = fread(fid, 1, 'uint32');
+end
+fclose(fid);
+end
+
+function value = readString(fid)
+n = fread(fid, 1, 'uint32');
+value = fread(fid, n, '*char')';
+end
@@ -0,0 +1,605 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Comparison of the variants of MultiBlockLattice3D against the reference
+ * implementation: the same flow is run on a reference lattice and on a lattice
+ * with the variant, and the largest difference of the populations is checked
+ * against a tolerance. The lattices are split into several blocks, so that
+ * the communication between blocks is exercised also on a single process.
+ *
+ * Usage: latticeVariants [variant], where variant is one of
+ *   soa       Structure-of-arrays storage of the populations.
+ *   soaFloat  Same, with the populations stored in single precision.
+ *   aa        AA streaming pattern.
+ *   blocked   Temporal blocking with blockedCollideAndStream().
+ *   overlap   Envelope communication overlapped with the collision.
+ *   oriented  Communication of the streamed populations only.
+ *   shared    Envelope exchange through shared memory between the processes
+ *             of a node; only effective on more than one process.
+ * Without argument, all variants are checked. The program returns a non-zero
+ * value if one of the checks fails.
+ */
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cmath>
+
+using namespace plb;
+using namespace plb::descriptors;
+using namespace std;
+
+typedef double T;
+// The acoustics resources are written for the descriptor and dynamics of the example.
+#define DESCRIPTOR MRTD3Q19Descriptor
+typedef MRTdynamics<T,DESCRIPTOR> BackgroundDynamics;
+typedef AnechoicMRTdynamics<T,DESCRIPTOR> AnechoicBackgroundDynamics;
+
+// ---------------------------------------------
+// Includes of acoustics resources
+#include "acoustics/acoustics3D.h"
+using namespace plb_acoustics_3D;
+// ---------------------------------------------
+
+/// Largest difference between the populations of two lattices.
+/** The cells are read through constant references, as SoABlockLattice3D
+ *  then only refreshes them from its arrays.
+ */
+template<typename T1, template<typename U> class Descriptor>
+class MaxPopulationDifference3D :
+    public ReductiveBoxProcessingFunctional3D_LL<T1,Descriptor,T1,Descriptor>
+{
+public:
+    MaxPopulationDifference3D()
+        : maxDiffId(this->getStatistics().subscribeMax())
+    { }
+    virtual void process(Box3D domain, BlockLattice3D<T1,Descriptor>& lattice1,
+                                       BlockLattice3D<T1,Descriptor>& lattice2)
+    {
+        BlockLattice3D<T1,Descriptor> const& constLattice1 = lattice1;
+        BlockLattice3D<T1,Descriptor> const& constLattice2 = lattice2;
+        Dot3D offset = computeRelativeDisplacement(lattice1, lattice2);
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    Cell<T1,Descriptor> const& cell1 = constLattice1.get(iX,iY,iZ);
+                    Cell<T1,Descriptor> const& cell2 =
+                        constLattice2.get(iX+offset.x,iY+offset.y,iZ+offset.z);
+                    for (plint iPop=0; iPop<Descriptor<T1>::q; ++iPop) {
+                        this->getStatistics().gatherMax (
+                                maxDiffId, (double)std::fabs(cell1[iPop]-cell2[iPop]) );
+                    }
+                }
+            }
+        }
+    }
+    virtual MaxPopulationDifference3D<T1,Descriptor>* clone() const {
+        return new MaxPopulationDifference3D<T1,Descriptor>(*this);
+    }
+    virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const {
+        modified[0] = modif::nothing;
+        modified[1] = modif::nothing;
+    }
+    T1 getMaxDifference() const {
+        return (T1) this->getStatistics().getMax(maxDiffId);
+    }
+private:
+    plint maxDiffId;
+};
+
+template<template<typename U> class Descriptor>
+T maxPopulationDifference(MultiBlockLattice3D<T,Descriptor>& lattice1,
+                          MultiBlockLattice3D<T,Descriptor>& lattice2)
+{
+    MaxPopulationDifference3D<T,Descriptor> functional;
+    applyProcessingFunctional(functional, lattice1.getBoundingBox(), lattice1, lattice2);
+    return functional.getMaxDifference();
+}
+
+/// Lattice split into 2x2x2 blocks, distributed cyclically over the
+///   processes, or all on the main process if gathered is true, with the
+///   given envelope width.
+template<template<typename U> class Descriptor>
+MultiBlockLattice3D<T,Descriptor>* createSplitLattice (
+        plint nx, plint ny, plint nz, plint envelopeWidth, Dynamics<T,Descriptor>* dynamics,
+        bool gathered=false )
+{
+    ExplicitThreadAttribution* attribution = new ExplicitThreadAttribution;
+    for (plint iBlock=0; iBlock<8; ++iBlock) {
+        attribution->addBlock(iBlock, gathered ? global::mpi().bossId()
+                                               : iBlock % global::mpi().getSize());
+    }
+    return new MultiBlockLattice3D<T,Descriptor> (
+            MultiBlockManagement3D( createRegularDistribution3D(nx,ny,nz, 2,2,2),
+                                    attribution, envelopeWidth ),
+            defaultMultiBlockPolicy3D().getBlockCommunicator(),
+            defaultMultiBlockPolicy3D().getCombinedStatistics(),
+            defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>(),
+            dynamics );
+}
+
+/// Acoustic pulse around an obstacle, periodic in every direction.
+template<template<typename U> class Descriptor>
+void setupPulse(MultiBlockLattice3D<T,Descriptor>& lattice)
+{
+    plint nx = lattice.getNx(), ny = lattice.getNy(), nz = lattice.getNz();
+    lattice.periodicity().toggleAll(true);
+    defineDynamics(lattice, Box3D(nx/2,nx/2+3, ny/2,ny/2+3, 0,nz/3),
+                   new BounceBack<T,Descriptor>(1.));
+    initializeAtEquilibrium(lattice, lattice.getBoundingBox(), 1., Array<T,3>(0.02,0.01,-0.01));
+    initializeAtEquilibrium(lattice, Box3D(2,nx/3, 2,ny/3, nz/2,nz-3), 1.02, Array<T,3>(0.,0.,0.03));
+    lattice.initialize();
+}
+
+/// Channel with walls in y, a velocity inlet and a pressure outlet in x,
+///   periodic in z. The boundary conditions add data processors, and two
+///   relaxation parameters are used in the bulk.
+template<template<typename U> class Descriptor>
+void setupChannel(MultiBlockLattice3D<T,Descriptor>& lattice,
+                  OnLatticeBoundaryCondition3D<T,Descriptor>* boundaryCondition)
+{
+    plint nx = lattice.getNx(), ny = lattice.getNy(), nz = lattice.getNz();
+    lattice.periodicity().toggle(2, true);
+    defineDynamics(lattice, Box3D(0,nx-1, 0,ny-1, 0,nz/2), new BGKdynamics<T,Descriptor>(1.1));
+    defineDynamics(lattice, Box3D(0,nx-1, 0,0, 0,nz-1), new BounceBack<T,Descriptor>(1.));
+    defineDynamics(lattice, Box3D(0,nx-1, ny-1,ny-1, 0,nz-1), new BounceBack<T,Descriptor>(1.));
+    defineDynamics(lattice, Box3D(nx/3,nx/3+2, ny/3,ny/2, 0,nz-1), new BounceBack<T,Descriptor>(1.));
+    Box3D inlet(0,0, 1,ny-2, 0,nz-1);
+    Box3D outlet(nx-1,nx-1, 1,ny-2, 0,nz-1);
+    boundaryCondition->setVelocityConditionOnBlockBoundaries(lattice, inlet);
+    boundaryCondition->setPressureConditionOnBlockBoundaries(lattice, outlet);
+    setBoundaryVelocity(lattice, inlet, Array<T,3>(0.03,0.,0.));
+    setBoundaryDensity(lattice, outlet, 1.);
+    initializeAtEquilibrium(lattice, lattice.getBoundingBox(), 1., Array<T,3>(0.,0.,0.));
+    initializeAtEquilibrium(lattice, Box3D(nx/2,nx-3, 2,ny/2, 2,nz/3), 1.01, Array<T,3>(0.,0.,0.));
+    lattice.initialize();
+    delete boundaryCondition;
+}
+
+bool report(std::string const& name, std::string const& quantity, T difference, T tolerance)
+{
+    bool passed = difference <= tolerance;
+    pcout << setw(32) << left << name << setw(28) << left << quantity
+          << setprecision(3) << scientific << difference
+          << " (tolerance " << tolerance << ") " << (passed ? "PASS" : "FAIL") << endl;
+    return passed;
+}
+
+/* *************** Structure-of-arrays storage ******************************* */
+
+/// Runs the same flow on the two storages and compares the populations and
+///   the statistics. The optimized kernels of SoABlockLattice3D group the
+///   operations differently from the dynamics classes, which changes the
+///   rounding: the tolerance is a few hundred ulps of the populations.
+template<template<typename U> class Descriptor>
+bool compareSoA(std::string const& name, MultiBlockLattice3D<T,Descriptor>& reference,
+                MultiBlockLattice3D<T,Descriptor>& soa, plint numIter)
+{
+    for (plint iT=0; iT<numIter; ++iT) {
+        reference.collideAndStream();
+        soa.collideAndStream();
+    }
+    T tolerance = 1.e-13;
+    bool passed = report(name, "max |f-f_ref|", maxPopulationDifference(reference, soa), tolerance);
+    T densityDifference = std::fabs(getStoredAverageDensity(reference)-getStoredAverageDensity(soa));
+    passed = report(name, "|<rho>-<rho>_ref|", densityDifference, tolerance) && passed;
+    T energyDifference = std::fabs(getStoredAverageEnergy(reference)-getStoredAverageEnergy(soa));
+    passed = report(name, "|<u^2>-<u^2>_ref|", energyDifference, tolerance) && passed;
+    return passed;
+}
+
+bool checkSoA()
+{
+    plint numIter = 60;
+    bool passed = true;
+    {
+        plint nx=36, ny=20, nz=16;
+        MultiBlockLattice3D<T,D3Q19Descriptor>* reference =
+            createSplitLattice<D3Q19Descriptor>(nx,ny,nz, 1, new BGKdynamics<T,D3Q19Descriptor>(1.6));
+        MultiBlockLattice3D<T,D3Q19Descriptor>* soa =
+            createSplitLattice<D3Q19Descriptor>(nx,ny,nz, 1, new BGKdynamics<T,D3Q19Descriptor>(1.6));
+        soa->setPopulationStorage(storage::soa);
+        setupChannel(*reference, createInterpBoundaryCondition3D<T,D3Q19Descriptor>());
+        setupChannel(*soa, createInterpBoundaryCondition3D<T,D3Q19Descriptor>());
+        passed = compareSoA("soa, D3Q19 BGK channel", *reference, *soa, numIter) && passed;
+        delete soa; delete reference;
+    }
+    {
+        plint nx=24, ny=20, nz=16;
+        MultiBlockLattice3D<T,MRTD3Q19Descriptor>* reference =
+            createSplitLattice<MRTD3Q19Descriptor>(nx,ny,nz, 1, new MRTdynamics<T,MRTD3Q19Descriptor>(1.7));
+        MultiBlockLattice3D<T,MRTD3Q19Descriptor>* soa =
+            createSplitLattice<MRTD3Q19Descriptor>(nx,ny,nz, 1, new MRTdynamics<T,MRTD3Q19Descriptor>(1.7));
+        soa->setPopulationStorage(storage::soa);
+        setupPulse(*reference);
+        setupPulse(*soa);
+        passed = compareSoA("soa, D3Q19 MRT pulse", *reference, *soa, numIter) && passed;
+        delete soa; delete reference;
+    }
+    {
+        plint nx=20, ny=16, nz=16;
+        MultiBlockLattice3D<T,D3Q27Descriptor>* reference =
+            createSplitLattice<D3Q27Descriptor>(nx,ny,nz, 1, new CumulantDynamics<T,D3Q27Descriptor>(1.9));
+        MultiBlockLattice3D<T,D3Q27Descriptor>* soa =
+            createSplitLattice<D3Q27Descriptor>(nx,ny,nz, 1, new CumulantDynamics<T,D3Q27Descriptor>(1.9));
+        soa->setPopulationStorage(storage::soa);
+        setupPulse(*reference);
+        setupPulse(*soa);
+        passed = compareSoA("soa, D3Q27 cumulant pulse", *reference, *soa, numIter) && passed;
+        delete soa; delete reference;
+    }
+    return passed;
+}
+
+/* *************** Single-precision storage ********************************* */
+
+/// A small version of examples/codesByTopic/duct_radiation: MRT dynamics with
+///   anechoic boards, a square duct with bounce-back walls, and a chirp
+///   imposed by an acoustic source inside the duct. The pressure is
+///   recorded at the mouth of the duct and outside of it.
+void setupDuct(MultiBlockLattice3D<T,MRTD3Q19Descriptor>& lattice, T omega,
+               AcousticSignalTable<T> const& chirp, ProbeSet3D<T,MRTD3Q19Descriptor>& probes)
+{
+    plint nx = lattice.getNx(), ny = lattice.getNy(), nz = lattice.getNz();
+    plint mouth = 2*nx/3;
+    Box3D duct(0,mouth, ny/2-6,ny/2+6, nz/2-6,nz/2+6);
+    defineDynamics(lattice, duct, new BounceBack<T,MRTD3Q19Descriptor>(1.));
+    defineDynamics(lattice, duct.enlarge(-1), new MRTdynamics<T,MRTD3Q19Descriptor>(omega));
+    initializeAtEquilibrium(lattice, lattice.getBoundingBox(), 1., Array<T,3>(0.,0.,0.));
+    Array<T,3> j_target(0.,0.,0.);
+    defineAnechoicMRTBoards(nx, ny, nz, lattice, (T)8, omega,
+                            j_target, j_target, j_target, j_target, j_target, j_target, (T)0);
+    lattice.initialize();
+    setAcousticSource(lattice, Box3D(10,11, ny/2-4,ny/2+4, nz/2-4,nz/2+4),
+                      chirp, (T)1, Array<T,3>(0.,0.,0.), Array<T,3>(0.,0.,0.));
+    probes.addProbe(Box3D(mouth-3,mouth-3, ny/2-3,ny/2+3, nz/2-3,nz/2+3), "mouth");
+    probes.addProbe(Box3D(mouth+10,mouth+10, ny/2-3,ny/2+3, nz/2-3,nz/2+3), "outside");
+}
+
+/// The populations are stored shifted by their rest value t_i, which keeps
+///   the relative precision of single precision for the acoustic field. The
+///   error is measured on the pressure at the probes, relative to the
+///   largest acoustic pressure: with an amplitude of 1/10 of the density,
+///   as in duct_radiation, and omega close to 2, it is about 2e-8 after 400
+///   cycles. The tolerance is 1e-6.
+bool checkSoAfloat()
+{
+    plint nx=72, ny=40, nz=40;
+    plint numIter = 400;
+    T omega = 1.985;
+    T cs2 = MRTD3Q19Descriptor<T>::cs2;
+    AcousticSignalTable<T> chirp = AcousticSignalTable<T>::linearChirp(0.005, 0.05, 0.1, numIter);
+
+    MultiBlockLattice3D<T,MRTD3Q19Descriptor>* reference = createSplitLattice<MRTD3Q19Descriptor> (
+            nx,ny,nz, 1, new MRTdynamics<T,MRTD3Q19Descriptor>(omega));
+    MultiBlockLattice3D<T,MRTD3Q19Descriptor>* soaFloat = createSplitLattice<MRTD3Q19Descriptor> (
+            nx,ny,nz, 1, new MRTdynamics<T,MRTD3Q19Descriptor>(omega));
+    soaFloat->setPopulationStorage(storage::soaFloat);
+    ProbeSet3D<T,MRTD3Q19Descriptor> referenceProbes, soaFloatProbes;
+    setupDuct(*reference, omega, chirp, referenceProbes);
+    setupDuct(*soaFloat, omega, chirp, soaFloatProbes);
+
+    T maxPressure = T(), maxPressureDifference = T();
+    for (plint iT=0; iT<numIter; ++iT) {
+        reference->collideAndStream();
+        soaFloat->collideAndStream();
+        referenceProbes.sample(*reference);
+        soaFloatProbes.sample(*soaFloat);
+        for (plint iProbe=0; iProbe<referenceProbes.getNumProbes(); ++iProbe) {
+            T pressure = referenceProbes.getPressure(iProbe, (T)1, cs2);
+            maxPressure = std::max(maxPressure, (T)std::fabs(pressure));
+            maxPressureDifference = std::max( maxPressureDifference,
+                    (T)std::fabs(soaFloatProbes.getPressure(iProbe, (T)1, cs2)-pressure) );
+        }
+    }
+    T tolerance = 1.e-6;
+    bool passed = report("soaFloat, D3Q19 MRT duct", "max |p-p_ref|/max |p_ref|",
+                         maxPressureDifference/maxPressure, tolerance);
+    delete soaFloat; delete reference;
+    return passed;
+}
+
+/* *************** AA streaming pattern ************************************* */
+
+/// The AA pattern performs the same operations as the swap pattern, in
+///   another order: after an even number of cycles, the populations are
+///   identical. In between, they are in reverted order.
+template<template<typename U> class Descriptor>
+bool compareAA(std::string const& name, Dynamics<T,Descriptor>* dynamics, plint numIter)
+{
+    plint nx=30, ny=24, nz=20;
+    MultiBlockLattice3D<T,Descriptor>* reference =
+        createSplitLattice<Descriptor>(nx,ny,nz, 1, dynamics->clone());
+    // The odd cycles of the envelope need two layers of neighbors.
+    MultiBlockLattice3D<T,Descriptor>* aa =
+        createSplitLattice<Descriptor>(nx,ny,nz, 2*Descriptor<T>::vicinity, dynamics);
+    setupPulse(*reference);
+    setupPulse(*aa);
+    // Walls in x, where the blocks bounce the populations back.
+    reference->periodicity().toggle(0, false);
+    aa->periodicity().toggle(0, false);
+    aa->setStreamingPattern(streaming::aa);
+
+    plint layoutErrors = 0;
+    for (plint iT=0; iT<numIter; ++iT) {
+        reference->collideAndStream();
+        aa->collideAndStream();
+        if (aa->hasNaturalLayout() != (iT%2==1)) {
+            ++layoutErrors;
+        }
+    }
+    bool passed = report(name, "wrong layout flags", (T)layoutErrors, 0.);
+    passed = report(name, "max |f-f_ref|", maxPopulationDifference(*reference, *aa), 0.) && passed;
+    delete aa; delete reference;
+    return passed;
+}
+
+bool checkAA()
+{
+    plint numIter = 40;
+    bool passed = true;
+    passed = compareAA<D3Q19Descriptor>("aa, D3Q19 BGK pulse",
+                                        new BGKdynamics<T,D3Q19Descriptor>(1.7), numIter) && passed;
+    passed = compareAA<MRTD3Q19Descriptor>("aa, D3Q19 MRT pulse",
+                                           new MRTdynamics<T,MRTD3Q19Descriptor>(1.9), numIter) && passed;
+    return passed;
+}
+
+/* *************** Temporal blocking ****************************************** */
+
+/// blockedCollideAndStream() executes the same cycles as collideAndStream(),
+///   block by block, on an envelope which is depth*vicinity wide: the
+///   populations are identical. The number of steps is not a multiple of the
+///   depth, to include a shorter group of cycles.
+template<template<typename U> class Descriptor>
+bool compareBlocked( std::string const& name, Dynamics<T,Descriptor>* dynamics,
+                     plint depth, storage::LayoutT layout, plint numIter )
+{
+    plint nx=30, ny=24, nz=20;
+    MultiBlockLattice3D<T,Descriptor>* reference =
+        createSplitLattice<Descriptor>(nx,ny,nz, 1, dynamics->clone());
+    MultiBlockLattice3D<T,Descriptor>* blocked =
+        createSplitLattice<Descriptor>(nx,ny,nz, depth*Descriptor<T>::vicinity, dynamics);
+    reference->setPopulationStorage(layout);
+    blocked->setPopulationStorage(layout);
+    setupPulse(*reference);
+    setupPulse(*blocked);
+    reference->periodicity().toggle(0, false);
+    blocked->periodicity().toggle(0, false);
+
+    for (plint iT=0; iT<numIter; ++iT) {
+        reference->collideAndStream();
+    }
+    blocked->blockedCollideAndStream(numIter);
+    bool passed = report(name, "depth - requested depth",
+                         (T)std::abs(blocked->getTemporalBlockingDepth()-depth), 0.);
+    passed = report(name, "max |f-f_ref|", maxPopulationDifference(*reference, *blocked), 0.) && passed;
+    delete blocked; delete reference;
+    return passed;
+}
+
+bool checkBlocked()
+{
+    plint numIter = 40;
+    bool passed = true;
+    passed = compareBlocked<D3Q19Descriptor>("blocked, D3Q19 BGK depth 3",
+            new BGKdynamics<T,D3Q19Descriptor>(1.7), 3, storage::cells, numIter) && passed;
+    passed = compareBlocked<MRTD3Q19Descriptor>("blocked, D3Q19 MRT depth 4",
+            new MRTdynamics<T,MRTD3Q19Descriptor>(1.9), 4, storage::cells, numIter) && passed;
+    passed = compareBlocked<D3Q19Descriptor>("blocked, D3Q19 BGK soa depth 3",
+            new BGKdynamics<T,D3Q19Descriptor>(1.7), 3, storage::soa, numIter) && passed;
+    return passed;
+}
+
+/* *************** Communication overlap ************************************ */
+
+/// With the overlap, the cells next to the envelope are processed before
+///   the communication and the interior while it is under way. Every cell
+///   still goes through the same cycle: the populations are identical.
+template<template<typename U> class Descriptor>
+bool compareOverlap(std::string const& name, Dynamics<T,Descriptor>* dynamics, plint numIter)
+{
+    plint nx=30, ny=24, nz=20;
+    MultiBlockLattice3D<T,Descriptor>* reference =
+        createSplitLattice<Descriptor>(nx,ny,nz, 1, dynamics->clone());
+    MultiBlockLattice3D<T,Descriptor>* overlapped =
+        createSplitLattice<Descriptor>(nx,ny,nz, 1, dynamics);
+    setupPulse(*reference);
+    setupPulse(*overlapped);
+    reference->periodicity().toggle(0, false);
+    overlapped->periodicity().toggle(0, false);
+    overlapped->toggleCommunicationOverlap(true);
+
+    for (plint iT=0; iT<numIter; ++iT) {
+        reference->collideAndStream();
+        overlapped->collideAndStream();
+    }
+    bool passed = report(name, "max |f-f_ref|", maxPopulationDifference(*reference, *overlapped), 0.);
+    delete overlapped; delete reference;
+    return passed;
+}
+
+bool checkOverlap()
+{
+    plint numIter = 40;
+    bool passed = true;
+    passed = compareOverlap<D3Q19Descriptor>("overlap, D3Q19 BGK pulse",
+                                             new BGKdynamics<T,D3Q19Descriptor>(1.7), numIter) && passed;
+    passed = compareOverlap<MRTD3Q19Descriptor>("overlap, D3Q19 MRT pulse",
+                                                new MRTdynamics<T,MRTD3Q19Descriptor>(1.9), numIter) && passed;
+    passed = compareOverlap<D3Q27Descriptor>("overlap, D3Q27 cumulant pulse",
+                                             new CumulantDynamics<T,D3Q27Descriptor>(1.9), numIter) && passed;
+    return passed;
+}
+
+/* *************** Oriented communication *********************************** */
+
+/// The oriented communication only sends the populations which stream into
+///   the bulk, and the bulk is identical. The other populations of the
+///   envelopes are stale: after the option is turned off, which restores the
+///   envelopes, a further cycle must still give identical populations.
+template<template<typename U> class Descriptor>
+bool compareOriented(std::string const& name, Dynamics<T,Descriptor>* dynamics, plint numIter)
+{
+    plint nx=30, ny=24, nz=20;
+    MultiBlockLattice3D<T,Descriptor>* reference =
+        createSplitLattice<Descriptor>(nx,ny,nz, 1, dynamics->clone());
+    MultiBlockLattice3D<T,Descriptor>* oriented =
+        createSplitLattice<Descriptor>(nx,ny,nz, 1, dynamics);
+    setupPulse(*reference);
+    setupPulse(*oriented);
+    reference->periodicity().toggle(0, false);
+    oriented->periodicity().toggle(0, false);
+    oriented->toggleOrientedCommunication(true);
+    bool passed = report(name, "option inactive", oriented->hasOrientedCommunication() ? 0. : 1., 0.);
+
+    for (plint iT=0; iT<numIter; ++iT) {
+        reference->collideAndStream();
+        oriented->collideAndStream();
+    }
+    passed = report(name, "max |f-f_ref|", maxPopulationDifference(*reference, *oriented), 0.) && passed;
+    oriented->toggleOrientedCommunication(false);
+    reference->collideAndStream();
+    oriented->collideAndStream();
+    passed = report(name, "max |f-f_ref|, turned off", maxPopulationDifference(*reference, *oriented), 0.) && passed;
+    delete oriented; delete reference;
+    return passed;
+}
+
+bool checkOriented()
+{
+    plint numIter = 40;
+    bool passed = true;
+    passed = compareOriented<D3Q19Descriptor>("oriented, D3Q19 BGK pulse",
+                                              new BGKdynamics<T,D3Q19Descriptor>(1.7), numIter) && passed;
+    passed = compareOriented<MRTD3Q19Descriptor>("oriented, D3Q19 MRT pulse",
+                                                 new MRTdynamics<T,MRTD3Q19Descriptor>(1.9), numIter) && passed;
+    passed = compareOriented<D3Q27Descriptor>("oriented, D3Q27 cumulant pulse",
+                                              new CumulantDynamics<T,D3Q27Descriptor>(1.9), numIter) && passed;
+    return passed;
+}
+
+/* *************** Shared-memory exchange *********************************** */
+
+/// The reference has all its blocks on the main process, where the envelopes
+///   are updated by local copies. The other lattice has its blocks distributed
+///   over the processes: the processes of the same node exchange them through
+///   a shared window (see CommunicationPlan3D), the others through MPI. The
+///   data is only copied, and the populations are identical.
+template<template<typename U> class Descriptor>
+bool compareDistributions( std::string const& name, MultiBlockLattice3D<T,Descriptor>& reference,
+                           MultiBlockLattice3D<T,Descriptor>& distributed, plint numIter )
+{
+    for (plint iT=0; iT<numIter; ++iT) {
+        reference.collideAndStream();
+        distributed.collideAndStream();
+    }
+    // The populations are gathered on the distribution of the reference.
+    MultiBlockLattice3D<T,Descriptor>* gathered = createSplitLattice<Descriptor> (
+            reference.getNx(), reference.getNy(), reference.getNz(), 1,
+            new NoDynamics<T,Descriptor>, true );
+    copyPopulations(distributed, distributed.getBoundingBox(), *gathered, gathered->getBoundingBox());
+    bool passed = report(name, "max |f-f_ref|", maxPopulationDifference(reference, *gathered), 0.);
+    T densityDifference = std::fabs(getStoredAverageDensity(reference)-getStoredAverageDensity(distributed));
+    passed = report(name, "|<rho>-<rho>_ref|", densityDifference, 1.e-14) && passed;
+    delete gathered;
+    return passed;
+}
+
+bool checkSharedWindow()
+{
+    plint numIter = 60;
+    bool passed = true;
+    pcout << global::mpi().getNodeSize() << " of " << global::mpi().getSize()
+          << " processes share the memory of the main process." << endl;
+    {
+        plint nx=36, ny=20, nz=16;
+        MultiBlockLattice3D<T,D3Q19Descriptor>* reference = createSplitLattice<D3Q19Descriptor> (
+                nx,ny,nz, 1, new BGKdynamics<T,D3Q19Descriptor>(1.6), true);
+        MultiBlockLattice3D<T,D3Q19Descriptor>* distributed = createSplitLattice<D3Q19Descriptor> (
+                nx,ny,nz, 1, new BGKdynamics<T,D3Q19Descriptor>(1.6));
+        setupChannel(*reference, createInterpBoundaryCondition3D<T,D3Q19Descriptor>());
+        setupChannel(*distributed, createInterpBoundaryCondition3D<T,D3Q19Descriptor>());
+        passed = compareDistributions("shared, D3Q19 BGK channel", *reference, *distributed, numIter) && passed;
+        delete distributed; delete reference;
+    }
+    {
+        plint nx=24, ny=20, nz=16;
+        MultiBlockLattice3D<T,MRTD3Q19Descriptor>* reference = createSplitLattice<MRTD3Q19Descriptor> (
+                nx,ny,nz, 1, new MRTdynamics<T,MRTD3Q19Descriptor>(1.7), true);
+        MultiBlockLattice3D<T,MRTD3Q19Descriptor>* distributed = createSplitLattice<MRTD3Q19Descriptor> (
+                nx,ny,nz, 1, new MRTdynamics<T,MRTD3Q19Descriptor>(1.7));
+        setupPulse(*reference);
+        setupPulse(*distributed);
+        passed = compareDistributions("shared, D3Q19 MRT pulse", *reference, *distributed, numIter) && passed;
+        delete distributed; delete reference;
+    }
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    plbInit(&argc, &argv);
+    std::string variant = argc>1 ? argv[1] : "all";
+
+    bool passed = true;
+    bool known = false;
+    if (variant=="all" || variant=="soa") {
+        passed = checkSoA() && passed;
+        known = true;
+    }
+    if (variant=="all" || variant=="soaFloat") {
+        passed = checkSoAfloat() && passed;
+        known = true;
+    }
+    if (variant=="all" || variant=="aa") {
+        passed = checkAA() && passed;
+        known = true;
+    }
+    if (variant=="all" || variant=="blocked") {
+        passed = checkBlocked() && passed;
+        known = true;
+    }
+    if (variant=="all" || variant=="overlap") {
+        passed = checkOverlap() && passed;
+        known = true;
+    }
+    if (variant=="all" || variant=="oriented") {
+        passed = checkOriented() && passed;
+        known = true;
+    }
+    if (variant=="all" || variant=="shared") {
+        passed = checkSharedWindow() && passed;
+        known = true;
+    }
+    if (!known) {
+        pcout << "Unknown variant " << variant << endl;
+        return 1;
+    }
+    pcout << (passed ? "All checks passed." : "Some checks FAILED.") << endl;
+    return passed ? 0 : 1;
+}
@@ -63,6 +63,9 @@ const T velocity_flow = mach_number*lattice_speed_sound;
 const plint size_square = 2;
 const T tau = (0.5 + ((velocity_flow*size_square)/(reynolds_number*lattice_speed_sound*lattice_speed_sound)));
 const T omega = 1.98;
+// true: the cavity and the neck of the liner are resolved by bounce-back
+// walls; false: the liner is an impedance on the top of the wall.
+const bool resolved_liner = false;
 
 int main(int argc, char* argv[]) {
     plbInit(&argc, &argv);
@@ -97,17 +100,36 @@ int main(int argc, char* argv[]) {
     Box2D square_1(0, nx/2 - 100, 0, ny/2);
     defineDynamics(lattice, square_1, new BounceBack<T,DESCRIPTOR>((T)0));
 
-    Box2D square_2(nx/2 - 100, nx/2 + 100, 0, ny/10);
-    defineDynamics(lattice, square_2, new BounceBack<T,DESCRIPTOR>((T)0));
-
     Box2D square_3(nx/2 + 100, nx, 0, ny/2);
     defineDynamics(lattice, square_3, new BounceBack<T,DESCRIPTOR>((T)0));
 
-    Box2D square_4(nx/2 - 100, nx/2 - 10, ny/2 - 10, ny/2);
-    defineDynamics(lattice, square_4, new BounceBack<T,DESCRIPTOR>((T)0));
+    if (resolved_liner) {
+        Box2D square_2(nx/2 - 100, nx/2 + 100, 0, ny/10);
+        defineDynamics(lattice, square_2, new BounceBack<T,DESCRIPTOR>((T)0));
+
+        Box2D square_4(nx/2 - 100, nx/2 - 10, ny/2 - 10, ny/2);
+        defineDynamics(lattice, square_4, new BounceBack<T,DESCRIPTOR>((T)0));
 
-    Box2D square_5(nx/2 + 10, nx/2 + 100, ny/2 - 10, ny/2);
-    defineDynamics(lattice, square_5, new BounceBack<T,DESCRIPTOR>((T)0));
+        Box2D square_5(nx/2 + 10, nx/2 + 100, ny/2 - 10, ny/2);
+        defineDynamics(lattice, square_5, new BounceBack<T,DESCRIPTOR>((T)0));
+    }
+    else {
+        // Extended Helmholtz resonator of the same liner, with the open area
+        // ratio of the neck, its length plus one width of end corrections,
+        // and the round trip in the cavity.
+        Box2D liner(nx/2 - 100, nx/2 + 100, 0, ny/2);
+        defineDynamics(lattice, liner, new BounceBack<T,DESCRIPTOR>((T)0));
+        T porosity = (T)19/(T)201;
+        T neck_length = (T)11 + (T)19;
+        T cavity_depth = (T)(ny/2 - 10 - ny/10 - 1);
+        T resistance = 0.1;
+        T mass = neck_length/(porosity*lattice_speed_sound);
+        T beta = 1/porosity;
+        T round_trip = 2*cavity_depth/lattice_speed_sound;
+        T epsilon = 0.05;
+        defineImpedanceBounceBack(lattice, liner, 4, new ExtendedHelmholtzResonator<T>(
+          resistance, mass, beta, round_trip, epsilon));
+    }
 
     // Main loop over time iterations.
     for (plint iT = 0; iT <= maxIter; iT++){
@@ -0,0 +1,278 @@
+/* Acoustic source imposed by an internal data processor.
+ *
+ * The source signal is tabulated once, before the time loop (linear chirp,
+ * multi-tone, band-limited noise or user file), so that no trigonometric
+ * function is evaluated during the run. AcousticSource3D is integrated in
+ * the lattice and imposes, at the end of every iteration, the equilibrium
+ * of the density rho0 + s(t) and velocity u0 + s(t)*coupling on a box or on
+ * the flagged cells of a mask. The equilibrium populations are computed
+ * once per block and iteration and copied into the source cells.
+ */
+
+#ifndef ACOUSTIC_SOURCE_3D_H
+#define ACOUSTIC_SOURCE_3D_H
+
+#include "palabos3D.h"
+#ifndef PLB_PRECOMPILED // Unless precompiled version is used,
+#include "palabos3D.hh"   // include full template code
+#endif
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cmath>
+
+namespace plb_acoustics_3D{
+
+	using namespace plb;
+
+	/* Table of the density fluctuation s(t) of a source, one value per
+	iteration; s(t) = 0 after the end of the table.*/
+	template<typename T>
+	class AcousticSignalTable{
+	public:
+		AcousticSignalTable()
+		{ }
+
+		explicit AcousticSignalTable(std::vector<T> const& values_)
+			: values(values_)
+		{ }
+
+		/* Linear chirp from f_min to f_max (cycles per iteration) over
+		num_steps iterations.*/
+		static AcousticSignalTable<T> linearChirp(T f_min, T f_max, T amplitude, plint num_steps){
+			std::vector<T> values(num_steps);
+			T pi = std::acos((T)-1);
+			T variation = (f_max - f_min)/(T)num_steps;
+			for(plint iT = 0; iT < num_steps; ++iT){
+				T phase = (T)2*pi*(f_min*(T)iT + variation*(T)iT*(T)iT/(T)2);
+				values[iT] = amplitude*std::sin(phase);
+			}
+			return AcousticSignalTable<T>(values);
+		}
+
+		/* Sum of sines of same amplitude and zero phase at the given
+		frequencies (cycles per iteration).*/
+		static AcousticSignalTable<T> multiTone(std::vector<T> const& frequencies, T amplitude, plint num_steps){
+			std::vector<T> values(num_steps, T());
+			T pi = std::acos((T)-1);
+			for(pluint iF = 0; iF < frequencies.size(); ++iF){
+				// Recurrence on the phasor: one sin/cos per tone instead of per sample.
+				T angle = (T)2*pi*frequencies[iF];
+				T cos_step = std::cos(angle), sin_step = std::sin(angle);
+				T cos_value = (T)1, sin_value = T();
+				for(plint iT = 0; iT < num_steps; ++iT){
+					values[iT] += amplitude*sin_value;
+					T next_cos = cos_value*cos_step - sin_value*sin_step;
+					sin_value = sin_value*cos_step + cos_value*sin_step;
+					cos_value = next_cos;
+				}
+			}
+			return AcousticSignalTable<T>(values);
+		}
+
+		/* Band-limited noise: num_modes tones equally spaced in [f_min, f_max]
+		with pseudo-random phases, scaled to the requested RMS value. The
+		phases only depend on the seed, so every processor builds the same
+		table.*/
+		static AcousticSignalTable<T> bandLimitedNoise(T f_min, T f_max, plint num_modes,
+		  T rms, plint num_steps, unsigned long seed = 1){
+			PLB_ASSERT( num_modes > 0 );
+			std::vector<T> values(num_steps, T());
+			T pi = std::acos((T)-1);
+			unsigned long state = seed;
+			for(plint iMode = 0; iMode < num_modes; ++iMode){
+				T frequency = num_modes == 1 ? f_min
+				  : f_min + (f_max - f_min)*(T)iMode/(T)(num_modes - 1);
+				state = (1103515245UL*state + 12345UL) % 2147483648UL;
+				T phase = (T)2*pi*(T)state/(T)2147483648UL;
+				for(plint iT = 0; iT < num_steps; ++iT){
+					values[iT] += std::sin((T)2*pi*frequency*(T)iT + phase);
+				}
+			}
+			T sum = T();
+			for(plint iT = 0; iT < num_steps; ++iT){
+				sum += values[iT]*values[iT];
+			}
+			T scale = sum > T() ? rms/std::sqrt(sum/(T)num_steps) : T();
+			for(plint iT = 0; iT < num_steps; ++iT){
+				values[iT] *= scale;
+			}
+			return AcousticSignalTable<T>(values);
+		}
+
+		/* Reads one value per line. The file is read by the main processor
+		and broadcast to the others.*/
+		static AcousticSignalTable<T> fromFile(std::string file_name){
+			std::vector<T> values;
+			if(global::mpi().isMainProcessor()){
+				std::ifstream file(file_name.c_str());
+				T value;
+				while(file >> value){
+					values.push_back(value);
+				}
+			}
+			int num_values = (int) values.size();
+			global::mpi().bCast(&num_values, 1);
+			values.resize(num_values);
+			if(num_values > 0){
+				global::mpi().bCast(&values[0], num_values);
+			}
+			return AcousticSignalTable<T>(values);
+		}
+
+		T operator()(plint iT) const{
+			if(iT < 0 || iT >= (plint) values.size()) return T();
+			return values[iT];
+		}
+
+		plint getNumSteps() const{
+			return (plint) values.size();
+		}
+
+	private:
+		std::vector<T> values;
+	};
+
+	/* Equilibrium populations of the source at a given iteration, cached
+	per dynamics so that cells with the same dynamics share one evaluation.*/
+	template<typename T, template<typename U> class Descriptor>
+	class AcousticSourceState3D{
+	public:
+		AcousticSourceState3D(AcousticSignalTable<T> const* signal_, T rho0_,
+		  Array<T,3> const& u0_, Array<T,3> const& coupling_)
+			: signal(signal_), rho0(rho0_), u0(u0_), coupling(coupling_),
+			  dynamics_id(-1)
+		{ }
+
+		void prepare(plint iT){
+			T s = (*signal)(iT);
+			rho = rho0 + s;
+			Array<T,3> u = u0 + s*coupling;
+			j = rho*u;
+			jSqr = VectorTemplate<T,Descriptor>::normSqr(j);
+			rhoBar = Descriptor<T>::rhoBar(rho);
+			dynamics_id = -1;
+		}
+
+		void impose(Cell<T,Descriptor>& cell){
+			int id = cell.getDynamics().getId();
+			if(id != dynamics_id){
+				for(plint iPop = 0; iPop < Descriptor<T>::q; ++iPop){
+					fEq[iPop] = cell.computeEquilibrium(iPop, rhoBar, j, jSqr);
+				}
+				dynamics_id = id;
+			}
+			for(plint iPop = 0; iPop < Descriptor<T>::q; ++iPop){
+				cell[iPop] = fEq[iPop];
+			}
+		}
+
+	private:
+		AcousticSignalTable<T> const* signal;
+		T rho0;
+		Array<T,3> u0, coupling;
+		T rho, rhoBar, jSqr;
+		Array<T,3> j;
+		Array<T,Descriptor<T>::q> fEq;
+		int dynamics_id;
+	};
+
+	/* Internal processor imposing the source on all the cells of the domain.
+	The lattice time t is read when the processor is executed, at the end of
+	iteration t, and the value s(t+1) of the next iteration is imposed. The
+	signal table is not copied and must outlive the lattice.*/
+	template<typename T, template<typename U> class Descriptor>
+	class AcousticSource3D : public BoxProcessingFunctional3D_L<T,Descriptor>{
+	public:
+		AcousticSource3D(AcousticSignalTable<T> const* signal, T rho0,
+		  Array<T,3> const& u0, Array<T,3> const& coupling)
+			: state(signal, rho0, u0, coupling)
+		{ }
+
+		virtual void process(Box3D domain, BlockLattice3D<T,Descriptor>& lattice){
+			state.prepare(lattice.getTimeCounter().getTime() + 1);
+			for(plint iX = domain.x0; iX <= domain.x1; ++iX){
+				for(plint iY = domain.y0; iY <= domain.y1; ++iY){
+					for(plint iZ = domain.z0; iZ <= domain.z1; ++iZ){
+						state.impose(lattice.get(iX, iY, iZ));
+					}
+				}
+			}
+		}
+
+		virtual AcousticSource3D<T,Descriptor>* clone() const{
+			return new AcousticSource3D<T,Descriptor>(*this);
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::staticVariables;
+		}
+
+	private:
+		AcousticSourceState3D<T,Descriptor> state;
+	};
+
+	/* Same as AcousticSource3D, restricted to the cells of the domain whose
+	mask value equals flag.*/
+	template<typename T, template<typename U> class Descriptor>
+	class MaskedAcousticSource3D : public BoxProcessingFunctional3D_LS<T,Descriptor,int>{
+	public:
+		MaskedAcousticSource3D(AcousticSignalTable<T> const* signal, T rho0,
+		  Array<T,3> const& u0, Array<T,3> const& coupling, int flag_)
+			: state(signal, rho0, u0, coupling),
+			  flag(flag_)
+		{ }
+
+		virtual void process(Box3D domain, BlockLattice3D<T,Descriptor>& lattice,
+		  ScalarField3D<int>& mask){
+			state.prepare(lattice.getTimeCounter().getTime() + 1);
+			Dot3D offset = computeRelativeDisplacement(lattice, mask);
+			for(plint iX = domain.x0; iX <= domain.x1; ++iX){
+				for(plint iY = domain.y0; iY <= domain.y1; ++iY){
+					for(plint iZ = domain.z0; iZ <= domain.z1; ++iZ){
+						if(mask.get(iX + offset.x, iY + offset.y, iZ + offset.z) == flag){
+							state.impose(lattice.get(iX, iY, iZ));
+						}
+					}
+				}
+			}
+		}
+
+		virtual MaskedAcousticSource3D<T,Descriptor>* clone() const{
+			return new MaskedAcousticSource3D<T,Descriptor>(*this);
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::staticVariables;
+			modified[1] = modif::nothing;
+		}
+
+	private:
+		AcousticSourceState3D<T,Descriptor> state;
+		int flag;
+	};
+
+	// Integrates a source on a box of the lattice
+	template<typename T, template<typename U> class Descriptor>
+	void setAcousticSource(MultiBlockLattice3D<T,Descriptor>& lattice, Box3D domain,
+	  AcousticSignalTable<T> const& signal, T rho0, Array<T,3> const& u0,
+	  Array<T,3> const& coupling, plint level = 0){
+		integrateProcessingFunctional(
+		  new AcousticSource3D<T,Descriptor>(&signal, rho0, u0, coupling),
+		  domain, lattice, level);
+	}
+
+	// Integrates a source on the cells of a box flagged in mask
+	template<typename T, template<typename U> class Descriptor>
+	void setAcousticSource(MultiBlockLattice3D<T,Descriptor>& lattice,
+	  MultiScalarField3D<int>& mask, int flag, Box3D domain,
+	  AcousticSignalTable<T> const& signal, T rho0, Array<T,3> const& u0,
+	  Array<T,3> const& coupling, plint level = 0){
+		integrateProcessingFunctional(
+		  new MaskedAcousticSource3D<T,Descriptor>(&signal, rho0, u0, coupling, flag),
+		  domain, lattice, mask, level);
+	}
+
+}
+
+#endif  // ACOUSTIC_SOURCE_3D_H
@@ -8,6 +8,9 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include "acoustics/fwhSurface2D.h"
+#include "acoustics/anechoicLayer2D.h"
+#include "acoustics/impedanceWall2D.h"
 
 using namespace plb;
 using namespace std;
@@ -18,93 +21,39 @@ namespace plb_acoustics_2D{
 	typedef vector<T> Row;
 	typedef vector< Row > Matrix;
 	
+	/* Anechoic wall of size_anechoic_buffer+1 cells starting at
+	position_anechoic_wall and extending over length_anechoic_wall+1 cells.
+	delta increases to the right (1), bottom (2), left (3) or top (4).*/
 	template<typename T, template<typename U> class Descriptor>
 	void defineAnechoicWall(plint nx, plint ny,
 	 MultiBlockLattice2D<T,Descriptor>& lattice,
 	  T size_anechoic_buffer, plint orientation, T omega, 
 	  Array<plint, 2> position_anechoic_wall, plint length_anechoic_wall,
-	  T rhoBar_target, Array<T,2> j_target){
-		
-		// delta increase to the right
-		if(orientation == 1){
-			for(T delta = 0; delta <= size_anechoic_buffer; delta++){        
-		        DotList2D points_to_aplly_dynamics;
-		        for (int i = 0; i <= length_anechoic_wall; ++i){
-		            points_to_aplly_dynamics.addDot(
-		            	Dot2D(position_anechoic_wall[0] + delta,
-		            	position_anechoic_wall[1] + i));
-		        }
-		        AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
-		        new AnechoicDynamics<T,DESCRIPTOR>(omega);
-		        anechoicDynamics->setDelta((T) delta);
-		        anechoicDynamics->setRhoBar_target(rhoBar_target);
-		        //j_target[0] = -j_target[0];  
-		        anechoicDynamics->setJ_target(j_target);
-		        defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-	    	}
-		}
-
-		// delta increase to the top
-		else if(orientation == 4){
-			for(T delta = 0; delta <= size_anechoic_buffer; delta++){        
-		        DotList2D points_to_aplly_dynamics;
-		        for (int i = 0; i <= length_anechoic_wall; ++i){
-		            points_to_aplly_dynamics.addDot(
-		            	Dot2D(position_anechoic_wall[0] + i,
-		            	position_anechoic_wall[1] + delta));
-		        }
-		        AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
-		        new AnechoicDynamics<T,DESCRIPTOR>(omega);
-		        anechoicDynamics->setDelta((T) delta);
-		        anechoicDynamics->setRhoBar_target(rhoBar_target);
-		        anechoicDynamics->setJ_target(j_target);
-		        defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-	    	}
-		}
+	  T rhoBar_target = T(), Array<T,2> j_target = Array<T,2>((T)0, (T)0)){
 
-		// delta increase to the left
-		else if(orientation == 3){
-			for(T delta = 0; delta <= size_anechoic_buffer; delta++){        
-		        DotList2D points_to_aplly_dynamics;
-		        for (int i = 0; i <= length_anechoic_wall; ++i){
-		            points_to_aplly_dynamics.addDot(
-		            	Dot2D(position_anechoic_wall[0] + delta,
-		            	position_anechoic_wall[1] + i));
-		        }
-		        AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
-		        new AnechoicDynamics<T,DESCRIPTOR>(omega);
-		        T delta_left = 30 - delta;
-		        anechoicDynamics->setDelta(delta_left);
-		        anechoicDynamics->setRhoBar_target(rhoBar_target);
-		        anechoicDynamics->setJ_target(j_target);
-		        defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-	    	}
+		if(orientation < 1 || orientation > 4){
+			cout << "Anechoic Dynamics not Defined." << endl;
+			cout << "Choose the correct orientation number." << endl;
+			return;
 		}
 
-		// delta increase to the bottom
-		else if(orientation == 2){
-			for(T delta = 0; delta <= size_anechoic_buffer; delta++){        
-		        DotList2D points_to_aplly_dynamics;
-		        for (int i = 0; i <= length_anechoic_wall; ++i){
-		            points_to_aplly_dynamics.addDot(
-		            	Dot2D(position_anechoic_wall[0] + i,
-		            	position_anechoic_wall[1] +  delta));
-		        }
-		        AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
-		        new AnechoicDynamics<T,DESCRIPTOR>(omega);
-		        T delta_left = 30 - delta;
-		        anechoicDynamics->setDelta(delta_left);
-		        anechoicDynamics->setRhoBar_target(rhoBar_target);
-		        anechoicDynamics->setJ_target(j_target);
-		        defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-	    	}
+		plint width = (plint) size_anechoic_buffer;
+		plint x0 = position_anechoic_wall[0], y0 = position_anechoic_wall[1];
+		Box2D wall;
+		if(orientation == 1 || orientation == 3){
+			wall = Box2D(x0, x0 + width, y0, y0 + length_anechoic_wall);
 		}
-
 		else{
-			cout << "Anechoic Dynamics not Defined." << endl;
-			cout << "Choose the correct orientation number." << endl;
+			wall = Box2D(x0, x0 + length_anechoic_wall, y0, y0 + width);
 		}
 
+		AnechoicDynamics<T,Descriptor> *anechoicDynamics = 
+		new AnechoicDynamics<T,Descriptor>(omega);
+		anechoicDynamics->setRhoBar_target(rhoBar_target);
+		anechoicDynamics->setJ_target(j_target);
+		// The orientations match the faces of defineAnechoicLayer, and the
+		// layer covers the whole wall.
+		defineAnechoicLayer(lattice, wall, orientation, (T)(width + 1), anechoicDynamics);
 	}
 
 	template<typename T, template<typename U> class Descriptor>
@@ -125,7 +74,7 @@ namespace plb_acoustics_2D{
 						// set delta here
 						AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
 						new AnechoicDynamics<T,DESCRIPTOR>(omega);
-						T delta_efective = 30 - delta;
+						T delta_efective = size_anechoic_buffer - delta;
 						anechoicDynamics->setDelta(delta_efective);
 						anechoicDynamics->setRhoBar_target(rhoBar_target_1);
 						anechoicDynamics->setJ_target(j_target_1);
@@ -141,7 +90,7 @@ namespace plb_acoustics_2D{
 						// set delta here
 						AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
 						new AnechoicDynamics<T,DESCRIPTOR>(omega);
-						T delta_efective = 30 - delta;
+						T delta_efective = size_anechoic_buffer - delta;
 						anechoicDynamics->setDelta(delta_efective);
 						anechoicDynamics->setRhoBar_target(rhoBar_target_2);
 						anechoicDynamics->setJ_target(j_target_2);
@@ -157,7 +106,7 @@ namespace plb_acoustics_2D{
 						// set delta here
 						AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
 						new AnechoicDynamics<T,DESCRIPTOR>(omega);
-						T delta_efective = 30 - delta;
+						T delta_efective = size_anechoic_buffer - delta;
 						anechoicDynamics->setDelta(delta_efective);
 						anechoicDynamics->setRhoBar_target(rhoBar_target_3);
 						anechoicDynamics->setJ_target(j_target_3);
@@ -173,7 +122,7 @@ namespace plb_acoustics_2D{
 						// set delta here
 						AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
 						new AnechoicDynamics<T,DESCRIPTOR>(omega);
-						T delta_efective = 30 - delta;
+						T delta_efective = size_anechoic_buffer - delta;
 						anechoicDynamics->setDelta(delta_efective);
 						anechoicDynamics->setRhoBar_target(rhoBar_target_4);
 						anechoicDynamics->setJ_target(j_target_4);
@@ -243,7 +192,7 @@ namespace plb_acoustics_2D{
 
 	  	public:
 	  	FW_H_Surface_square(Array<T, 2> center, plint radius, plint maxIter, plint start_transient_iteration);
-	  	void import_pressures_velocities(MultiBlockLattice2D<T, DESCRIPTOR> lattice, plint iT);
+	  	void import_pressures_velocities(MultiBlockLattice2D<T, DESCRIPTOR>& lattice, plint iT);
 	  	void save_data(char *pressure_file_name, char *velocity_x_file_name, char *velocity_y_file_name);
 	};
 
@@ -261,7 +210,7 @@ namespace plb_acoustics_2D{
     	this->matrix_sfwh_velocity_y = matrix_sfwh_velocity_y;
 	}
 
-	void FW_H_Surface_square::import_pressures_velocities(MultiBlockLattice2D<T, DESCRIPTOR> lattice, plint iT){
+	void FW_H_Surface_square::import_pressures_velocities(MultiBlockLattice2D<T, DESCRIPTOR>& lattice, plint iT){
 		plint point_surface = 0;
         // to face 1 (left)
         for (plint y = this->center[1] - this->radius; y < this->center[1] + this->radius; y++){
@@ -360,8 +309,6 @@ namespace plb_acoustics_2D{
 	  T rhoBar_target_2, T rhoBar_target_3, T rhoBar_target_4){
 
 	  	typedef AnechoicMRTdynamics<T,DESCRIPTOR> AnechoicBackgroundDynamics;
-	  	/* if size_anechoic_buffer is not equal 30, we have to change 
-	  	total_distance in file dynamicsTemplates2D.h too*/
 	 	for(T delta = 0; delta <= size_anechoic_buffer; delta++){
 			// for in all points-cell lattice
 			for(plint y = 0; y < ny; y++){
@@ -373,7 +320,7 @@ namespace plb_acoustics_2D{
 						// set delta here
                         AnechoicBackgroundDynamics *anechoicDynamics = 
                         new AnechoicBackgroundDynamics(omega);
-						T delta_efective = 30 - delta;
+						T delta_efective = size_anechoic_buffer - delta;
 						anechoicDynamics->setDelta(delta_efective);
 						anechoicDynamics->setRhoBar_target(rhoBar_target_1);
 						anechoicDynamics->setJ_target(j_target_1);
@@ -389,7 +336,7 @@ namespace plb_acoustics_2D{
 						// set delta here
 						AnechoicBackgroundDynamics *anechoicDynamics = 
                         new AnechoicBackgroundDynamics(omega);
-						T delta_efective = 30 - delta;
+						T delta_efective = size_anechoic_buffer - delta;
 						anechoicDynamics->setDelta(delta_efective);
 						anechoicDynamics->setRhoBar_target(rhoBar_target_2);
 						anechoicDynamics->setJ_target(j_target_2);
@@ -405,7 +352,7 @@ namespace plb_acoustics_2D{
 						// set delta here
 						AnechoicBackgroundDynamics *anechoicDynamics = 
                         new AnechoicBackgroundDynamics(omega);
-						T delta_efective = 30 - delta;
+						T delta_efective = size_anechoic_buffer - delta;
 						anechoicDynamics->setDelta(delta_efective);
 						anechoicDynamics->setRhoBar_target(rhoBar_target_3);
 						anechoicDynamics->setJ_target(j_target_3);
@@ -421,7 +368,7 @@ namespace plb_acoustics_2D{
 						// set delta here
 						AnechoicBackgroundDynamics *anechoicDynamics = 
                         new AnechoicBackgroundDynamics(omega);
-						T delta_efective = 30 - delta;
+						T delta_efective = size_anechoic_buffer - delta;
 						anechoicDynamics->setDelta(delta_efective);
 						anechoicDynamics->setRhoBar_target(rhoBar_target_4);
 						anechoicDynamics->setJ_target(j_target_4);
@@ -8,6 +8,14 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include "acoustics/probeSet3D.h"
+#include "acoustics/probeHistory3D.h"
+#include "acoustics/spectralEstimator3D.h"
+#include "acoustics/fwhSurface3D.h"
+#include "acoustics/acousticSource3D.h"
+#include "acoustics/anechoicLayer3D.h"
+#include "acoustics/anechoicSigma3D.h"
+#include "acoustics/impedanceWall3D.h"
 
 using namespace plb;
 using namespace std;
@@ -115,6 +123,170 @@ namespace plb_acoustics_3D{
 
 	}
 
+	/* Data processor that instantiates the anechoic layer on the six boards
+	of the domain in a single sweep. For each cell the distance to every board
+	is computed from its absolute position, and the board with the largest
+	valid distance wins (ties resolved in the order right, bottom, left, top,
+	front, back), which reproduces the layering of the former per-delta loops.
+	The boards are those of the box domain, in absolute coordinates.
+	Every cell receives its own copy of the prototype dynamics with delta and
+	j_target set, so that the absorption coefficient and the target moments
+	are evaluated once here and not at each collision.*/
+	template<typename T, template<typename U> class Descriptor, class AnechoicDynamicsT>
+	class AnechoicBoardsFunctional3D : public BoxProcessingFunctional3D_L<T,Descriptor>{
+	public:
+		// j_targets ordered as right, bottom, left, top, front, back
+		AnechoicBoardsFunctional3D(Box3D boards_domain_,
+		  T size_anechoic_buffer_, AnechoicDynamicsT* prototype_,
+		  std::vector<Array<T,3> > const& j_targets_)
+			: boards_domain(boards_domain_),
+			  size_anechoic_buffer(size_anechoic_buffer_),
+			  prototype(prototype_),
+			  j_targets(j_targets_)
+		{
+			PLB_ASSERT( j_targets.size() == 6 );
+		}
+
+		AnechoicBoardsFunctional3D(AnechoicBoardsFunctional3D<T,Descriptor,AnechoicDynamicsT> const& rhs)
+			: boards_domain(rhs.boards_domain),
+			  size_anechoic_buffer(rhs.size_anechoic_buffer),
+			  prototype(rhs.prototype->clone()),
+			  j_targets(rhs.j_targets)
+		{ }
+
+		AnechoicBoardsFunctional3D<T,Descriptor,AnechoicDynamicsT>& operator=(
+		  AnechoicBoardsFunctional3D<T,Descriptor,AnechoicDynamicsT> const& rhs)
+		{
+			AnechoicBoardsFunctional3D<T,Descriptor,AnechoicDynamicsT>(rhs).swap(*this);
+			return *this;
+		}
+
+		~AnechoicBoardsFunctional3D(){
+			delete prototype;
+		}
+
+		void swap(AnechoicBoardsFunctional3D<T,Descriptor,AnechoicDynamicsT>& rhs){
+			std::swap(boards_domain, rhs.boards_domain);
+			std::swap(size_anechoic_buffer, rhs.size_anechoic_buffer);
+			std::swap(prototype, rhs.prototype);
+			j_targets.swap(rhs.j_targets);
+		}
+
+		virtual void process(Box3D domain, BlockLattice3D<T,Descriptor>& lattice){
+			Dot3D offset = lattice.getLocation();
+			for(plint iX = domain.x0; iX <= domain.x1; ++iX){
+				plint x = iX + offset.x - boards_domain.x0;
+				for(plint iY = domain.y0; iY <= domain.y1; ++iY){
+					plint y = iY + offset.y - boards_domain.y0;
+					for(plint iZ = domain.z0; iZ <= domain.z1; ++iZ){
+						plint z = iZ + offset.z - boards_domain.z0;
+						plint delta = -1;
+						plint board = boardOf(x, y, z, delta);
+						if(board >= 0){
+							AnechoicDynamicsT *anechoicDynamics = prototype->clone();
+							anechoicDynamics->setDelta(size_anechoic_buffer - (T) delta);
+							anechoicDynamics->setJ_target(j_targets[board]);
+							lattice.attributeDynamics(iX, iY, iZ, anechoicDynamics);
+						}
+					}
+				}
+			}
+		}
+
+		virtual AnechoicBoardsFunctional3D<T,Descriptor,AnechoicDynamicsT>* clone() const{
+			return new AnechoicBoardsFunctional3D<T,Descriptor,AnechoicDynamicsT>(*this);
+		}
+
+		virtual BlockDomain::DomainT appliesTo() const{
+			// Dynamics needs to be instantiated everywhere, including envelope.
+			return BlockDomain::bulkAndEnvelope;
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::dataStructure;
+		}
+
+	private:
+		// Returns the board (0..5) the cell belongs to and its distance to the
+		// border of the domain, or -1 if the cell is outside the layer.
+		// Coordinates are relative to the corner of boards_domain.
+		plint boardOf(plint x, plint y, plint z, plint& delta) const{
+			plint nx = boards_domain.getNx();
+			plint ny = boards_domain.getNy();
+			plint nz = boards_domain.getNz();
+			plint candidates[6] = { nx - x, y, x, ny - y, nz - z, z };
+			plint board = -1;
+			for(plint iBoard = 0; iBoard < 6; ++iBoard){
+				plint d = candidates[iBoard];
+				if(d < 0 || (T) d > size_anechoic_buffer || d <= delta){
+					continue;
+				}
+				bool inside;
+				if(iBoard == 0 || iBoard == 2){
+					inside = y >= (d-1) && y < (ny-d) && z >= (d-1) && z < (nz-d);
+				}
+				else if(iBoard == 1 || iBoard == 3){
+					inside = x >= (d-1) && x < (nx-d) && z >= (d-1) && z < (nz-d);
+				}
+				else{
+					inside = x >= (d-1) && x < (nx-d) && y >= (d-1) && y < (ny-d);
+				}
+				if(inside){
+					board = iBoard;
+					delta = d;
+				}
+			}
+			return board;
+		}
+
+	private:
+		Box3D boards_domain;
+		T size_anechoic_buffer;
+		AnechoicDynamicsT *prototype;
+		std::vector<Array<T,3> > j_targets;
+	};
+
+	/* Applies the anechoic layer on the six boards of boards_domain. Only
+	the slabs of thickness size_anechoic_buffer along the boards are visited.*/
+	template<typename T, template<typename U> class Descriptor, class AnechoicDynamicsT>
+	void applyAnechoicBoards(Box3D boards_domain,
+	 MultiBlockLattice3D<T,Descriptor>& lattice,
+	  T size_anechoic_buffer, AnechoicDynamicsT* prototype,
+	  std::vector<Array<T,3> > const& j_targets){
+		plint thickness = (plint) size_anechoic_buffer;
+		plint x0 = boards_domain.x0, x1 = boards_domain.x1;
+		plint y0 = boards_domain.y0, y1 = boards_domain.y1;
+		plint z0 = boards_domain.z0, z1 = boards_domain.z1;
+		std::vector<Box3D> boards;
+		boards.push_back(Box3D(x1+1-thickness, x1, y0, y1, z0, z1));
+		boards.push_back(Box3D(x0, x1, y0, y0+thickness, z0, z1));
+		boards.push_back(Box3D(x0, x0+thickness, y0, y1, z0, z1));
+		boards.push_back(Box3D(x0, x1, y1+1-thickness, y1, z0, z1));
+		boards.push_back(Box3D(x0, x1, y0, y1, z1+1-thickness, z1));
+		boards.push_back(Box3D(x0, x1, y0, y1, z0, z0+thickness));
+		for(pluint iBoard = 0; iBoard < boards.size(); ++iBoard){
+			Box3D board;
+			// Cells shared by two boards are visited twice, the result is the same.
+			if(intersect(boards[iBoard], boards_domain, board)){
+				applyProcessingFunctional(
+				  new AnechoicBoardsFunctional3D<T,Descriptor,AnechoicDynamicsT>(
+				    boards_domain, size_anechoic_buffer, prototype->clone(), j_targets),
+				  board, lattice);
+			}
+		}
+		delete prototype;
+	}
+
+	// Same as above, on the whole nx x ny x nz domain
+	template<typename T, template<typename U> class Descriptor, class AnechoicDynamicsT>
+	void applyAnechoicBoards(plint nx, plint ny, plint nz,
+	 MultiBlockLattice3D<T,Descriptor>& lattice,
+	  T size_anechoic_buffer, AnechoicDynamicsT* prototype,
+	  std::vector<Array<T,3> > const& j_targets){
+		applyAnechoicBoards(Box3D(0, nx-1, 0, ny-1, 0, nz-1), lattice,
+		  size_anechoic_buffer, prototype, j_targets);
+	}
+
 	template<typename T, template<typename U> class Descriptor>
 	void defineAnechoicBoards(plint nx, plint ny, plint nz,
 	 MultiBlockLattice3D<T,Descriptor>& lattice,
@@ -126,125 +298,21 @@ namespace plb_acoustics_3D{
 	  Array<T,3> j_target_normal_x_positive,
 	  Array<T,3> j_target_normal_x_negative,
 	  T rhoBar_target){
-	  	/* if size_anechoic_buffer is not equal size_anechoic_buffer, we have to change 
-	  	total_distance in file dynamicsTemplates3D.h too*/
-	 	for(T delta = 0; delta <= size_anechoic_buffer; delta++){
-			// for in all points-cell lattice
-	 		for(plint z = 0; z < nz; z++){
-				for(plint y = 0; y < ny; y++){
-					for(plint x = 0; x < nx; x++){
-						// condition to right (1)
-						if(x == (nx-delta) &&
-						  y >= (delta-1) && 
-						  y < (ny-delta) &&
-						  z >= (delta-1) && 
-						  z < (nz-delta)){
-							// set delta here
-							AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
-							new AnechoicDynamics<T,DESCRIPTOR>(omega);
-							T delta_efective = size_anechoic_buffer - delta;
-							anechoicDynamics->setDelta(delta_efective);
-							anechoicDynamics->setRhoBar_target(rhoBar_target);
-							anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-							anechoicDynamics->setJ_target(j_target_normal_x_positive);
-							DotList3D points_to_aplly_dynamics;
-							points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-							defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-						}
-						// condition to bottom (2)
-						else if(x >= (delta-1) &&
-						  x < (nx-delta) &&
-						  y == delta &&
-						  z >= (delta-1) && 
-						  z < (nz-delta)){
-							// set delta here
-							AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
-							new AnechoicDynamics<T,DESCRIPTOR>(omega);
-							T delta_efective = size_anechoic_buffer - delta;
-							anechoicDynamics->setDelta(delta_efective);
-							anechoicDynamics->setRhoBar_target(rhoBar_target);
-							anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-							anechoicDynamics->setJ_target(j_target_normal_y_negative);
-							DotList3D points_to_aplly_dynamics;
-							points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-							defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-						}
-						// condition to left (3)
-						else if(x == delta &&
-						  y >= (delta-1) &&
-						  y < (ny-delta) &&
-						  z >= (delta-1) && 
-						  z < (nz-delta)){
-							// set delta here
-							AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
-							new AnechoicDynamics<T,DESCRIPTOR>(omega);
-							T delta_efective = size_anechoic_buffer - delta;
-							anechoicDynamics->setDelta(delta_efective);
-							anechoicDynamics->setRhoBar_target(rhoBar_target);
-							anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-							anechoicDynamics->setJ_target(j_target_normal_x_negative);
-							DotList3D points_to_aplly_dynamics;
-							points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-							defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-						}
-						// condition to top (4)
-						else if(x >= (delta-1) &&
-						  x < (nx-delta) &&
-						  y == (ny-delta) &&
-						  z >= (delta-1) && 
-						  z < (nz-delta)){
-							// set delta here
-							AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
-							new AnechoicDynamics<T,DESCRIPTOR>(omega);
-							T delta_efective = size_anechoic_buffer - delta;
-							anechoicDynamics->setDelta(delta_efective);
-							anechoicDynamics->setRhoBar_target(rhoBar_target);
-							anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-							anechoicDynamics->setJ_target(j_target_normal_y_positive);
-							DotList3D points_to_aplly_dynamics;
-							points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-							defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-						}
-						// condition to front (5)
-						else if(x >= (delta-1) &&
-						  x < (nx-delta) &&
-						  z == (nz-delta) &&
-						  y >= (delta-1) && 
-						  y < (nz-delta)){
-							// set delta here
-							AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
-							new AnechoicDynamics<T,DESCRIPTOR>(omega);
-							T delta_efective = size_anechoic_buffer - delta;
-							anechoicDynamics->setDelta(delta_efective);
-							anechoicDynamics->setRhoBar_target(rhoBar_target);
-							anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-							anechoicDynamics->setJ_target(j_target_normal_z_positive);
-							DotList3D points_to_aplly_dynamics;
-							points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-							defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-						}
-						// condition to back (6)
-						else if(x >= (delta-1) &&
-						  x < (nx-delta) &&
-						  z == delta &&
-						  y >= (delta-1) && 
-						  y < (nz-delta)){
-							// set delta here
-							AnechoicDynamics<T,DESCRIPTOR> *anechoicDynamics = 
-							new AnechoicDynamics<T,DESCRIPTOR>(omega);
-							T delta_efective = size_anechoic_buffer - delta;
-							anechoicDynamics->setDelta(delta_efective);
-							anechoicDynamics->setRhoBar_target(rhoBar_target);
-							anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-							anechoicDynamics->setJ_target(j_target_normal_z_negative);
-							DotList3D points_to_aplly_dynamics;
-							points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-							defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-						}
-					}
-				}
-			}
-		}
+		AnechoicDynamics<T,Descriptor> *anechoicDynamics = 
+		new AnechoicDynamics<T,Descriptor>(omega);
+		anechoicDynamics->setRhoBar_target(rhoBar_target);
+		anechoicDynamics->setBuffer_size(size_anechoic_buffer);
+
+		std::vector<Array<T,3> > j_targets;
+		j_targets.push_back(j_target_normal_x_positive);
+		j_targets.push_back(j_target_normal_y_negative);
+		j_targets.push_back(j_target_normal_x_negative);
+		j_targets.push_back(j_target_normal_y_positive);
+		j_targets.push_back(j_target_normal_z_positive);
+		j_targets.push_back(j_target_normal_z_negative);
+
+		applyAnechoicBoards(nx, ny, nz, lattice, size_anechoic_buffer,
+		  anechoicDynamics, j_targets);
 	}
 
 	template<typename T, template<typename U> class Descriptor>
@@ -266,135 +334,59 @@ namespace plb_acoustics_3D{
 	  	j_target_normal_x_positive = -j_target_normal_x_positive;
 	  	j_target_normal_x_negative = -j_target_normal_x_negative;
 
-	  	typedef AnechoicMRTdynamics<T,DESCRIPTOR> AnechoicBackgroundDynamics;
-	  	/* if size_anechoic_buffer is not equal size_anechoic_buffer, we have to change 
-	  	total_distance in file dynamicsTemplates3D.h too*/
-	 	for(T delta = 0; delta <= size_anechoic_buffer; delta++){
-			// for in all points-cell lattice
-	 		for(plint z = 0; z < nz; z++){
-				for(plint y = 0; y < ny; y++){
-					for(plint x = 0; x < nx; x++){
-						// condition to right (1)
-                        if(x == (nx-delta) &&
-                          y >= (delta-1) && 
-                          y < (ny-delta) &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_x_positive);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to bottom (2)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          y == delta &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_y_negative);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to left (3)
-                        else if(x == delta &&
-                          y >= (delta-1) &&
-                          y < (ny-delta) &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_x_negative);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to top (4)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          y == (ny-delta) &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_y_positive);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to front (5)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          z == (nz-delta) &&
-                          y >= (delta-1) && 
-                          y < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_z_positive);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to back (6)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          z == delta &&
-                          y >= (delta-1) && 
-                          y < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_z_negative);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-					}
-				}
-			}
-		}
+	  	typedef AnechoicMRTdynamics<T,Descriptor> AnechoicBackgroundDynamics;
+		AnechoicBackgroundDynamics *anechoicDynamics = 
+		new AnechoicBackgroundDynamics(omega);
+		anechoicDynamics->setRhoBar_target(rhoBar_target);
+		anechoicDynamics->setBuffer_size(size_anechoic_buffer);
+
+		std::vector<Array<T,3> > j_targets;
+		j_targets.push_back(j_target_normal_x_positive);
+		j_targets.push_back(j_target_normal_y_negative);
+		j_targets.push_back(j_target_normal_x_negative);
+		j_targets.push_back(j_target_normal_y_positive);
+		j_targets.push_back(j_target_normal_z_positive);
+		j_targets.push_back(j_target_normal_z_negative);
+
+		applyAnechoicBoards(nx, ny, nz, lattice, size_anechoic_buffer,
+		  anechoicDynamics, j_targets);
 	}
 
-
-/*defineAnechoicMRTWall(plint nx, plint ny, plint nz,
+	/* Same boards with the anechoic cumulant dynamics (D3Q27). Its absorption
+	term is the one of AnechoicDynamics, so the targets are not negated as
+	for the MRT boards.*/
+	template<typename T, template<typename U> class Descriptor>
+	void defineAnechoicCumulantBoards(plint nx, plint ny, plint nz,
 	 MultiBlockLattice3D<T,Descriptor>& lattice,
-	  T size_anechoic_buffer, plint orientation, T omega, 
-	  Array<plint, 3> position_anechoic_wall, plint length_anechoic_wall,plint width_anechoic_wall,
-	  T rhoBar_target, Array<T,3> j_target)*/
+	  T size_anechoic_buffer, T omega, 
+	  Array<T,3> j_target_normal_z_positive,
+	  Array<T,3> j_target_normal_z_negative,
+	  Array<T,3> j_target_normal_y_positive,
+	  Array<T,3> j_target_normal_y_negative,
+	  Array<T,3> j_target_normal_x_positive,
+	  Array<T,3> j_target_normal_x_negative,
+	  T rhoBar_target){
+		AnechoicCumulantDynamics<T,Descriptor> *anechoicDynamics = 
+		new AnechoicCumulantDynamics<T,Descriptor>(omega);
+		anechoicDynamics->setRhoBar_target(rhoBar_target);
+		anechoicDynamics->setBuffer_size(size_anechoic_buffer);
+
+		std::vector<Array<T,3> > j_targets;
+		j_targets.push_back(j_target_normal_x_positive);
+		j_targets.push_back(j_target_normal_y_negative);
+		j_targets.push_back(j_target_normal_x_negative);
+		j_targets.push_back(j_target_normal_y_positive);
+		j_targets.push_back(j_target_normal_z_positive);
+		j_targets.push_back(j_target_normal_z_negative);
+
+		applyAnechoicBoards(nx, ny, nz, lattice, size_anechoic_buffer,
+		  anechoicDynamics, j_targets);
+	}
 
+
+/* Anechoic MRT layer of thickness size_anechoic_buffer on one face of the
+nx x ny x nz domain: right (1), bottom (2), left (3), top (4), front (5) or
+back (6).*/
 template<typename T, template<typename U> class Descriptor>
 	void defineAnechoicMRTWall(plint nx, plint ny, plint nz,
 	 MultiBlockLattice3D<T,Descriptor>& lattice,
@@ -404,128 +396,19 @@ template<typename T, template<typename U> class Descriptor>
 
 		j_target = -j_target;
 
-	  	typedef AnechoicMRTdynamics<T,DESCRIPTOR> AnechoicBackgroundDynamics;
-
-	 	for(T delta = 0; delta <= size_anechoic_buffer; delta++){
-			// for in all points-cell lattice
-	 		for(plint z = 0; z < nz; z++){
-				for(plint y = 0; y < ny; y++){
-					for(plint x = 0; x < nx; x++){
-						// condition to right (1)
-                        if(x == (nx-delta) &&
-                          y >= (delta-1) && 
-                          y < (ny-delta) &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            //defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to bottom (2)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          y == delta &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            //defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to left (3)
-                        else if(x == delta &&
-                          y >= (delta-1) &&
-                          y < (ny-delta) &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            //defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to top (4)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          y == (ny-delta) &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            //defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to front (5)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          z == (nz-delta) &&
-                          y >= (delta-1) && 
-                          y < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to back (6)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          z == delta &&
-                          y >= (delta-1) && 
-                          y < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            //defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-					}
-				}
-			}
-		}
+	  	typedef AnechoicMRTdynamics<T,Descriptor> AnechoicBackgroundDynamics;
+		AnechoicBackgroundDynamics *anechoicDynamics = 
+		new AnechoicBackgroundDynamics(omega);
+		anechoicDynamics->setRhoBar_target(rhoBar_target);
+		anechoicDynamics->setBuffer_size(size_anechoic_buffer);
+		anechoicDynamics->setJ_target(j_target);
+
+		defineAnechoicLayer(lattice, Box3D(0, nx-1, 0, ny-1, 0, nz-1),
+		  orientation, size_anechoic_buffer, anechoicDynamics);
 	}
 
 
+/* Same as defineAnechoicMRTBoards, on the part z >= off_set_z of the domain.*/
 template<typename T, template<typename U> class Descriptor>
 	void defineAnechoicMRTBoards_limited(plint nx, plint ny, plint nz,
 	 MultiBlockLattice3D<T,Descriptor>& lattice,
@@ -538,133 +421,22 @@ template<typename T, template<typename U> class Descriptor>
 	  Array<T,3> j_target_normal_x_negative,
 	  T rhoBar_target, plint off_set_z){
 
-		j_target_normal_z_positive = -j_target_normal_z_positive;
-	  	j_target_normal_z_negative = -j_target_normal_z_negative;
-	  	j_target_normal_y_positive = -j_target_normal_y_positive;
-	  	j_target_normal_y_negative = -j_target_normal_y_negative;
-	  	j_target_normal_x_positive = -j_target_normal_x_positive;
-	  	j_target_normal_x_negative = -j_target_normal_x_negative;
-
-	  	typedef AnechoicMRTdynamics<T,DESCRIPTOR> AnechoicBackgroundDynamics;
-	  	/* if size_anechoic_buffer is not equal size_anechoic_buffer, we have to change 
-	  	total_distance in file dynamicsTemplates3D.h too*/
-	 	for(T delta = 0; delta <= size_anechoic_buffer; delta++){
-			// for in all points-cell lattice
-	 		for(plint z = off_set_z; z < nz; z++){
-				for(plint y = 0; y < ny; y++){
-					for(plint x = 0; x < nx; x++){
-						// condition to right (1)
-                        if(x == (nx-delta) &&
-                          y >= (delta-1) && 
-                          y < (ny-delta) &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_x_positive);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to bottom (2)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          y == delta &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_y_negative);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to left (3)
-                        else if(x == delta &&
-                          y >= (delta-1) &&
-                          y < (ny-delta) &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_x_negative);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to top (4)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          y == (ny-delta) &&
-                          z >= (delta-1) && 
-                          z < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_y_positive);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to front (5)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          z == (nz-delta) &&
-                          y >= (delta-1) && 
-                          y < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_z_positive);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-                        // condition to back (6)
-                        else if(x >= (delta-1) &&
-                          x < (nx-delta) &&
-                          z == delta + off_set_z &&
-                          y >= (delta-1) && 
-                          y < (nz-delta)){
-                            // set delta here
-                            AnechoicBackgroundDynamics *anechoicDynamics = 
-                            new AnechoicBackgroundDynamics(omega);
-                            T delta_efective = size_anechoic_buffer - delta;
-                            anechoicDynamics->setDelta(delta_efective);
-                            anechoicDynamics->setRhoBar_target(rhoBar_target);
-                            anechoicDynamics->setBuffer_size(size_anechoic_buffer);
-                            anechoicDynamics->setJ_target(j_target_normal_z_negative);
-                            DotList3D points_to_aplly_dynamics;
-                            points_to_aplly_dynamics.addDot(Dot3D(x,y,z));
-                            defineDynamics(lattice, points_to_aplly_dynamics, anechoicDynamics);
-                        }
-					}
-				}
-			}
-		}
+	  	typedef AnechoicMRTdynamics<T,Descriptor> AnechoicBackgroundDynamics;
+		AnechoicBackgroundDynamics *anechoicDynamics = 
+		new AnechoicBackgroundDynamics(omega);
+		anechoicDynamics->setRhoBar_target(rhoBar_target);
+		anechoicDynamics->setBuffer_size(size_anechoic_buffer);
+
+		std::vector<Array<T,3> > j_targets;
+		j_targets.push_back(-j_target_normal_x_positive);
+		j_targets.push_back(-j_target_normal_y_negative);
+		j_targets.push_back(-j_target_normal_x_negative);
+		j_targets.push_back(-j_target_normal_y_positive);
+		j_targets.push_back(-j_target_normal_z_positive);
+		j_targets.push_back(-j_target_normal_z_negative);
+
+		applyAnechoicBoards(Box3D(0, nx-1, 0, ny-1, off_set_z, nz-1), lattice,
+		  size_anechoic_buffer, anechoicDynamics, j_targets);
 	}
 
 
@@ -763,16 +535,20 @@ T get_linear_chirp(T ka_min, T ka_max, plint maxT_final_source, plint iT, T drho
     return chirp_hand;
 }
 
+/* Sum of sin(n*theta) for n = 1..N in closed form, instead of N sines.*/
+T sum_of_harmonic_sines(plint N, T theta){
+    T half = sin(theta/2);
+    if (fabs(half) < 1.e-12){
+        return 0;
+    }
+    return sin(N*theta/2)*sin((N+1)*theta/2)/half;
+}
+
 T get_linear_chirp_AZ(T ka_max, plint total_signals, plint maxT_final_source, plint iT, T drho, T radius){
     T cs = 1/sqrt(3);
-    T chirp_value = 1;
     total_signals = 2*total_signals;
-    for (plint n_signal = 1; n_signal <= total_signals; n_signal++){
-        T interval = ka_max/total_signals;
-        T phase = (n_signal*interval*cs*iT)/(radius);
-        chirp_value += drho*sin(phase);
-    }
-    return chirp_value;
+    T interval = ka_max/total_signals;
+    return 1 + drho*sum_of_harmonic_sines(total_signals, (interval*cs*iT)/(radius));
 }
 
 T get_tonal(T ka, plint maxT_final_source, plint iT, T drho, T radius){
@@ -784,15 +560,9 @@ T get_tonal(T ka, plint maxT_final_source, plint iT, T drho, T radius){
 }
 
 T get_linear_chirp_AZ_freq_omega(T freq_omega_max, plint total_signals, plint maxT_final_source, plint iT, T drho){
-    T cs = 1/sqrt(3);
-    T chirp_value = 1;
     total_signals = 2*total_signals;
-    for (plint n_signal = 1; n_signal <= total_signals; n_signal++){
-        T interval = freq_omega_max/total_signals;
-        T phase = (n_signal*interval*iT);
-        chirp_value += drho*sin(phase);
-    }
-    return chirp_value;
+    T interval = freq_omega_max/total_signals;
+    return 1 + drho*sum_of_harmonic_sines(total_signals, interval*iT);
 }
 
 void set_source(MultiBlockLattice3D<T,DESCRIPTOR>& lattice, Array<plint,3> position, 
@@ -940,14 +710,25 @@ class Probe{
             this->name_probe = name_probe;   
         }
 
+        Box3D get_location(){
+            return this->location;
+        }
+
         void save_point(MultiBlockLattice3D<T,DESCRIPTOR>& lattice, T rho0, T cs2){
-            this->file_pressures << setprecision(10) << (computeAverageDensity(lattice, this->location) - rho0)*cs2 << endl;
-            std::auto_ptr<MultiScalarField3D<T> > velocity_x(plb::computeVelocityComponent(lattice, this->location, 0));
-            this->file_velocities_x << setprecision(10) << computeAverage(*velocity_x, this->location) << endl;
-            std::auto_ptr<MultiScalarField3D<T> > velocity_y(plb::computeVelocityComponent(lattice, this->location, 1));
-            this->file_velocities_y << setprecision(10) << computeAverage(*velocity_y, this->location) << endl;
-            std::auto_ptr<MultiScalarField3D<T> > velocity_z(plb::computeVelocityComponent(lattice, this->location, 2));
-            this->file_velocities_z << setprecision(10) << computeAverage(*velocity_z, this->location) << endl;
+            ProbeSet3D<T,DESCRIPTOR> probes;
+            probes.addProbe(this->location, this->name_probe);
+            probes.sample(lattice);
+            this->write_point(probes, 0, rho0, cs2);
+        }
+
+        // Writes the values of probe iProbe of an already sampled ProbeSet3D
+        void write_point(ProbeSet3D<T,DESCRIPTOR> const& probes, plint iProbe, T rho0, T cs2){
+            Array<T,3> velocity = probes.getVelocity(iProbe);
+            // No endl: the streams are flushed by their buffer, not every step.
+            this->file_pressures << setprecision(10) << probes.getPressure(iProbe, rho0, cs2) << '\n';
+            this->file_velocities_x << setprecision(10) << velocity[0] << '\n';
+            this->file_velocities_y << setprecision(10) << velocity[1] << '\n';
+            this->file_velocities_z << setprecision(10) << velocity[2] << '\n';
         }
 };
 
@@ -955,11 +736,20 @@ class Two_Microphones{
     private:
         Probe microphone_1;
         Probe microphone_2;
+        ProbeSet3D<T,DESCRIPTOR> probes;
+        // Positions along the duct axis and duct end, for the spectra
+        std::vector<T> microphones_z;
+        T duct_end_z;
+        T radius_duct;
+        SpectralEstimator3D<T> *spectra;
+        // Owns spectra: copying would delete it twice.
+        Two_Microphones(Two_Microphones const& rhs);
+        Two_Microphones& operator=(Two_Microphones const& rhs);
     public:
         Two_Microphones(plint radius, plint microphone_distance, 
             plint length_duct, Array<plint,3> position_duct, 
             std::string fNameOut, std::string name, plint distance, 
-            plint nx, plint ny, plint nz){
+            plint nx, plint ny, plint nz) : spectra(0){
 
             plint radius_probe = (radius - 1)/sqrt(2);
             plint position_z = position_duct[2] + length_duct - distance;
@@ -981,11 +771,47 @@ class Two_Microphones{
                     position_z + microphone_distance);
             std::string name_p2 = name + "_p2";
             this->microphone_2.set_properties(surface_probe_p2, fNameOut, name_p2);
+
+            this->probes.addProbe(surface_probe_p1, name_p1);
+            this->probes.addProbe(surface_probe_p2, name_p2);
+
+            this->microphones_z.push_back((T) position_z);
+            this->microphones_z.push_back((T) (position_z + microphone_distance));
+            this->duct_end_z = (T) (position_duct[2] + length_duct);
+            this->radius_duct = (T) radius;
+        }
+
+        ~Two_Microphones(){
+            delete this->spectra;
+        }
+
+        /* Accumulates the spectra of the two microphones during the run, at
+        the given frequencies (cycles per time step).*/
+        void enable_spectra(std::vector<T> frequencies, plint segment_length){
+            delete this->spectra;
+            this->spectra = new SpectralEstimator3D<T>(2, frequencies, segment_length);
         }
 
         void save_point(MultiBlockLattice3D<T,DESCRIPTOR>& lattice, T rho0, T cs2){
-            this->microphone_1.save_point(lattice, rho0, cs2);
-            this->microphone_2.save_point(lattice, rho0, cs2);   
+            this->probes.sample(lattice);
+            this->microphone_1.write_point(this->probes, 0, rho0, cs2);
+            this->microphone_2.write_point(this->probes, 1, rho0, cs2);
+            if (this->spectra){
+                this->spectra->append(this->probes, rho0, cs2);
+            }
+        }
+
+        /* Writes frequency, ka, |R|, arg(R) and l/a at the duct end, from
+        the spectra accumulated since enable_spectra.*/
+        void write_reflection(std::string file_name, T mach, T cs){
+            PLB_ASSERT( this->spectra );
+            this->spectra->writeReflection(file_name, this->microphones_z,
+                this->duct_end_z, mach, cs, this->radius_duct);
+        }
+
+        // Sampled microphones, e.g. to feed a ProbeHistoryWriter3D
+        ProbeSet3D<T,DESCRIPTOR> const& get_probes(){
+            return this->probes;
         }
 };
 
@@ -995,6 +821,7 @@ class Coefficient_Reflection_Probes{
         Probe probe_B;
         Probe probe_C;
         Probe probe_D;
+        ProbeSet3D<T,DESCRIPTOR> probes;
     public:
         Coefficient_Reflection_Probes(Array<plint,3> position_A,
         	Array<plint,3> position_B,
@@ -1022,14 +849,24 @@ class Coefficient_Reflection_Probes{
             std::string name_D = name + "_D";
             Probe probe_D(surface_probe_D, fNameOut, name_D);
             this->probe_D.set_properties(surface_probe_D, fNameOut, name_D);
-            
+
+            this->probes.addProbe(surface_probe_A, name_A);
+            this->probes.addProbe(surface_probe_B, name_B);
+            this->probes.addProbe(surface_probe_C, name_C);
+            this->probes.addProbe(surface_probe_D, name_D);
         }
 
         void save_point(MultiBlockLattice3D<T,DESCRIPTOR>& lattice, T rho0, T cs2){
-            this->probe_A.save_point(lattice, rho0, cs2);
-            this->probe_B.save_point(lattice, rho0, cs2);
-            this->probe_C.save_point(lattice, rho0, cs2);
-            this->probe_D.save_point(lattice, rho0, cs2);
+            this->probes.sample(lattice);
+            this->probe_A.write_point(this->probes, 0, rho0, cs2);
+            this->probe_B.write_point(this->probes, 1, rho0, cs2);
+            this->probe_C.write_point(this->probes, 2, rho0, cs2);
+            this->probe_D.write_point(this->probes, 3, rho0, cs2);
+        }
+
+        // Sampled microphones, e.g. to feed a ProbeHistoryWriter3D
+        ProbeSet3D<T,DESCRIPTOR> const& get_probes(){
+            return this->probes;
         }
 };
 
@@ -1038,13 +875,21 @@ class Coefficient_Reflection_Probes{
 class System_Abom_Measurement{
     private:
         std::vector<Box3D> microphones_positions; 
+        ProbeSet3D<T,DESCRIPTOR> probes;
+        std::vector<T> microphones_z;
+        T duct_end_z;
+        T radius_duct;
+        SpectralEstimator3D<T> *spectra;
         plb_ofstream file_pressures;
         plb_ofstream file_velocities_x;
         plb_ofstream file_velocities_y;
         plb_ofstream file_velocities_z;
+        // Owns spectra: copying would delete it twice.
+        System_Abom_Measurement(System_Abom_Measurement const& rhs);
+        System_Abom_Measurement& operator=(System_Abom_Measurement const& rhs);
     public:
         System_Abom_Measurement(MultiBlockLattice3D<T,DESCRIPTOR>& lattice, Array<plint,3> position_duct, 
-            plint begin_microphone, plint length_duct, plint radius, string directory){
+            plint begin_microphone, plint length_duct, plint radius, string directory) : spectra(0){
 
             string name_probe = "system_abom_measurement_data";
             directory = directory + "/" + name_probe;
@@ -1089,7 +934,11 @@ class System_Abom_Measurement{
                 	position_microphone);
 
             	this->microphones_positions.push_back(surface_microphone);
+            	this->probes.addProbe(surface_microphone);
+            	this->microphones_z.push_back((T) position_microphone);
             }
+            this->duct_end_z = (T) (position_duct[2] + length_duct);
+            this->radius_duct = (T) radius;
 
             pcout << "MICROPHONES" << endl;
             for (int i = 0; i < this->microphones_positions.size(); i++){
@@ -1099,20 +948,49 @@ class System_Abom_Measurement{
             }
         }
 
+    ~System_Abom_Measurement(){
+        delete this->spectra;
+    }
+
+    /* Accumulates the spectra of all the microphones during the run, at
+    the given frequencies (cycles per time step). The last microphone is
+    the phase reference.*/
+    void enable_spectra(std::vector<T> frequencies, plint segment_length){
+        delete this->spectra;
+        plint num_microphones = this->probes.getNumProbes();
+        this->spectra = new SpectralEstimator3D<T>(num_microphones, frequencies,
+            segment_length, num_microphones-1);
+    }
+
+    /* Writes frequency, ka, |R|, arg(R) and l/a at the duct end, from a
+    least squares wave decomposition over all the microphones.*/
+    void write_reflection(std::string file_name, T mach, T cs){
+        PLB_ASSERT( this->spectra );
+        this->spectra->writeReflection(file_name, this->microphones_z,
+            this->duct_end_z, mach, cs, this->radius_duct);
+    }
+
     void save_point(MultiBlockLattice3D<T,DESCRIPTOR>& lattice, T rho0, T cs2){
-        for (int mic = 0; mic < this->microphones_positions.size(); mic++){
-            file_pressures << setprecision(10) << (computeAverageDensity(lattice, this->microphones_positions[mic]) - rho0)*cs2 << " ";
-            std::auto_ptr<MultiScalarField3D<T> > velocity_x(plb::computeVelocityComponent(lattice, this->microphones_positions[mic], 0));
-            file_velocities_x << setprecision(10) << computeAverage(*velocity_x, this->microphones_positions[mic]) << " ";
-            std::auto_ptr<MultiScalarField3D<T> > velocity_y(plb::computeVelocityComponent(lattice, this->microphones_positions[mic], 1));
-            file_velocities_y << setprecision(10) << computeAverage(*velocity_y, this->microphones_positions[mic]) << " ";
-            std::auto_ptr<MultiScalarField3D<T> > velocity_z(plb::computeVelocityComponent(lattice, this->microphones_positions[mic], 2));
-            file_velocities_z << setprecision(10) << computeAverage(*velocity_z, this->microphones_positions[mic]) << " ";
+        this->probes.sample(lattice);
+        if (this->spectra){
+            this->spectra->append(this->probes, rho0, cs2);
+        }
+        for (int mic = 0; mic < this->probes.getNumProbes(); mic++){
+            Array<T,3> velocity = this->probes.getVelocity(mic);
+            file_pressures << setprecision(10) << this->probes.getPressure(mic, rho0, cs2) << " ";
+            file_velocities_x << setprecision(10) << velocity[0] << " ";
+            file_velocities_y << setprecision(10) << velocity[1] << " ";
+            file_velocities_z << setprecision(10) << velocity[2] << " ";
         }
-        file_pressures << endl;
-        file_velocities_x << endl;
-        file_velocities_y << endl;
-        file_velocities_z << endl;
+        file_pressures << '\n';
+        file_velocities_x << '\n';
+        file_velocities_y << '\n';
+        file_velocities_z << '\n';
+    }
+
+    // Sampled microphones, e.g. to feed a ProbeHistoryWriter3D
+    ProbeSet3D<T,DESCRIPTOR> const& get_probes(){
+        return this->probes;
     }
 };
 
@@ -1120,13 +998,21 @@ class System_Abom_Measurement{
 class System_Abom_Measurement_points{
     private:
         std::vector<Box3D> microphones_positions; 
+        ProbeSet3D<T,DESCRIPTOR> probes;
+        std::vector<T> microphones_z;
+        T duct_end_z;
+        T radius_duct;
+        SpectralEstimator3D<T> *spectra;
         plb_ofstream file_pressures;
         plb_ofstream file_velocities_x;
         plb_ofstream file_velocities_y;
         plb_ofstream file_velocities_z;
+        // Owns spectra: copying would delete it twice.
+        System_Abom_Measurement_points(System_Abom_Measurement_points const& rhs);
+        System_Abom_Measurement_points& operator=(System_Abom_Measurement_points const& rhs);
     public:
         System_Abom_Measurement_points(MultiBlockLattice3D<T,DESCRIPTOR>& lattice, Array<plint,3> position_duct, 
-            plint begin_microphone, plint length_duct, plint radius, string directory, Array<plint,2> centering_point, string name_probe){
+            plint begin_microphone, plint length_duct, plint radius, string directory, Array<plint,2> centering_point, string name_probe) : spectra(0){
 
             directory = directory + "/" + name_probe;
             std::string command = "mkdir -p " + directory;
@@ -1170,7 +1056,11 @@ class System_Abom_Measurement_points{
                 	position_microphone);
 
             	this->microphones_positions.push_back(surface_microphone);
+            	this->probes.addProbe(surface_microphone);
+            	this->microphones_z.push_back((T) position_microphone);
             }
+            this->duct_end_z = (T) (position_duct[2] + length_duct);
+            this->radius_duct = (T) radius;
 
             pcout << "MICROPHONES" << endl;
             for (int i = 0; i < this->microphones_positions.size(); i++){
@@ -1180,20 +1070,49 @@ class System_Abom_Measurement_points{
             }
         }
 
+    ~System_Abom_Measurement_points(){
+        delete this->spectra;
+    }
+
+    /* Accumulates the spectra of all the microphones during the run, at
+    the given frequencies (cycles per time step). The last microphone is
+    the phase reference.*/
+    void enable_spectra(std::vector<T> frequencies, plint segment_length){
+        delete this->spectra;
+        plint num_microphones = this->probes.getNumProbes();
+        this->spectra = new SpectralEstimator3D<T>(num_microphones, frequencies,
+            segment_length, num_microphones-1);
+    }
+
+    /* Writes frequency, ka, |R|, arg(R) and l/a at the duct end, from a
+    least squares wave decomposition over all the microphones.*/
+    void write_reflection(std::string file_name, T mach, T cs){
+        PLB_ASSERT( this->spectra );
+        this->spectra->writeReflection(file_name, this->microphones_z,
+            this->duct_end_z, mach, cs, this->radius_duct);
+    }
+
     void save_point(MultiBlockLattice3D<T,DESCRIPTOR>& lattice, T rho0, T cs2){
-        for (int mic = 0; mic < this->microphones_positions.size(); mic++){
-            file_pressures << setprecision(10) << (computeAverageDensity(lattice, this->microphones_positions[mic]) - rho0)*cs2 << " ";
-            std::auto_ptr<MultiScalarField3D<T> > velocity_x(plb::computeVelocityComponent(lattice, this->microphones_positions[mic], 0));
-            file_velocities_x << setprecision(10) << computeAverage(*velocity_x, this->microphones_positions[mic]) << " ";
-            std::auto_ptr<MultiScalarField3D<T> > velocity_y(plb::computeVelocityComponent(lattice, this->microphones_positions[mic], 1));
-            file_velocities_y << setprecision(10) << computeAverage(*velocity_y, this->microphones_positions[mic]) << " ";
-            std::auto_ptr<MultiScalarField3D<T> > velocity_z(plb::computeVelocityComponent(lattice, this->microphones_positions[mic], 2));
-            file_velocities_z << setprecision(10) << computeAverage(*velocity_z, this->microphones_positions[mic]) << " ";
+        this->probes.sample(lattice);
+        if (this->spectra){
+            this->spectra->append(this->probes, rho0, cs2);
         }
-        file_pressures << endl;
-        file_velocities_x << endl;
-        file_velocities_y << endl;
-        file_velocities_z << endl;
+        for (int mic = 0; mic < this->probes.getNumProbes(); mic++){
+            Array<T,3> velocity = this->probes.getVelocity(mic);
+            file_pressures << setprecision(10) << this->probes.getPressure(mic, rho0, cs2) << " ";
+            file_velocities_x << setprecision(10) << velocity[0] << " ";
+            file_velocities_y << setprecision(10) << velocity[1] << " ";
+            file_velocities_z << setprecision(10) << velocity[2] << " ";
+        }
+        file_pressures << '\n';
+        file_velocities_x << '\n';
+        file_velocities_y << '\n';
+        file_velocities_z << '\n';
+    }
+
+    // Sampled microphones, e.g. to feed a ProbeHistoryWriter3D
+    ProbeSet3D<T,DESCRIPTOR> const& get_probes(){
+        return this->probes;
     }
 };
 
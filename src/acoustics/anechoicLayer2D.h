@@ -0,0 +1,153 @@
+/* Anechoic layer on one face of a box of a 2D lattice.
+ *
+ * The layer is the strip of given thickness of the box along the chosen
+ * face. It is instantiated by a single data processor on that strip, so
+ * every processor only visits the cells of its own blocks.
+ */
+
+#ifndef ANECHOIC_LAYER_2D_H
+#define ANECHOIC_LAYER_2D_H
+
+#include "palabos2D.h"
+#ifndef PLB_PRECOMPILED // Unless precompiled version is used,
+#include "palabos2D.hh"   // include full template code
+#endif
+#include "acoustics/anechoicProfile.h"
+#include <vector>
+#include <algorithm>
+
+namespace plb_acoustics_2D{
+
+	using namespace plb;
+	using plb_acoustics::SigmaProfile;
+	using plb_acoustics::PolynomialSigmaProfile;
+	using plb_acoustics::anechoicDepth;
+
+	/* Attributes to every cell a copy of the prototype dynamics, with sigma
+	given by the profile as a function of the depth of the cell center into
+	the layer (see anechoicDepth), the outer border of the layer lying at
+	outer along axis. delta and buffer_size are set accordingly.*/
+	template<typename T, template<typename U> class Descriptor, class AnechoicDynamicsT>
+	class AnechoicLayerFunctional2D : public BoxProcessingFunctional2D_L<T,Descriptor>{
+	public:
+		AnechoicLayerFunctional2D(plint axis_, T outer_, T thickness_,
+		  AnechoicDynamicsT* prototype_, SigmaProfile<T>* profile_)
+			: axis(axis_), outer(outer_), thickness(thickness_),
+			  prototype(prototype_), profile(profile_)
+		{
+			PLB_ASSERT( axis >= 0 && axis < 2 );
+		}
+
+		AnechoicLayerFunctional2D(AnechoicLayerFunctional2D<T,Descriptor,AnechoicDynamicsT> const& rhs)
+			: axis(rhs.axis), outer(rhs.outer), thickness(rhs.thickness),
+			  prototype(rhs.prototype->clone()), profile(rhs.profile->clone())
+		{ }
+
+		AnechoicLayerFunctional2D<T,Descriptor,AnechoicDynamicsT>& operator=(
+		  AnechoicLayerFunctional2D<T,Descriptor,AnechoicDynamicsT> const& rhs)
+		{
+			AnechoicLayerFunctional2D<T,Descriptor,AnechoicDynamicsT>(rhs).swap(*this);
+			return *this;
+		}
+
+		~AnechoicLayerFunctional2D(){
+			delete prototype;
+			delete profile;
+		}
+
+		void swap(AnechoicLayerFunctional2D<T,Descriptor,AnechoicDynamicsT>& rhs){
+			std::swap(axis, rhs.axis);
+			std::swap(outer, rhs.outer);
+			std::swap(thickness, rhs.thickness);
+			std::swap(prototype, rhs.prototype);
+			std::swap(profile, rhs.profile);
+		}
+
+		virtual void process(Box2D domain, BlockLattice2D<T,Descriptor>& lattice){
+			Dot2D offset = lattice.getLocation();
+			for(plint iX = domain.x0; iX <= domain.x1; ++iX){
+				for(plint iY = domain.y0; iY <= domain.y1; ++iY){
+					plint position[2] = { iX + offset.x, iY + offset.y };
+					T x = anechoicDepth((T) position[axis], outer, thickness);
+					AnechoicDynamicsT *anechoicDynamics = prototype->clone();
+					anechoicDynamics->setBuffer_size(thickness);
+					anechoicDynamics->setDelta(x*thickness);
+					anechoicDynamics->setSigma((*profile)(x));
+					lattice.attributeDynamics(iX, iY, anechoicDynamics);
+				}
+			}
+		}
+
+		virtual AnechoicLayerFunctional2D<T,Descriptor,AnechoicDynamicsT>* clone() const{
+			return new AnechoicLayerFunctional2D<T,Descriptor,AnechoicDynamicsT>(*this);
+		}
+
+		virtual BlockDomain::DomainT appliesTo() const{
+			// Dynamics needs to be instantiated everywhere, including envelope.
+			return BlockDomain::bulkAndEnvelope;
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::dataStructure;
+		}
+
+	private:
+		plint axis;
+		T outer, thickness;
+		AnechoicDynamicsT *prototype;
+		SigmaProfile<T> *profile;
+	};
+
+	/* Strip of given thickness, a whole number of cells, along a face of
+	domain. The faces are numbered as the orientation of defineAnechoicWall:
+	right (1, x1), bottom (2, y0), left (3, x0), top (4, y1). On return, axis
+	is the direction normal to the face and outer the coordinate of the outer
+	border of the layer, the boundary of domain half a cell beyond its last
+	cells.*/
+	template<typename T>
+	Box2D computeAnechoicSlab(Box2D domain, plint face, T thickness,
+	  plint& axis, T& outer){
+		static const plint axes[4] = { 0, 1, 0, 1 };
+		static const bool upper_faces[4] = { true, false, false, true };
+		PLB_ASSERT( face >= 1 && face <= 4 );
+		PLB_ASSERT( thickness > T() );
+		// The profile is evaluated with thickness itself: it must be a whole
+		// number of cells, so that the slab ends where the profile vanishes.
+		PLB_ASSERT( (T) util::roundToInt(thickness) == thickness );
+		axis = axes[face-1];
+		bool upper = upper_faces[face-1];
+		Array<plint,4> bounds = domain.to_plbArray();
+		plint lower_bound = bounds[2*axis], upper_bound = bounds[2*axis+1];
+		plint width = util::roundToInt(thickness);
+		if(upper){
+			outer = (T) upper_bound + (T)0.5;
+			bounds[2*axis] = std::max(lower_bound, upper_bound - width + 1);
+		}
+		else{
+			outer = (T) lower_bound - (T)0.5;
+			bounds[2*axis+1] = std::min(upper_bound, lower_bound + width - 1);
+		}
+		Box2D slab;
+		slab.from_plbArray(bounds);
+		return slab;
+	}
+
+	/* Anechoic layer of given thickness along a face of domain, on the strip
+	of computeAnechoicSlab. The prototype holds omega and the targets, and is
+	deleted here; the default profile is the law of the anechoic dynamics.*/
+	template<typename T, template<typename U> class Descriptor, class AnechoicDynamicsT>
+	void defineAnechoicLayer(MultiBlockLattice2D<T,Descriptor>& lattice, Box2D domain,
+	  plint face, T thickness, AnechoicDynamicsT* prototype,
+	  SigmaProfile<T> const& profile = PolynomialSigmaProfile<T>()){
+		plint axis;
+		T outer;
+		Box2D layer = computeAnechoicSlab(domain, face, thickness, axis, outer);
+		applyProcessingFunctional(
+		  new AnechoicLayerFunctional2D<T,Descriptor,AnechoicDynamicsT>(
+		    axis, outer, thickness, prototype, profile.clone()),
+		  layer, lattice);
+	}
+
+}
+
+#endif  // ANECHOIC_LAYER_2D_H
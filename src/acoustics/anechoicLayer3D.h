@@ -0,0 +1,157 @@
+/* Anechoic layer on one face of a box of a 3D lattice.
+ *
+ * The layer is the slab of given thickness of the box along the chosen
+ * face. It is instantiated by a single data processor on that slab, so
+ * every processor only visits the cells of its own blocks and the setup
+ * cost is proportional to the volume of the layer.
+ */
+
+#ifndef ANECHOIC_LAYER_3D_H
+#define ANECHOIC_LAYER_3D_H
+
+#include "palabos3D.h"
+#ifndef PLB_PRECOMPILED // Unless precompiled version is used,
+#include "palabos3D.hh"   // include full template code
+#endif
+#include "acoustics/anechoicProfile.h"
+#include <vector>
+#include <algorithm>
+
+namespace plb_acoustics_3D{
+
+	using namespace plb;
+	using plb_acoustics::SigmaProfile;
+	using plb_acoustics::PolynomialSigmaProfile;
+	using plb_acoustics::anechoicDepth;
+
+	/* Attributes to every cell a copy of the prototype dynamics, with sigma
+	given by the profile as a function of the depth of the cell center into
+	the layer (see anechoicDepth), the outer border of the layer lying at
+	outer along axis. delta and buffer_size are set accordingly.*/
+	template<typename T, template<typename U> class Descriptor, class AnechoicDynamicsT>
+	class AnechoicLayerFunctional3D : public BoxProcessingFunctional3D_L<T,Descriptor>{
+	public:
+		AnechoicLayerFunctional3D(plint axis_, T outer_, T thickness_,
+		  AnechoicDynamicsT* prototype_, SigmaProfile<T>* profile_)
+			: axis(axis_), outer(outer_), thickness(thickness_),
+			  prototype(prototype_), profile(profile_)
+		{
+			PLB_ASSERT( axis >= 0 && axis < 3 );
+		}
+
+		AnechoicLayerFunctional3D(AnechoicLayerFunctional3D<T,Descriptor,AnechoicDynamicsT> const& rhs)
+			: axis(rhs.axis), outer(rhs.outer), thickness(rhs.thickness),
+			  prototype(rhs.prototype->clone()), profile(rhs.profile->clone())
+		{ }
+
+		AnechoicLayerFunctional3D<T,Descriptor,AnechoicDynamicsT>& operator=(
+		  AnechoicLayerFunctional3D<T,Descriptor,AnechoicDynamicsT> const& rhs)
+		{
+			AnechoicLayerFunctional3D<T,Descriptor,AnechoicDynamicsT>(rhs).swap(*this);
+			return *this;
+		}
+
+		~AnechoicLayerFunctional3D(){
+			delete prototype;
+			delete profile;
+		}
+
+		void swap(AnechoicLayerFunctional3D<T,Descriptor,AnechoicDynamicsT>& rhs){
+			std::swap(axis, rhs.axis);
+			std::swap(outer, rhs.outer);
+			std::swap(thickness, rhs.thickness);
+			std::swap(prototype, rhs.prototype);
+			std::swap(profile, rhs.profile);
+		}
+
+		virtual void process(Box3D domain, BlockLattice3D<T,Descriptor>& lattice){
+			Dot3D offset = lattice.getLocation();
+			for(plint iX = domain.x0; iX <= domain.x1; ++iX){
+				for(plint iY = domain.y0; iY <= domain.y1; ++iY){
+					for(plint iZ = domain.z0; iZ <= domain.z1; ++iZ){
+						plint position[3] = { iX + offset.x, iY + offset.y, iZ + offset.z };
+						T x = anechoicDepth((T) position[axis], outer, thickness);
+						AnechoicDynamicsT *anechoicDynamics = prototype->clone();
+						anechoicDynamics->setBuffer_size(thickness);
+						anechoicDynamics->setDelta(x*thickness);
+						anechoicDynamics->setSigma((*profile)(x));
+						lattice.attributeDynamics(iX, iY, iZ, anechoicDynamics);
+					}
+				}
+			}
+		}
+
+		virtual AnechoicLayerFunctional3D<T,Descriptor,AnechoicDynamicsT>* clone() const{
+			return new AnechoicLayerFunctional3D<T,Descriptor,AnechoicDynamicsT>(*this);
+		}
+
+		virtual BlockDomain::DomainT appliesTo() const{
+			// Dynamics needs to be instantiated everywhere, including envelope.
+			return BlockDomain::bulkAndEnvelope;
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::dataStructure;
+		}
+
+	private:
+		plint axis;
+		T outer, thickness;
+		AnechoicDynamicsT *prototype;
+		SigmaProfile<T> *profile;
+	};
+
+	/* Slab of given thickness, a whole number of cells, along a face of
+	domain. The faces are numbered as the orientation of defineAnechoicMRTWall:
+	right (1, x1), bottom (2, y0), left (3, x0), top (4, y1), front (5, z1),
+	back (6, z0). On return, axis is the direction normal to the face and
+	outer the coordinate of the outer border of the layer, the boundary of
+	domain half a cell beyond its last cells. All the layers (anechoic, sigma
+	fields, impedance walls) use this geometry.*/
+	template<typename T>
+	Box3D computeAnechoicSlab(Box3D domain, plint face, T thickness,
+	  plint& axis, T& outer){
+		static const plint axes[6] = { 0, 1, 0, 1, 2, 2 };
+		static const bool upper_faces[6] = { true, false, false, true, true, false };
+		PLB_ASSERT( face >= 1 && face <= 6 );
+		PLB_ASSERT( thickness > T() );
+		// The profile is evaluated with thickness itself: it must be a whole
+		// number of cells, so that the slab ends where the profile vanishes.
+		PLB_ASSERT( (T) util::roundToInt(thickness) == thickness );
+		axis = axes[face-1];
+		bool upper = upper_faces[face-1];
+		Array<plint,6> bounds = domain.to_plbArray();
+		plint lower_bound = bounds[2*axis], upper_bound = bounds[2*axis+1];
+		plint width = util::roundToInt(thickness);
+		if(upper){
+			outer = (T) upper_bound + (T)0.5;
+			bounds[2*axis] = std::max(lower_bound, upper_bound - width + 1);
+		}
+		else{
+			outer = (T) lower_bound - (T)0.5;
+			bounds[2*axis+1] = std::min(upper_bound, lower_bound + width - 1);
+		}
+		Box3D slab;
+		slab.from_plbArray(bounds);
+		return slab;
+	}
+
+	/* Anechoic layer of given thickness along a face of domain, on the slab
+	of computeAnechoicSlab. The prototype holds omega and the targets, and is
+	deleted here; the default profile is the law of the anechoic dynamics.*/
+	template<typename T, template<typename U> class Descriptor, class AnechoicDynamicsT>
+	void defineAnechoicLayer(MultiBlockLattice3D<T,Descriptor>& lattice, Box3D domain,
+	  plint face, T thickness, AnechoicDynamicsT* prototype,
+	  SigmaProfile<T> const& profile = PolynomialSigmaProfile<T>()){
+		plint axis;
+		T outer;
+		Box3D layer = computeAnechoicSlab(domain, face, thickness, axis, outer);
+		applyProcessingFunctional(
+		  new AnechoicLayerFunctional3D<T,Descriptor,AnechoicDynamicsT>(
+		    axis, outer, thickness, prototype, profile.clone()),
+		  layer, lattice);
+	}
+
+}
+
+#endif  // ANECHOIC_LAYER_3D_H
@@ -0,0 +1,128 @@
+/* Profiles of the anechoic layers.
+ *
+ * A SigmaProfile gives the absorption coefficient sigma as a function of the
+ * normalized depth into a layer. It is used by defineAnechoicLayer and by
+ * the sigma fields of anechoicSigma3D.h; the anechoic dynamics evaluate the
+ * default law of anechoicDefaults (in basicDynamics/isoThermalDynamics.h)
+ * from delta and buffer_size, which PolynomialSigmaProfile reproduces with
+ * its default arguments. All layers share the geometry of
+ * computeAnechoicSlab: the outer border lies half a cell beyond the last
+ * cells of the domain, and the depth of a cell is taken at its center (see
+ * anechoicDepth).
+ */
+
+#ifndef ANECHOIC_PROFILE_H
+#define ANECHOIC_PROFILE_H
+
+#include "core/globalDefs.h"
+#include "basicDynamics/isoThermalDynamics.h"
+#include <cmath>
+#include <algorithm>
+
+namespace plb_acoustics{
+
+	using namespace plb;
+
+	/* Depth x of a cell center into a layer, 0 on the inner border (next to
+	the fluid) and 1 on the outer one, located at outer along the normal.*/
+	template<typename T>
+	T anechoicDepth(T position, T outer, T thickness){
+		T distance = position - outer;
+		if(distance < T()) distance = -distance;
+		return std::max(T(), (T)1 - distance/thickness);
+	}
+
+	/* Absorption coefficient as a function of the depth x into the layer,
+	0 on the inner border (next to the fluid) and 1 on the outer one.*/
+	template<typename T>
+	class SigmaProfile{
+	public:
+		virtual ~SigmaProfile(){ }
+		virtual T operator()(T x) const =0;
+		virtual SigmaProfile<T>* clone() const =0;
+	};
+
+	// sigma = sigma_max*x^exponent; the defaults are the law of the dynamics.
+	template<typename T>
+	class PolynomialSigmaProfile : public SigmaProfile<T>{
+	public:
+		explicit PolynomialSigmaProfile(T sigma_max_ = (T)anechoicDefaults::sigmaMax, T exponent_ = (T)2)
+			: sigma_max(sigma_max_), exponent(exponent_)
+		{ }
+
+		virtual T operator()(T x) const{
+			return sigma_max*std::pow(x, exponent);
+		}
+
+		virtual PolynomialSigmaProfile<T>* clone() const{
+			return new PolynomialSigmaProfile<T>(*this);
+		}
+
+	private:
+		T sigma_max, exponent;
+	};
+
+	/* sigma = sigma_max*tanh(steepness*x)/tanh(steepness): smooth start,
+	sigma_max reached on the outer border.*/
+	template<typename T>
+	class TanhSigmaProfile : public SigmaProfile<T>{
+	public:
+		TanhSigmaProfile(T sigma_max_, T steepness_)
+			: sigma_max(sigma_max_), steepness(steepness_)
+		{ }
+
+		virtual T operator()(T x) const{
+			return sigma_max*std::tanh(steepness*x)/std::tanh(steepness);
+		}
+
+		virtual TanhSigmaProfile<T>* clone() const{
+			return new TanhSigmaProfile<T>(*this);
+		}
+
+	private:
+		T sigma_max, steepness;
+	};
+
+	// sigma = sigma_max*(1 - cos(pi*x))/2, with zero slope on both borders.
+	template<typename T>
+	class CosineSigmaProfile : public SigmaProfile<T>{
+	public:
+		explicit CosineSigmaProfile(T sigma_max_)
+			: sigma_max(sigma_max_)
+		{ }
+
+		virtual T operator()(T x) const{
+			return sigma_max*((T)1 - std::cos(std::acos((T)-1)*x))/(T)2;
+		}
+
+		virtual CosineSigmaProfile<T>* clone() const{
+			return new CosineSigmaProfile<T>(*this);
+		}
+
+	private:
+		T sigma_max;
+	};
+
+	// User-defined law, given as a function of the depth x.
+	template<typename T>
+	class UserSigmaProfile : public SigmaProfile<T>{
+	public:
+		explicit UserSigmaProfile(T (*function_)(T))
+			: function(function_)
+		{ }
+
+		virtual T operator()(T x) const{
+			return function(x);
+		}
+
+		virtual UserSigmaProfile<T>* clone() const{
+			return new UserSigmaProfile<T>(*this);
+		}
+
+	private:
+		T (*function)(T);
+	};
+
+}
+
+#endif  // ANECHOIC_PROFILE_H
@@ -0,0 +1,164 @@
+/* Absorption coefficient of the anechoic layers stored in a scalar field.
+ *
+ * computeAnechoicSigma fills a MultiScalarField3D with a SigmaProfile on the
+ * slab of one face of a box; calling it for several faces keeps, at every
+ * cell, the largest value, so that edges and corners where layers overlap
+ * are absorbed as strongly as the strongest layer. setAnechoicSigma then
+ * hands the field to the dynamics through dynamicParams::anechoicSigma,
+ * which is understood by AnechoicDynamics, AnechoicBGKdynamics and
+ * AnechoicMRTdynamics and ignored by any other dynamics.
+ */
+
+#ifndef ANECHOIC_SIGMA_3D_H
+#define ANECHOIC_SIGMA_3D_H
+
+#include "palabos3D.h"
+#ifndef PLB_PRECOMPILED // Unless precompiled version is used,
+#include "palabos3D.hh"   // include full template code
+#endif
+#include "acoustics/anechoicLayer3D.h"
+#include <vector>
+#include <algorithm>
+
+namespace plb_acoustics_3D{
+
+	using namespace plb;
+	using plb_acoustics::SigmaProfile;
+	using plb_acoustics::PolynomialSigmaProfile;
+	using plb_acoustics::TanhSigmaProfile;
+	using plb_acoustics::CosineSigmaProfile;
+	using plb_acoustics::UserSigmaProfile;
+	using plb_acoustics::anechoicDepth;
+
+	/* Writes max(sigma, profile(x)) in every cell, x being the depth of the
+	cell center into the layer whose outer border lies at outer along axis
+	(see anechoicDepth).*/
+	template<typename T>
+	class AnechoicSigmaFunctional3D : public BoxProcessingFunctional3D_S<T>{
+	public:
+		AnechoicSigmaFunctional3D(plint axis_, T outer_, T thickness_,
+		  SigmaProfile<T>* profile_)
+			: axis(axis_), outer(outer_), thickness(thickness_),
+			  profile(profile_)
+		{
+			PLB_ASSERT( axis >= 0 && axis < 3 );
+		}
+
+		AnechoicSigmaFunctional3D(AnechoicSigmaFunctional3D<T> const& rhs)
+			: axis(rhs.axis), outer(rhs.outer), thickness(rhs.thickness),
+			  profile(rhs.profile->clone())
+		{ }
+
+		AnechoicSigmaFunctional3D<T>& operator=(AnechoicSigmaFunctional3D<T> const& rhs){
+			AnechoicSigmaFunctional3D<T>(rhs).swap(*this);
+			return *this;
+		}
+
+		~AnechoicSigmaFunctional3D(){
+			delete profile;
+		}
+
+		void swap(AnechoicSigmaFunctional3D<T>& rhs){
+			std::swap(axis, rhs.axis);
+			std::swap(outer, rhs.outer);
+			std::swap(thickness, rhs.thickness);
+			std::swap(profile, rhs.profile);
+		}
+
+		virtual void process(Box3D domain, ScalarField3D<T>& sigma){
+			Dot3D offset = sigma.getLocation();
+			for(plint iX = domain.x0; iX <= domain.x1; ++iX){
+				for(plint iY = domain.y0; iY <= domain.y1; ++iY){
+					for(plint iZ = domain.z0; iZ <= domain.z1; ++iZ){
+						plint position[3] = { iX + offset.x, iY + offset.y, iZ + offset.z };
+						T x = anechoicDepth((T) position[axis], outer, thickness);
+						T& value = sigma.get(iX, iY, iZ);
+						value = std::max(value, (*profile)(x));
+					}
+				}
+			}
+		}
+
+		virtual AnechoicSigmaFunctional3D<T>* clone() const{
+			return new AnechoicSigmaFunctional3D<T>(*this);
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::staticVariables;
+		}
+
+	private:
+		plint axis;
+		T outer, thickness;
+		SigmaProfile<T> *profile;
+	};
+
+	/* Hands the value of the field to the dynamics of every cell of the
+	domain. The background dynamics is shared by many cells and is left
+	untouched.*/
+	template<typename T, template<typename U> class Descriptor>
+	class SetAnechoicSigmaFunctional3D : public BoxProcessingFunctional3D_LS<T,Descriptor,T>{
+	public:
+		virtual void process(Box3D domain, BlockLattice3D<T,Descriptor>& lattice,
+		  ScalarField3D<T>& sigma){
+			Dot3D offset = computeRelativeDisplacement(lattice, sigma);
+			Dynamics<T,Descriptor> const* background = &lattice.getBackgroundDynamics();
+			for(plint iX = domain.x0; iX <= domain.x1; ++iX){
+				for(plint iY = domain.y0; iY <= domain.y1; ++iY){
+					for(plint iZ = domain.z0; iZ <= domain.z1; ++iZ){
+						Dynamics<T,Descriptor>& dynamics = lattice.get(iX, iY, iZ).getDynamics();
+						if(&dynamics == background) continue;
+						dynamics.setParameter(dynamicParams::anechoicSigma,
+						  sigma.get(iX + offset.x, iY + offset.y, iZ + offset.z));
+					}
+				}
+			}
+		}
+
+		virtual SetAnechoicSigmaFunctional3D<T,Descriptor>* clone() const{
+			return new SetAnechoicSigmaFunctional3D<T,Descriptor>(*this);
+		}
+
+		virtual BlockDomain::DomainT appliesTo() const{
+			// Dynamics are modified everywhere, including envelope.
+			return BlockDomain::bulkAndEnvelope;
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::dataStructure;
+			modified[1] = modif::nothing;
+		}
+	};
+
+	// Sigma profile on the layer of given thickness along a face of domain
+	template<typename T>
+	void computeAnechoicSigma(MultiScalarField3D<T>& sigma, Box3D domain,
+	  plint face, T thickness, SigmaProfile<T> const& profile){
+		plint axis;
+		T outer;
+		Box3D layer = computeAnechoicSlab(domain, face, thickness, axis, outer);
+		applyProcessingFunctional(
+		  new AnechoicSigmaFunctional3D<T>(axis, outer, thickness, profile.clone()),
+		  layer, sigma);
+	}
+
+	// Layers of same thickness and profile on the six faces of domain
+	template<typename T>
+	void computeAnechoicSigma(MultiScalarField3D<T>& sigma, Box3D domain,
+	  T thickness, SigmaProfile<T> const& profile){
+		for(plint face = 1; face <= 6; ++face){
+			computeAnechoicSigma(sigma, domain, face, thickness, profile);
+		}
+	}
+
+	// Imposes the field on the anechoic dynamics of the cells of domain
+	template<typename T, template<typename U> class Descriptor>
+	void setAnechoicSigma(MultiBlockLattice3D<T,Descriptor>& lattice,
+	  MultiScalarField3D<T>& sigma, Box3D domain){
+		applyProcessingFunctional(
+		  new SetAnechoicSigmaFunctional3D<T,Descriptor>(), domain, lattice, sigma);
+	}
+
+}
+
+#endif  // ANECHOIC_SIGMA_3D_H
@@ -0,0 +1,194 @@
+/* Ffowcs Williams-Hawkings integration on a permeable, stationary surface.
+ *
+ * Formulation 1A of Farassat without mean flow: for an observer at x,
+ *
+ *   4 pi p'(x,t) = sum_dS [ dQ/dt / r + dL_r/dt / (c r) + L_r / r^2 ]_ret dS
+ *
+ * with Q = rho u_n and L_i = p' n_i + rho u_i u_n. Each surface element
+ * deposits its contribution directly at the retarded observer time, so the
+ * observer signals are built on the fly. Only a ring buffer covering the
+ * spread of propagation delays is kept per observer, i.e. the memory is
+ * O(observers x delay window) and independent of the number of iterations.
+ *
+ * Every processor accumulates the contributions of the elements it samples
+ * (see FWHSurface3D and FWHSurface2D); at the end of a time step the
+ * observer samples which cannot receive any further contribution are
+ * summed over all processors and written by the main processor.
+ */
+
+#ifndef FWH_INTEGRATOR_H
+#define FWH_INTEGRATOR_H
+
+#include "core/globalDefs.h"
+#include "core/array.h"
+#include "parallelism/mpiManager.h"
+#include "io/parallelIO.h"
+#include <vector>
+#include <string>
+#include <cmath>
+#include <iomanip>
+
+namespace plb_acoustics{
+
+	using namespace plb;
+
+	template<typename T>
+	class FWHIntegrator{
+	public:
+		/* observers and elements are in lattice units; cs is the speed of
+		sound and rho0 the reference density.*/
+		FWHIntegrator(std::vector<Array<T,3> > const& observers_, T rho0_, T cs_,
+		  std::string file_name)
+			: observers(observers_),
+			  rho0(rho0_), cs(cs_),
+			  started(false),
+			  iteration(0),
+			  window(0),
+			  first_delay(0),
+			  file(file_name.c_str())
+		{ }
+
+		// Adds a surface element; must be called before start()
+		plint addElement(Array<T,3> const& position, Array<T,3> const& normal, T area){
+			PLB_ASSERT( !started );
+			positions.push_back(position);
+			normals.push_back(normal);
+			areas.push_back(area);
+			return (plint) positions.size() - 1;
+		}
+
+		/* Allocates the observer ring buffers. The delay window is the spread
+		between the shortest and the longest propagation time over all
+		element/observer pairs. The distances are not stored: a table would
+		take elements x observers values on every processor, while accumulate()
+		recomputes them for the elements it samples only, at the cost of a
+		square root per pair and per time step.*/
+		void start(){
+			PLB_ASSERT( !started && !positions.empty() && !observers.empty() );
+			pluint num_elements = positions.size();
+			pluint num_observers = observers.size();
+			T r_min = T(), r_max = T();
+			for(pluint iE = 0; iE < num_elements; ++iE){
+				for(pluint iO = 0; iO < num_observers; ++iO){
+					Array<T,3> d = observers[iO] - positions[iE];
+					T r = std::sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+					PLB_ASSERT( r > T() );
+					if((iE == 0 && iO == 0) || r < r_min) r_min = r;
+					if((iE == 0 && iO == 0) || r > r_max) r_max = r;
+				}
+			}
+			first_delay = (plint) std::floor(r_min/cs);
+			window = (plint) std::ceil((r_max - r_min)/cs) + 6;
+			buffer.assign(window*num_observers, T());
+			previous_q.assign(num_elements, T());
+			previous_l.assign(num_elements, Array<T,3>((T)0, (T)0, (T)0));
+			has_previous.assign(num_elements, false);
+			started = true;
+		}
+
+		/* Contribution of element iElement at the current iteration; to be
+		called once per time step, by the processor which samples it.*/
+		void accumulate(plint iElement, T rho, Array<T,3> const& u){
+			PLB_ASSERT( started );
+			Array<T,3> const& n = normals[iElement];
+			T u_n = u[0]*n[0] + u[1]*n[1] + u[2]*n[2];
+			T p = cs*cs*(rho - rho0);
+			T q = rho*u_n;
+			Array<T,3> l;
+			for(plint iD = 0; iD < 3; ++iD){
+				l[iD] = p*n[iD] + rho*u[iD]*u_n;
+			}
+			if(has_previous[iElement]){
+				// Centered in time between the previous and current iteration.
+				T q_dot = q - previous_q[iElement];
+				Array<T,3> l_dot = l - previous_l[iElement];
+				Array<T,3> l_mid = (T)0.5*(l + previous_l[iElement]);
+				T emission_time = (T) iteration - (T)0.5;
+				T factor = areas[iElement]/((T)4*std::acos((T)-1));
+				pluint num_observers = observers.size();
+				for(pluint iO = 0; iO < num_observers; ++iO){
+					Array<T,3> d = observers[iO] - positions[iElement];
+					T r = std::sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+					Array<T,3> r_hat = d/r;
+					T l_dot_r = l_dot[0]*r_hat[0] + l_dot[1]*r_hat[1] + l_dot[2]*r_hat[2];
+					T l_r = l_mid[0]*r_hat[0] + l_mid[1]*r_hat[1] + l_mid[2]*r_hat[2];
+					T value = factor*(q_dot/r + l_dot_r/(cs*r) + l_r/(r*r));
+					deposit(iO, emission_time + r/cs, value);
+				}
+			}
+			previous_q[iElement] = q;
+			previous_l[iElement] = l;
+			has_previous[iElement] = true;
+		}
+
+		/* Ends the current time step: the observer sample which is now
+		complete is reduced over all processors and written as a line
+		"time p'_1 ... p'_N".*/
+		void finishStep(){
+			PLB_ASSERT( started );
+			pluint num_observers = observers.size();
+			// No contribution emitted from the next iteration on can reach
+			// an observer time lower than iteration + 1/2 + r_min/cs - 1.
+			plint complete_time = iteration + first_delay - 2;
+			if(complete_time >= 0){
+				plint slot = complete_time % window;
+				std::vector<T> local(num_observers), global(num_observers);
+				for(pluint iO = 0; iO < num_observers; ++iO){
+					local[iO] = buffer[slot*num_observers + iO];
+					buffer[slot*num_observers + iO] = T();
+				}
+#ifdef PLB_MPI_PARALLEL
+				global::mpi().reduceVect(local, global, MPI_SUM);
+#else
+				global = local;
+#endif
+				file << std::setprecision(10) << complete_time;
+				for(pluint iO = 0; iO < num_observers; ++iO){
+					file << " " << global[iO];
+				}
+				file << '\n';
+			}
+			++iteration;
+		}
+
+		plint getNumElements() const{
+			return (plint) positions.size();
+		}
+
+		Array<T,3> const& getPosition(plint iElement) const{
+			return positions[iElement];
+		}
+
+	private:
+		FWHIntegrator(FWHIntegrator<T> const& rhs);
+		FWHIntegrator<T>& operator=(FWHIntegrator<T> const& rhs);
+
+		// Linear interpolation of a contribution onto the integer observer times.
+		void deposit(pluint iObserver, T time, T value){
+			plint t0 = (plint) std::floor(time);
+			T weight = time - (T) t0;
+			pluint num_observers = observers.size();
+			buffer[(t0 % window)*num_observers + iObserver] += ((T)1 - weight)*value;
+			buffer[((t0+1) % window)*num_observers + iObserver] += weight*value;
+		}
+
+	private:
+		std::vector<Array<T,3> > observers;
+		T rho0, cs;
+		bool started;
+		plint iteration;
+		plint window;
+		plint first_delay;
+		std::vector<Array<T,3> > positions;
+		std::vector<Array<T,3> > normals;
+		std::vector<T> areas;
+		std::vector<T> buffer;
+		std::vector<T> previous_q;
+		std::vector<Array<T,3> > previous_l;
+		std::vector<bool> has_previous;
+		plb_ofstream file;
+	};
+
+}
+
+#endif  // FWH_INTEGRATOR_H
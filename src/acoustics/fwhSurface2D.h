@@ -0,0 +1,240 @@
+/* Parallel Ffowcs Williams-Hawkings surface for 2D lattices.
+ *
+ * The 2D contour is extruded in the spanwise direction over [-span, span],
+ * with the 2D field taken as uniform along the span, and integrated with
+ * the 3D formulation of FWHIntegrator. This is not the 2D formulation: the
+ * 2D Green's function is the 3D one integrated over an infinite span, and
+ * its tail is truncated here at the time sqrt(r^2+span^2)/cs at which the
+ * signal of the ends of the span reaches the observer. For a harmonic source
+ * of wavenumber k at distance r the missing part is the contribution of the
+ * ends, of relative amplitude about sqrt(2r/(pi k))/span, i.e. of order
+ * 1/(minSpanRatio sqrt(k r)) at the smallest allowed span; it does not decay
+ * in time and appears as a spurious oscillation at the frequency of the
+ * source. Steady (k -> 0) components are not reproduced at all, since the
+ * 2D Green's function has no finite-span limit for them.
+ *
+ * FWHSurface2D::start() asserts that span is at least minSpanRatio times the
+ * largest distance between the contour and an observer, and the constructor
+ * that the spanwise elements are not longer than one lattice cell
+ * (num_span >= 2 span), as the in-plane sampling. The number of elements,
+ * hence the cost of a time step, is then at least 2 minSpanRatio r_max per
+ * contour point, and the delay window, hence the memory per observer, grows
+ * with the span.
+ */
+
+#ifndef FWH_SURFACE_2D_H
+#define FWH_SURFACE_2D_H
+
+#include "palabos2D.h"
+#ifndef PLB_PRECOMPILED // Unless precompiled version is used,
+#include "palabos2D.hh"   // include full template code
+#endif
+#include "acoustics/fwhIntegrator.h"
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <string>
+#include <cmath>
+
+namespace plb_acoustics_2D{
+
+	using namespace plb;
+	using plb_acoustics::FWHIntegrator;
+
+	/* Samples the contour points located in the local blocks; each point
+	feeds all of its spanwise elements. The points are bucketed by atomic
+	block beforehand, as in FWHSamplingFunctional3D.*/
+	template<typename T, template<typename U> class Descriptor>
+	class FWHSamplingFunctional2D : public BoxProcessingFunctional2D_L<T,Descriptor>{
+	public:
+		FWHSamplingFunctional2D(FWHIntegrator<T>* integrator_,
+		  std::vector<Dot2D> const* sample_cells_,
+		  std::map<Dot2D, std::vector<plint> > const* buckets_, plint num_span_)
+			: integrator(integrator_),
+			  sample_cells(sample_cells_),
+			  buckets(buckets_),
+			  num_span(num_span_)
+		{ }
+
+		virtual void process(Box2D domain, BlockLattice2D<T,Descriptor>& lattice){
+			Dot2D offset = lattice.getLocation();
+			typename std::map<Dot2D, std::vector<plint> >::const_iterator it = buckets->find(offset);
+			if(it == buckets->end()){
+				return;
+			}
+			std::vector<plint> const& bucket = it->second;
+			Box2D absoluteDomain = domain.shift(offset.x, offset.y);
+			for(pluint iBucket = 0; iBucket < bucket.size(); ++iBucket){
+				plint iPoint = bucket[iBucket];
+				Dot2D const& cell_position = (*sample_cells)[iPoint];
+				if(!contained(cell_position.x, cell_position.y, absoluteDomain)){
+					continue;
+				}
+				Cell<T,Descriptor> const& cell = lattice.get(cell_position.x - offset.x,
+				  cell_position.y - offset.y);
+				Array<T,2> velocity;
+				cell.computeVelocity(velocity);
+				T rho = cell.computeDensity();
+				Array<T,3> velocity3D(velocity[0], velocity[1], (T)0);
+				for(plint iSpan = 0; iSpan < num_span; ++iSpan){
+					integrator->accumulate(iPoint*num_span + iSpan, rho, velocity3D);
+				}
+			}
+		}
+
+		virtual FWHSamplingFunctional2D<T,Descriptor>* clone() const{
+			return new FWHSamplingFunctional2D<T,Descriptor>(*this);
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::nothing;
+		}
+
+	private:
+		FWHIntegrator<T>* integrator;
+		std::vector<Dot2D> const* sample_cells;
+		std::map<Dot2D, std::vector<plint> > const* buckets;
+		plint num_span;
+	};
+
+	template<typename T, template<typename U> class Descriptor>
+	class FWHSurface2D{
+	public:
+		// Lower bound of span over the largest contour to observer distance
+		static const plint minSpanRatio = 10;
+
+		/* The contour is extruded over [-span, span] with num_span elements,
+		at most one cell long. Observer signals are written to file_name, one
+		line per time step.*/
+		FWHSurface2D(std::vector<Array<T,2> > const& observers_, T rho0, T cs,
+		  T span_, plint num_span_, std::string file_name)
+			: integrator(toObservers3D(observers_), rho0, cs, file_name),
+			  observers(observers_),
+			  span(span_),
+			  num_span(num_span_),
+			  bucketed(false)
+		{
+			PLB_ASSERT( num_span > 0 && span > T() );
+			PLB_ASSERT( (T)num_span >= (T)2*span );
+		}
+
+		// Closed rectangular contour along the border of a box
+		void addRectangleContour(Box2D box){
+			plint lower[2] = { box.x0, box.y0 };
+			plint upper[2] = { box.x1, box.y1 };
+			for(plint axis = 0; axis < 2; ++axis){
+				plint other = 1 - axis;
+				for(plint side = 0; side < 2; ++side){
+					Array<T,2> normal((T)0, (T)0);
+					normal[axis] = side == 0 ? (T)-1 : (T)1;
+					for(plint i = lower[other]; i <= upper[other]; ++i){
+						plint cell[2];
+						cell[axis] = side == 0 ? lower[axis] : upper[axis];
+						cell[other] = i;
+						T length = (i == lower[other] || i == upper[other]) ? (T)0.5 : (T)1;
+						addPoint(Array<T,2>((T) cell[0], (T) cell[1]), normal, length);
+					}
+				}
+			}
+		}
+
+		// Closed circular contour sampled on the nearest cells
+		void addCircleContour(Array<T,2> center, T radius, plint num_theta){
+			T d_theta = (T)2*std::acos((T)-1)/(T)num_theta;
+			for(plint iTheta = 0; iTheta < num_theta; ++iTheta){
+				T theta = (T)iTheta*d_theta;
+				Array<T,2> normal(std::cos(theta), std::sin(theta));
+				addPoint(center + radius*normal, normal, radius*d_theta);
+			}
+		}
+
+		// Point of a user-defined contour, with its outward normal and length
+		void addPoint(Array<T,2> position, Array<T,2> normal, T length){
+			T dz = (T)2*span/(T)num_span;
+			for(plint iSpan = 0; iSpan < num_span; ++iSpan){
+				T z = -span + ((T)iSpan + (T)0.5)*dz;
+				integrator.addElement(Array<T,3>(position[0], position[1], z),
+				  Array<T,3>(normal[0], normal[1], (T)0), length*dz);
+			}
+			sample_cells.push_back(Dot2D(util::roundToInt(position[0]),
+			  util::roundToInt(position[1])));
+			positions.push_back(position);
+		}
+
+		// Freezes the contour; no point can be added afterwards.
+		void start(){
+			T r_max = T();
+			for(pluint iPoint = 0; iPoint < positions.size(); ++iPoint){
+				for(pluint iO = 0; iO < observers.size(); ++iO){
+					Array<T,2> d = observers[iO] - positions[iPoint];
+					r_max = std::max(r_max, std::sqrt(d[0]*d[0] + d[1]*d[1]));
+				}
+			}
+			PLB_ASSERT( span >= (T)minSpanRatio*r_max );
+			integrator.start();
+			bounding_box = Box2D(sample_cells[0].x, sample_cells[0].x,
+			  sample_cells[0].y, sample_cells[0].y);
+			for(pluint iPoint = 1; iPoint < sample_cells.size(); ++iPoint){
+				Dot2D const& cell = sample_cells[iPoint];
+				bounding_box = bound(bounding_box, Box2D(cell.x, cell.x, cell.y, cell.y));
+			}
+		}
+
+		/* To be called once per iteration, after start(). The points are
+		assigned to the local blocks at the first call; the lattice must keep
+		the same distribution afterwards.*/
+		void sample(MultiBlockLattice2D<T,Descriptor>& lattice){
+			if(!bucketed){
+				bucketPoints(lattice);
+			}
+			applyProcessingFunctional(
+			  new FWHSamplingFunctional2D<T,Descriptor>(&integrator, &sample_cells, &buckets, num_span),
+			  bounding_box, lattice);
+			integrator.finishStep();
+		}
+
+	private:
+		FWHSurface2D(FWHSurface2D<T,Descriptor> const& rhs);
+		FWHSurface2D<T,Descriptor>& operator=(FWHSurface2D<T,Descriptor> const& rhs);
+
+		// Lists, for every local block, the points sampled in its bulk.
+		void bucketPoints(MultiBlockLattice2D<T,Descriptor>& lattice){
+			MultiBlockManagement2D const& management = lattice.getMultiBlockManagement();
+			std::vector<plint> const& blocks = management.getLocalInfo().getBlocks();
+			for(pluint iBlock = 0; iBlock < blocks.size(); ++iBlock){
+				plint blockId = blocks[iBlock];
+				Box2D bulk = management.getBulk(blockId);
+				std::vector<plint>& bucket = buckets[lattice.getComponent(blockId).getLocation()];
+				for(pluint iPoint = 0; iPoint < sample_cells.size(); ++iPoint){
+					Dot2D const& cell = sample_cells[iPoint];
+					if(contained(cell.x, cell.y, bulk)){
+						bucket.push_back((plint) iPoint);
+					}
+				}
+			}
+			bucketed = true;
+		}
+
+		static std::vector<Array<T,3> > toObservers3D(std::vector<Array<T,2> > const& observers){
+			std::vector<Array<T,3> > observers3D;
+			for(pluint iO = 0; iO < observers.size(); ++iO){
+				observers3D.push_back(Array<T,3>(observers[iO][0], observers[iO][1], (T)0));
+			}
+			return observers3D;
+		}
+
+	private:
+		FWHIntegrator<T> integrator;
+		std::vector<Array<T,2> > observers;
+		T span;
+		plint num_span;
+		std::vector<Dot2D> sample_cells;
+		std::vector<Array<T,2> > positions;
+		Box2D bounding_box;
+		std::map<Dot2D, std::vector<plint> > buckets;
+		bool bucketed;
+	};
+
+}
+
+#endif  // FWH_SURFACE_2D_H
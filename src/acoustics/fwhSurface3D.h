@@ -0,0 +1,247 @@
+/* Parallel Ffowcs Williams-Hawkings surface for 3D lattices.
+ *
+ * The surface is a set of elements (position, outward normal, area), each
+ * sampled on its nearest lattice cell. The elements are bucketed once by
+ * local block; a data processor then visits, on every processor, only the
+ * elements of its local blocks and hands density and velocity to the
+ * FWHIntegrator, which accumulates the far-field observer signals on the fly.
+ */
+
+#ifndef FWH_SURFACE_3D_H
+#define FWH_SURFACE_3D_H
+
+#include "palabos3D.h"
+#ifndef PLB_PRECOMPILED // Unless precompiled version is used,
+#include "palabos3D.hh"   // include full template code
+#endif
+#include "acoustics/fwhIntegrator.h"
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+
+namespace plb_acoustics_3D{
+
+	using namespace plb;
+	using plb_acoustics::FWHIntegrator;
+
+	/* Samples the surface elements located in the local blocks. The
+	integrator is owned by FWHSurface3D; every processor has its own. The
+	elements are bucketed by atomic block beforehand, and each block only
+	visits its own bucket, found from the location of the block.*/
+	template<typename T, template<typename U> class Descriptor>
+	class FWHSamplingFunctional3D : public BoxProcessingFunctional3D_L<T,Descriptor>{
+	public:
+		FWHSamplingFunctional3D(FWHIntegrator<T>* integrator_,
+		  std::vector<Dot3D> const* sample_cells_,
+		  std::map<Dot3D, std::vector<plint> > const* buckets_)
+			: integrator(integrator_),
+			  sample_cells(sample_cells_),
+			  buckets(buckets_)
+		{ }
+
+		virtual void process(Box3D domain, BlockLattice3D<T,Descriptor>& lattice){
+			Dot3D offset = lattice.getLocation();
+			typename std::map<Dot3D, std::vector<plint> >::const_iterator it = buckets->find(offset);
+			if(it == buckets->end()){
+				return;
+			}
+			std::vector<plint> const& bucket = it->second;
+			Box3D absoluteDomain = domain.shift(offset.x, offset.y, offset.z);
+			for(pluint iBucket = 0; iBucket < bucket.size(); ++iBucket){
+				plint iElement = bucket[iBucket];
+				Dot3D const& cell_position = (*sample_cells)[iElement];
+				if(!contained(cell_position.x, cell_position.y, cell_position.z, absoluteDomain)){
+					continue;
+				}
+				Cell<T,Descriptor> const& cell = lattice.get(cell_position.x - offset.x,
+				  cell_position.y - offset.y, cell_position.z - offset.z);
+				Array<T,3> velocity;
+				cell.computeVelocity(velocity);
+				integrator->accumulate(iElement, cell.computeDensity(), velocity);
+			}
+		}
+
+		virtual FWHSamplingFunctional3D<T,Descriptor>* clone() const{
+			return new FWHSamplingFunctional3D<T,Descriptor>(*this);
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::nothing;
+		}
+
+		// All blocks accumulate into the same integrator.
+		virtual bool isBlockLocal() const{
+			return false;
+		}
+
+	private:
+		FWHIntegrator<T>* integrator;
+		std::vector<Dot3D> const* sample_cells;
+		std::map<Dot3D, std::vector<plint> > const* buckets;
+	};
+
+	template<typename T, template<typename U> class Descriptor>
+	class FWHSurface3D{
+	public:
+		/* Observer signals are written to file_name, one line per time
+		step: observer time followed by the acoustic pressure of every
+		observer.*/
+		FWHSurface3D(std::vector<Array<T,3> > const& observers, T rho0, T cs,
+		  std::string file_name)
+			: integrator(observers, rho0, cs, file_name),
+			  bucketed(false)
+		{ }
+
+		/* Closed surface made of the six faces of a box. Trapezoidal
+		weights are used on the edges and corners of every face.*/
+		void addBoxSurface(Box3D box){
+			plint lower[3] = { box.x0, box.y0, box.z0 };
+			plint upper[3] = { box.x1, box.y1, box.z1 };
+			for(plint axis = 0; axis < 3; ++axis){
+				plint axis1 = (axis + 1) % 3;
+				plint axis2 = (axis + 2) % 3;
+				for(plint side = 0; side < 2; ++side){
+					Array<T,3> normal((T)0, (T)0, (T)0);
+					normal[axis] = side == 0 ? (T)-1 : (T)1;
+					for(plint i1 = lower[axis1]; i1 <= upper[axis1]; ++i1){
+						for(plint i2 = lower[axis2]; i2 <= upper[axis2]; ++i2){
+							plint cell[3];
+							cell[axis] = side == 0 ? lower[axis] : upper[axis];
+							cell[axis1] = i1;
+							cell[axis2] = i2;
+							T area = trapezoidWeight(i1, lower[axis1], upper[axis1])
+							       * trapezoidWeight(i2, lower[axis2], upper[axis2]);
+							addElement(Dot3D(cell[0], cell[1], cell[2]), normal, area);
+						}
+					}
+				}
+			}
+		}
+
+		/* Closed cylinder of given radius, with its axis along x (0), y (1)
+		or z (2), starting at base_center and extending over length cells.
+		The lateral surface is discretized with num_theta points per section,
+		sampled on the nearest cell; the caps use the cells inside the radius.*/
+		void addCylinderSurface(Array<T,3> base_center, plint axis, T radius,
+		  plint length, plint num_theta){
+			PLB_ASSERT( axis >= 0 && axis < 3 && length > 0 && num_theta > 0 );
+			plint axis1 = (axis + 1) % 3;
+			plint axis2 = (axis + 2) % 3;
+			T pi = std::acos((T)-1);
+			T d_theta = (T)2*pi/(T)num_theta;
+			// Lateral surface
+			for(plint iA = 0; iA <= length; ++iA){
+				T weight = trapezoidWeight(iA, 0, length);
+				for(plint iTheta = 0; iTheta < num_theta; ++iTheta){
+					T theta = (T)iTheta*d_theta;
+					Array<T,3> normal((T)0, (T)0, (T)0);
+					normal[axis1] = std::cos(theta);
+					normal[axis2] = std::sin(theta);
+					Array<T,3> position = base_center + radius*normal;
+					position[axis] += (T) iA;
+					addElement(position, normal, radius*d_theta*weight);
+				}
+			}
+			// Caps
+			plint extent = (plint) std::ceil(radius);
+			for(plint side = 0; side < 2; ++side){
+				Array<T,3> normal((T)0, (T)0, (T)0);
+				normal[axis] = side == 0 ? (T)-1 : (T)1;
+				for(plint i1 = -extent; i1 <= extent; ++i1){
+					for(plint i2 = -extent; i2 <= extent; ++i2){
+						Array<T,3> position = base_center;
+						position[axis1] = util::roundToInt(base_center[axis1]) + (T) i1;
+						position[axis2] = util::roundToInt(base_center[axis2]) + (T) i2;
+						position[axis] += side == 0 ? (T)0 : (T) length;
+						T d1 = position[axis1] - base_center[axis1];
+						T d2 = position[axis2] - base_center[axis2];
+						if(d1*d1 + d2*d2 <= radius*radius){
+							addElement(position, normal, (T)1);
+						}
+					}
+				}
+			}
+		}
+
+		// Element of a user-defined surface
+		void addElement(Array<T,3> position, Array<T,3> normal, T area){
+			addElement(Dot3D(util::roundToInt(position[0]), util::roundToInt(position[1]),
+			  util::roundToInt(position[2])), position, normal, area);
+		}
+
+		// Freezes the surface; no element can be added afterwards.
+		void start(){
+			integrator.start();
+			bounding_box = Box3D(sample_cells[0].x, sample_cells[0].x,
+			  sample_cells[0].y, sample_cells[0].y, sample_cells[0].z, sample_cells[0].z);
+			for(pluint iElement = 1; iElement < sample_cells.size(); ++iElement){
+				Dot3D const& cell = sample_cells[iElement];
+				bounding_box = bound(bounding_box, Box3D(cell.x, cell.x, cell.y, cell.y, cell.z, cell.z));
+			}
+		}
+
+		/* To be called once per iteration, after start(). The elements are
+		assigned to the local blocks at the first call; the lattice must keep
+		the same distribution afterwards.*/
+		void sample(MultiBlockLattice3D<T,Descriptor>& lattice){
+			if(!bucketed){
+				bucketElements(lattice);
+			}
+			applyProcessingFunctional(
+			  new FWHSamplingFunctional3D<T,Descriptor>(&integrator, &sample_cells, &buckets),
+			  bounding_box, lattice);
+			integrator.finishStep();
+		}
+
+		plint getNumElements() const{
+			return (plint) sample_cells.size();
+		}
+
+	private:
+		FWHSurface3D(FWHSurface3D<T,Descriptor> const& rhs);
+		FWHSurface3D<T,Descriptor>& operator=(FWHSurface3D<T,Descriptor> const& rhs);
+
+		void addElement(Dot3D cell, Array<T,3> normal, T area){
+			addElement(cell, Array<T,3>((T) cell.x, (T) cell.y, (T) cell.z), normal, area);
+		}
+
+		void addElement(Dot3D cell, Array<T,3> position, Array<T,3> normal, T area){
+			integrator.addElement(position, normal, area);
+			sample_cells.push_back(cell);
+		}
+
+		// Lists, for every local block, the elements sampled in its bulk.
+		void bucketElements(MultiBlockLattice3D<T,Descriptor>& lattice){
+			MultiBlockManagement3D const& management = lattice.getMultiBlockManagement();
+			std::vector<plint> const& blocks = management.getLocalInfo().getBlocks();
+			for(pluint iBlock = 0; iBlock < blocks.size(); ++iBlock){
+				plint blockId = blocks[iBlock];
+				Box3D bulk = management.getBulk(blockId);
+				std::vector<plint>& bucket = buckets[lattice.getComponent(blockId).getLocation()];
+				for(pluint iElement = 0; iElement < sample_cells.size(); ++iElement){
+					Dot3D const& cell = sample_cells[iElement];
+					if(contained(cell.x, cell.y, cell.z, bulk)){
+						bucket.push_back((plint) iElement);
+					}
+				}
+			}
+			bucketed = true;
+		}
+
+		static T trapezoidWeight(plint i, plint i0, plint i1){
+			if(i0 == i1) return (T)1;
+			return (i == i0 || i == i1) ? (T)0.5 : (T)1;
+		}
+
+	private:
+		FWHIntegrator<T> integrator;
+		std::vector<Dot3D> sample_cells;
+		Box3D bounding_box;
+		std::map<Dot3D, std::vector<plint> > buckets;
+		bool bucketed;
+	};
+
+}
+
+#endif  // FWH_SURFACE_3D_H
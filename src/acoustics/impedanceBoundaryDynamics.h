@@ -0,0 +1,235 @@
+/* Boundary dynamics of an impedance wall.
+ *
+ * ImpedanceBoundaryDynamics is a regularized velocity condition on a
+ * straight wall whose velocity is given by a time-domain ImpedanceModel
+ * instead of being imposed. With n the outward normal of the wall, the
+ * populations which arrived from the fluid give K = rhoBar + j.n, the
+ * incoming characteristic, and the velocity condition closes the cell with
+ * rhoBar = K - v for a wall velocity v. The normalized pressure on the wall
+ * is cs*rhoBar, which the model sets to a*v + h; hence
+ * v = (cs*K - h)/(a + cs), with which the model is advanced.
+ *
+ * ImpedanceBounceBack is the same wall on the voxelized bounce-back walls
+ * of the examples: it replaces BounceBack in the solid cells which face the
+ * fluid, and reflects the populations as a wall moving with the velocity v
+ * along n (Ladd). Of the populations which arrived from the fluid, with
+ * sum I, the wall returns I - v; the normalized pressure is then
+ * (2*I - v)/cs, which the model sets to a*v + h, and
+ * v = (2*I - cs*h)/(cs*a + 1).
+ *
+ * The model is local to the cell and updated at every collision: the wall
+ * needs no data processor, and the copies of a cell in the envelope of
+ * other blocks see the same populations and evolve in the same way. The
+ * model is serialized with the dynamics, so that the copies regenerated
+ * when the data structure of the lattice is transferred keep their model
+ * and its state.
+ */
+
+#ifndef IMPEDANCE_BOUNDARY_DYNAMICS_H
+#define IMPEDANCE_BOUNDARY_DYNAMICS_H
+
+#include "core/globalDefs.h"
+#include "core/util.h"
+#include "core/dynamicsIdentifiers.h"
+#include "core/dynamics.h"
+#include "boundaryCondition/regularizedBoundaryDynamics.h"
+#include "acoustics/impedanceModel.h"
+#include <cmath>
+#include <string>
+
+namespace plb_acoustics{
+
+	using namespace plb;
+
+	template<typename T, template<typename U> class Descriptor, int direction, int orientation>
+	class ImpedanceBoundaryDynamics
+	  : public RegularizedVelocityBoundaryDynamics<T,Descriptor,direction,orientation>{
+	public:
+		typedef RegularizedVelocityBoundaryDynamics<T,Descriptor,direction,orientation> BoundaryDynamicsT;
+
+		// The dynamics takes ownership of the model.
+		ImpedanceBoundaryDynamics(Dynamics<T,Descriptor>* baseDynamics_, ImpedanceModel<T>* model_,
+		  bool automaticPrepareCollision_ = true)
+			: BoundaryDynamicsT(baseDynamics_, automaticPrepareCollision_), model(model_)
+		{ }
+
+		ImpedanceBoundaryDynamics(HierarchicUnserializer& unserializer)
+			: BoundaryDynamicsT(0, false), model(0)
+		{
+			unserialize(unserializer);
+		}
+
+		ImpedanceBoundaryDynamics(ImpedanceBoundaryDynamics<T,Descriptor,direction,orientation> const& rhs)
+			: BoundaryDynamicsT(rhs), model(rhs.model ? rhs.model->clone() : 0)
+		{ }
+
+		ImpedanceBoundaryDynamics<T,Descriptor,direction,orientation>& operator=(
+		  ImpedanceBoundaryDynamics<T,Descriptor,direction,orientation> const& rhs){
+			BoundaryDynamicsT::operator=(rhs);
+			ImpedanceModel<T> *copy = rhs.model ? rhs.model->clone() : 0;
+			delete model;
+			model = copy;
+			return *this;
+		}
+
+		~ImpedanceBoundaryDynamics(){
+			delete model;
+		}
+
+		virtual ImpedanceBoundaryDynamics<T,Descriptor,direction,orientation>* clone() const{
+			return new ImpedanceBoundaryDynamics<T,Descriptor,direction,orientation>(*this);
+		}
+
+		virtual int getId() const{
+			return id;
+		}
+
+		// As for the other composite dynamics, the own values come before
+		// those of the boundary and base dynamics.
+		virtual void serialize(HierarchicSerializer& serializer) const{
+			serializer.addValue(model ? model->getModelId() : 0);
+			if(model){
+				model->serialize(serializer);
+			}
+			BoundaryDynamicsT::serialize(serializer);
+		}
+
+		virtual void unserialize(HierarchicUnserializer& unserializer){
+			int modelId = unserializer.readValue<int>();
+			delete model;
+			model = modelId ? generateImpedanceModel<T>(modelId, unserializer) : 0;
+			BoundaryDynamicsT::unserialize(unserializer);
+		}
+
+		// Sets the velocity of the wall from the model, then completes the cell.
+		virtual void prepareCollision(Cell<T,Descriptor>& cell){
+			if(model){
+				T incoming = T();
+				for(plint iPop = 0; iPop < Descriptor<T>::q; ++iPop){
+					plint c_n = orientation*Descriptor<T>::c[iPop][direction];
+					if(c_n == 0) incoming += cell[iPop];
+					else if(c_n > 0) incoming += (T)2*cell[iPop];
+				}
+				T cs = std::sqrt(Descriptor<T>::cs2);
+				T v = (cs*incoming - model->getHistory())/(model->getInstantaneous() + cs);
+				model->advance(v);
+				Array<T,Descriptor<T>::d> u;
+				u.resetToZero();
+				u[direction] = (T)orientation*v;
+				this->defineVelocity(cell, u);
+			}
+			BoundaryDynamicsT::prepareCollision(cell);
+		}
+
+		ImpedanceModel<T> const* getModel() const{
+			return model;
+		}
+
+	private:
+		ImpedanceModel<T> *model;
+		static int id;
+	};
+
+	template<typename T, template<typename U> class Descriptor, int direction, int orientation>
+	int ImpedanceBoundaryDynamics<T,Descriptor,direction,orientation>::id =
+		meta::registerGeneralDynamics<T,Descriptor, ImpedanceBoundaryDynamics<T,Descriptor,direction,orientation> >
+		  ( std::string("Boundary_Impedance_")+util::val2str(direction) +
+		    std::string("_")+util::val2str(orientation) );
+
+	/* Bounce-back of a solid cell whose face normal to direction, on the side
+	of -orientation, touches the fluid: (direction, orientation) is the
+	normal from the fluid into the wall.*/
+	template<typename T, template<typename U> class Descriptor, int direction, int orientation>
+	class ImpedanceBounceBack : public BounceBack<T,Descriptor>{
+	public:
+		// The dynamics takes ownership of the model.
+		ImpedanceBounceBack(ImpedanceModel<T>* model_)
+			: BounceBack<T,Descriptor>(), model(model_)
+		{ }
+
+		ImpedanceBounceBack(HierarchicUnserializer& unserializer)
+			: BounceBack<T,Descriptor>(), model(0)
+		{
+			unserialize(unserializer);
+		}
+
+		ImpedanceBounceBack(ImpedanceBounceBack<T,Descriptor,direction,orientation> const& rhs)
+			: BounceBack<T,Descriptor>(rhs), model(rhs.model ? rhs.model->clone() : 0)
+		{ }
+
+		ImpedanceBounceBack<T,Descriptor,direction,orientation>& operator=(
+		  ImpedanceBounceBack<T,Descriptor,direction,orientation> const& rhs){
+			BounceBack<T,Descriptor>::operator=(rhs);
+			ImpedanceModel<T> *copy = rhs.model ? rhs.model->clone() : 0;
+			delete model;
+			model = copy;
+			return *this;
+		}
+
+		~ImpedanceBounceBack(){
+			delete model;
+		}
+
+		virtual ImpedanceBounceBack<T,Descriptor,direction,orientation>* clone() const{
+			return new ImpedanceBounceBack<T,Descriptor,direction,orientation>(*this);
+		}
+
+		virtual int getId() const{
+			return id;
+		}
+
+		// Same layout as ImpedanceBoundaryDynamics: the model comes first.
+		virtual void serialize(HierarchicSerializer& serializer) const{
+			serializer.addValue(model ? model->getModelId() : 0);
+			if(model){
+				model->serialize(serializer);
+			}
+			BounceBack<T,Descriptor>::serialize(serializer);
+		}
+
+		virtual void unserialize(HierarchicUnserializer& unserializer){
+			int modelId = unserializer.readValue<int>();
+			delete model;
+			model = modelId ? generateImpedanceModel<T>(modelId, unserializer) : 0;
+			BounceBack<T,Descriptor>::unserialize(unserializer);
+		}
+
+		// Bounces the populations back, then lets them carry the velocity of the wall.
+		virtual void collide(Cell<T,Descriptor>& cell, BlockStatistics& statistics){
+			T incoming = T();
+			if(model){
+				for(plint iPop = 1; iPop < Descriptor<T>::q; ++iPop){
+					if(orientation*Descriptor<T>::c[iPop][direction] > 0) incoming += cell[iPop];
+				}
+			}
+			BounceBack<T,Descriptor>::collide(cell, statistics);
+			if(model){
+				T cs = std::sqrt(Descriptor<T>::cs2);
+				T v = ((T)2*incoming - cs*model->getHistory())/(cs*model->getInstantaneous() + (T)1);
+				model->advance(v);
+				for(plint iPop = 1; iPop < Descriptor<T>::q; ++iPop){
+					if(orientation*Descriptor<T>::c[iPop][direction] < 0){
+						cell[iPop] -= (T)2*Descriptor<T>::t[iPop]*v*Descriptor<T>::invCs2;
+					}
+				}
+			}
+		}
+
+		ImpedanceModel<T> const* getModel() const{
+			return model;
+		}
+
+	private:
+		ImpedanceModel<T> *model;
+		static int id;
+	};
+
+	template<typename T, template<typename U> class Descriptor, int direction, int orientation>
+	int ImpedanceBounceBack<T,Descriptor,direction,orientation>::id =
+		meta::registerGeneralDynamics<T,Descriptor, ImpedanceBounceBack<T,Descriptor,direction,orientation> >
+		  ( std::string("BounceBack_Impedance_")+util::val2str(direction) +
+		    std::string("_")+util::val2str(orientation) );
+
+}
+
+#endif  // IMPEDANCE_BOUNDARY_DYNAMICS_H
@@ -0,0 +1,282 @@
+/* Time-domain models of the acoustic impedance of a wall.
+ *
+ * An ImpedanceModel relates the pressure p on a wall to the normal velocity
+ * v into the wall, both normalized: p stands for p/(rho0*c0), so that the
+ * impedance is the specific impedance Z/(rho0*c0) (1 is anechoic). At every
+ * time step the pressure is the instantaneous part times the new velocity
+ * plus a history part, p = a*v + h, which lets the wall solve for v before
+ * advancing the model with it. Time is counted in time steps.
+ *
+ * The convention is exp(+i*omega*t): a mass has the impedance i*omega*m.
+ */
+
+#ifndef IMPEDANCE_MODEL_H
+#define IMPEDANCE_MODEL_H
+
+#include "core/globalDefs.h"
+#include "core/hierarchicSerializer.h"
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace plb_acoustics{
+
+	using namespace plb;
+
+	template<typename T>
+	class ImpedanceModel{
+	public:
+		virtual ~ImpedanceModel(){ }
+		// Coefficient a of the new velocity in p = a*v + h
+		virtual T getInstantaneous() const =0;
+		// Contribution h of the past velocities to the pressure
+		virtual T getHistory() const =0;
+		// Ends the time step with the velocity v
+		virtual void advance(T v) =0;
+		// Impedance of the model at the angular frequency omega (rad per step)
+		virtual std::complex<T> computeImpedance(T omega) const =0;
+		virtual ImpedanceModel<T>* clone() const =0;
+		// Identifies the class of the model in a serializer
+		virtual int getModelId() const =0;
+		// Parameters and state, so that a regenerated wall goes on unchanged
+		virtual void serialize(HierarchicSerializer& serializer) const =0;
+		virtual void unserialize(HierarchicUnserializer& unserializer) =0;
+	};
+
+	/* Extended Helmholtz resonator (Rienstra, 2006):
+	Z = R + i*omega*m - i*beta*cot(omega*nu/2 - i*epsilon/2), with nu the
+	round trip time of the waves in the cavity, rounded to whole time steps.
+	With D the delay by nu and rho = exp(-epsilon), the last term is
+	beta*(1 + rho*D)/(1 - rho*D): its part w of the pressure follows
+	w(t) = rho*w(t - nu) + beta*(v(t) + rho*v(t - nu)), and the model keeps
+	the last nu values of v and w. The mass term is discretized by
+	m*(v(t) - v(t - 1)).*/
+	template<typename T>
+	class ExtendedHelmholtzResonator : public ImpedanceModel<T>{
+	public:
+		static const int modelId = 1;
+
+		ExtendedHelmholtzResonator(T resistance_, T mass_, T beta_, T nu, T epsilon)
+			: resistance(resistance_), mass(mass_), beta(beta_),
+			  delay(std::max((plint)1, (plint)(nu + (T)0.5))),
+			  rho(std::exp(-epsilon)),
+			  velocities(delay, T()), resonances(delay, T()), position(0)
+		{ }
+
+		explicit ExtendedHelmholtzResonator(HierarchicUnserializer& unserializer)
+			: resistance(T()), mass(T()), beta(T()), delay(1), rho(T()), position(0)
+		{
+			unserialize(unserializer);
+		}
+
+		virtual T getInstantaneous() const{
+			return resistance + mass + beta;
+		}
+
+		virtual T getHistory() const{
+			// The oldest entries of the buffers are nu steps old at the new time.
+			T previous_velocity = velocities[(position + delay - 1) % delay];
+			return -mass*previous_velocity
+			  + rho*resonances[position] + beta*rho*velocities[position];
+		}
+
+		virtual void advance(T v){
+			T w = rho*resonances[position] + beta*(v + rho*velocities[position]);
+			velocities[position] = v;
+			resonances[position] = w;
+			position = (position + 1) % delay;
+		}
+
+		virtual std::complex<T> computeImpedance(T omega) const{
+			std::complex<T> i((T)0, (T)1);
+			std::complex<T> delayed = rho*std::exp(-i*omega*(T)delay);
+			return resistance + i*omega*mass + beta*((T)1 + delayed)/((T)1 - delayed);
+		}
+
+		virtual ExtendedHelmholtzResonator<T>* clone() const{
+			return new ExtendedHelmholtzResonator<T>(*this);
+		}
+
+		virtual int getModelId() const{
+			return modelId;
+		}
+
+		virtual void serialize(HierarchicSerializer& serializer) const{
+			serializer.addValue(resistance);
+			serializer.addValue(mass);
+			serializer.addValue(beta);
+			serializer.addValue(delay);
+			serializer.addValue(rho);
+			serializer.addValues(velocities);
+			serializer.addValues(resonances);
+			serializer.addValue(position);
+		}
+
+		virtual void unserialize(HierarchicUnserializer& unserializer){
+			unserializer.readValue(resistance);
+			unserializer.readValue(mass);
+			unserializer.readValue(beta);
+			unserializer.readValue(delay);
+			unserializer.readValue(rho);
+			velocities.resize(delay);
+			resonances.resize(delay);
+			unserializer.readValues(velocities);
+			unserializer.readValues(resonances);
+			unserializer.readValue(position);
+		}
+
+	private:
+		T resistance, mass, beta;
+		plint delay;
+		T rho;
+		std::vector<T> velocities, resonances;
+		plint position;
+	};
+
+	/* Broadband impedance Z = R + i*omega*m + sum_k A_k/(lambda_k + i*omega),
+	a sum of real poles and of pairs of complex conjugate poles. Every pole
+	contributes a state w_k with dw_k/dt = -lambda_k*w_k + A_k*v, advanced
+	by recursive convolution with v constant over the time step:
+	w_k(t) = exp(-lambda_k)*w_k(t-1) + A_k*(1 - exp(-lambda_k))/lambda_k*v(t).
+	A pair contributes twice the real part of the state of one of its poles.
+	The poles must have a positive real part.*/
+	template<typename T>
+	class MultiPoleImpedance : public ImpedanceModel<T>{
+	public:
+		static const int modelId = 2;
+
+		MultiPoleImpedance(T resistance_, T mass_ = T())
+			: resistance(resistance_), mass(mass_), previous_velocity(T())
+		{ }
+
+		explicit MultiPoleImpedance(HierarchicUnserializer& unserializer)
+			: resistance(T()), mass(T()), previous_velocity(T())
+		{
+			unserialize(unserializer);
+		}
+
+		void addPole(T amplitude, T lambda){
+			addPole(std::complex<T>(amplitude), std::complex<T>(lambda), (T)1);
+		}
+
+		// Adds the pole lambda and its conjugate, with amplitudes A and conj(A).
+		void addPolePair(std::complex<T> amplitude, std::complex<T> lambda){
+			addPole(amplitude, lambda, (T)2);
+		}
+
+		virtual T getInstantaneous() const{
+			T a = resistance + mass;
+			for(pluint k = 0; k < poles.size(); ++k){
+				a += poles[k].multiplicity*std::real(poles[k].gain);
+			}
+			return a;
+		}
+
+		virtual T getHistory() const{
+			T h = -mass*previous_velocity;
+			for(pluint k = 0; k < poles.size(); ++k){
+				h += poles[k].multiplicity*std::real(poles[k].decay*poles[k].state);
+			}
+			return h;
+		}
+
+		virtual void advance(T v){
+			for(pluint k = 0; k < poles.size(); ++k){
+				poles[k].state = poles[k].decay*poles[k].state + poles[k].gain*v;
+			}
+			previous_velocity = v;
+		}
+
+		virtual std::complex<T> computeImpedance(T omega) const{
+			std::complex<T> i((T)0, (T)1);
+			std::complex<T> z = resistance + i*omega*mass;
+			for(pluint k = 0; k < poles.size(); ++k){
+				z += poles[k].amplitude/(poles[k].lambda + i*omega);
+				if(poles[k].multiplicity > (T)1){
+					z += std::conj(poles[k].amplitude)/(std::conj(poles[k].lambda) + i*omega);
+				}
+			}
+			return z;
+		}
+
+		virtual MultiPoleImpedance<T>* clone() const{
+			return new MultiPoleImpedance<T>(*this);
+		}
+
+		virtual int getModelId() const{
+			return modelId;
+		}
+
+		// Complex values are stored as their real and imaginary parts.
+		virtual void serialize(HierarchicSerializer& serializer) const{
+			serializer.addValue(resistance);
+			serializer.addValue(mass);
+			serializer.addValue(previous_velocity);
+			serializer.addValue((plint) poles.size());
+			for(pluint k = 0; k < poles.size(); ++k){
+				std::complex<T> const* values[5] = { &poles[k].amplitude, &poles[k].lambda,
+				  &poles[k].decay, &poles[k].gain, &poles[k].state };
+				for(int iValue = 0; iValue < 5; ++iValue){
+					serializer.addValue(std::real(*values[iValue]));
+					serializer.addValue(std::imag(*values[iValue]));
+				}
+				serializer.addValue(poles[k].multiplicity);
+			}
+		}
+
+		virtual void unserialize(HierarchicUnserializer& unserializer){
+			unserializer.readValue(resistance);
+			unserializer.readValue(mass);
+			unserializer.readValue(previous_velocity);
+			poles.resize(unserializer.readValue<plint>());
+			for(pluint k = 0; k < poles.size(); ++k){
+				std::complex<T>* values[5] = { &poles[k].amplitude, &poles[k].lambda,
+				  &poles[k].decay, &poles[k].gain, &poles[k].state };
+				for(int iValue = 0; iValue < 5; ++iValue){
+					T real = unserializer.readValue<T>();
+					T imag = unserializer.readValue<T>();
+					*values[iValue] = std::complex<T>(real, imag);
+				}
+				unserializer.readValue(poles[k].multiplicity);
+			}
+		}
+
+	private:
+		struct Pole{
+			std::complex<T> amplitude, lambda, decay, gain, state;
+			T multiplicity;
+		};
+
+		void addPole(std::complex<T> amplitude, std::complex<T> lambda, T multiplicity){
+			PLB_ASSERT( std::real(lambda) > T() );
+			Pole pole;
+			pole.amplitude = amplitude;
+			pole.lambda = lambda;
+			pole.decay = std::exp(-lambda);
+			pole.gain = amplitude*((T)1 - pole.decay)/lambda;
+			pole.state = std::complex<T>();
+			pole.multiplicity = multiplicity;
+			poles.push_back(pole);
+		}
+
+		T resistance, mass;
+		T previous_velocity;
+		std::vector<Pole> poles;
+	};
+
+	// New model of the class modelId, read from the unserializer
+	template<typename T>
+	ImpedanceModel<T>* generateImpedanceModel(int modelId, HierarchicUnserializer& unserializer){
+		switch(modelId){
+			case ExtendedHelmholtzResonator<T>::modelId:
+				return new ExtendedHelmholtzResonator<T>(unserializer);
+			case MultiPoleImpedance<T>::modelId:
+				return new MultiPoleImpedance<T>(unserializer);
+		}
+		PLB_ASSERT( false );
+		return 0;
+	}
+
+}
+
+#endif  // IMPEDANCE_MODEL_H
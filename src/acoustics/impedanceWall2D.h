@@ -0,0 +1,145 @@
+/* Impedance walls on the faces of a box of a 2D lattice.
+ *
+ * An impedance wall replaces the resolved cavities of a liner by a
+ * time-domain ImpedanceModel in every cell of a face: the cells get an
+ * ImpedanceBoundaryDynamics on top of their dynamics, each with its own
+ * copy of the model. The dynamics are instantiated on bulk and envelope,
+ * and the wall needs no data processor.
+ *
+ * defineImpedanceBounceBack does the same on a face of a bounce-back
+ * obstacle, with an ImpedanceBounceBack in place of the BounceBack of the
+ * cells of the face.
+ */
+
+#ifndef IMPEDANCE_WALL_2D_H
+#define IMPEDANCE_WALL_2D_H
+
+#include "palabos2D.h"
+#ifndef PLB_PRECOMPILED // Unless precompiled version is used,
+#include "palabos2D.hh"   // include full template code
+#endif
+#include "acoustics/impedanceModel.h"
+#include "acoustics/impedanceBoundaryDynamics.h"
+#include "acoustics/anechoicLayer2D.h"
+#include <vector>
+#include <algorithm>
+
+namespace plb_acoustics_2D{
+
+	using namespace plb;
+	using plb_acoustics::ImpedanceModel;
+	using plb_acoustics::ExtendedHelmholtzResonator;
+	using plb_acoustics::MultiPoleImpedance;
+	using plb_acoustics::ImpedanceBoundaryDynamics;
+	using plb_acoustics::ImpedanceBounceBack;
+
+	/* Puts a copy of the prototype, an ImpedanceBoundaryDynamics, on top of
+	the dynamics of every cell of the domain.*/
+	template<typename T, template<typename U> class Descriptor>
+	class ImpedanceWallFunctional2D : public BoxProcessingFunctional2D_L<T,Descriptor>{
+	public:
+		ImpedanceWallFunctional2D(CompositeDynamics<T,Descriptor>* prototype_)
+			: prototype(prototype_)
+		{ }
+
+		ImpedanceWallFunctional2D(ImpedanceWallFunctional2D<T,Descriptor> const& rhs)
+			: prototype(rhs.prototype->clone())
+		{ }
+
+		ImpedanceWallFunctional2D<T,Descriptor>& operator=(ImpedanceWallFunctional2D<T,Descriptor> const& rhs){
+			ImpedanceWallFunctional2D<T,Descriptor>(rhs).swap(*this);
+			return *this;
+		}
+
+		~ImpedanceWallFunctional2D(){
+			delete prototype;
+		}
+
+		void swap(ImpedanceWallFunctional2D<T,Descriptor>& rhs){
+			std::swap(prototype, rhs.prototype);
+		}
+
+		virtual void process(Box2D domain, BlockLattice2D<T,Descriptor>& lattice){
+			for(plint iX = domain.x0; iX <= domain.x1; ++iX){
+				for(plint iY = domain.y0; iY <= domain.y1; ++iY){
+					lattice.attributeDynamics(iX, iY,
+					  cloneAndInsertAtTopDynamics(lattice.get(iX, iY).getDynamics(),
+					    prototype->clone()));
+				}
+			}
+		}
+
+		virtual ImpedanceWallFunctional2D<T,Descriptor>* clone() const{
+			return new ImpedanceWallFunctional2D<T,Descriptor>(*this);
+		}
+
+		virtual BlockDomain::DomainT appliesTo() const{
+			// Dynamics needs to be instantiated everywhere, including envelope.
+			return BlockDomain::bulkAndEnvelope;
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::dataStructure;
+		}
+
+	private:
+		CompositeDynamics<T,Descriptor> *prototype;
+	};
+
+	/* Impedance wall on the cells of a face of domain: right (1), bottom (2),
+	left (3) or top (4). Every cell gets a copy of the model, which is
+	deleted here. The wall leaves out the two corners of the face, which are
+	shared with the adjacent faces and belong to another condition, so that
+	walls on adjacent faces never stack on the same cells.*/
+	template<typename T, template<typename U> class Descriptor>
+	void defineImpedanceWall(MultiBlockLattice2D<T,Descriptor>& lattice, Box2D domain,
+	  plint face, ImpedanceModel<T>* model){
+		static const plint orientations[4] = { 1, -1, -1, 1 };
+		plint axis;
+		T outer;
+		Box2D wall = computeAnechoicSlab(domain, face, (T)1, axis, outer);
+		Array<plint,4> bounds = wall.to_plbArray();
+		plint tangent = 1 - axis;
+		++bounds[2*tangent];
+		--bounds[2*tangent+1];
+		wall.from_plbArray(bounds);
+		plint orientation = orientations[face-1];
+		CompositeDynamics<T,Descriptor> *prototype = 0;
+		NoDynamics<T,Descriptor> *noDynamics = new NoDynamics<T,Descriptor>;
+		switch(2*axis + (orientation > 0 ? 1 : 0)){
+			case 0: prototype = new ImpedanceBoundaryDynamics<T,Descriptor,0,-1>(noDynamics, model); break;
+			case 1: prototype = new ImpedanceBoundaryDynamics<T,Descriptor,0,1>(noDynamics, model); break;
+			case 2: prototype = new ImpedanceBoundaryDynamics<T,Descriptor,1,-1>(noDynamics, model); break;
+			case 3: prototype = new ImpedanceBoundaryDynamics<T,Descriptor,1,1>(noDynamics, model); break;
+		}
+		applyProcessingFunctional(
+		  new ImpedanceWallFunctional2D<T,Descriptor>(prototype), wall, lattice);
+	}
+
+	/* Impedance on the face of a bounce-back obstacle, the box solid, through
+	which it touches the fluid, with the face numbering of
+	defineImpedanceWall. The cells of the face, ends included, get an
+	ImpedanceBounceBack in place of their BounceBack, each with a copy of
+	the model, which is deleted here.*/
+	template<typename T, template<typename U> class Descriptor>
+	void defineImpedanceBounceBack(MultiBlockLattice2D<T,Descriptor>& lattice, Box2D solid,
+	  plint face, ImpedanceModel<T>* model){
+		static const plint orientations[4] = { 1, -1, -1, 1 };
+		plint axis;
+		T outer;
+		Box2D wall = computeAnechoicSlab(solid, face, (T)1, axis, outer);
+		// The normal from the fluid into the obstacle is the inward normal of the face.
+		plint orientation = -orientations[face-1];
+		Dynamics<T,Descriptor> *prototype = 0;
+		switch(2*axis + (orientation > 0 ? 1 : 0)){
+			case 0: prototype = new ImpedanceBounceBack<T,Descriptor,0,-1>(model); break;
+			case 1: prototype = new ImpedanceBounceBack<T,Descriptor,0,1>(model); break;
+			case 2: prototype = new ImpedanceBounceBack<T,Descriptor,1,-1>(model); break;
+			case 3: prototype = new ImpedanceBounceBack<T,Descriptor,1,1>(model); break;
+		}
+		defineDynamics(lattice, wall, prototype);
+	}
+
+}
+
+#endif  // IMPEDANCE_WALL_2D_H
@@ -0,0 +1,154 @@
+/* Impedance walls on the faces of a box of a 3D lattice.
+ *
+ * An impedance wall replaces the resolved cavities of a liner by a
+ * time-domain ImpedanceModel in every cell of a face: the cells get an
+ * ImpedanceBoundaryDynamics on top of their dynamics, each with its own
+ * copy of the model. The dynamics are instantiated on bulk and envelope,
+ * and the wall needs no data processor.
+ *
+ * defineImpedanceBounceBack does the same on a face of a bounce-back
+ * obstacle, with an ImpedanceBounceBack in place of the BounceBack of the
+ * cells of the face.
+ */
+
+#ifndef IMPEDANCE_WALL_3D_H
+#define IMPEDANCE_WALL_3D_H
+
+#include "palabos3D.h"
+#ifndef PLB_PRECOMPILED // Unless precompiled version is used,
+#include "palabos3D.hh"   // include full template code
+#endif
+#include "acoustics/impedanceModel.h"
+#include "acoustics/impedanceBoundaryDynamics.h"
+#include "acoustics/anechoicLayer3D.h"
+#include <vector>
+#include <algorithm>
+
+namespace plb_acoustics_3D{
+
+	using namespace plb;
+	using plb_acoustics::ImpedanceModel;
+	using plb_acoustics::ExtendedHelmholtzResonator;
+	using plb_acoustics::MultiPoleImpedance;
+	using plb_acoustics::ImpedanceBoundaryDynamics;
+	using plb_acoustics::ImpedanceBounceBack;
+
+	/* Puts a copy of the prototype, an ImpedanceBoundaryDynamics, on top of
+	the dynamics of every cell of the domain.*/
+	template<typename T, template<typename U> class Descriptor>
+	class ImpedanceWallFunctional3D : public BoxProcessingFunctional3D_L<T,Descriptor>{
+	public:
+		ImpedanceWallFunctional3D(CompositeDynamics<T,Descriptor>* prototype_)
+			: prototype(prototype_)
+		{ }
+
+		ImpedanceWallFunctional3D(ImpedanceWallFunctional3D<T,Descriptor> const& rhs)
+			: prototype(rhs.prototype->clone())
+		{ }
+
+		ImpedanceWallFunctional3D<T,Descriptor>& operator=(ImpedanceWallFunctional3D<T,Descriptor> const& rhs){
+			ImpedanceWallFunctional3D<T,Descriptor>(rhs).swap(*this);
+			return *this;
+		}
+
+		~ImpedanceWallFunctional3D(){
+			delete prototype;
+		}
+
+		void swap(ImpedanceWallFunctional3D<T,Descriptor>& rhs){
+			std::swap(prototype, rhs.prototype);
+		}
+
+		virtual void process(Box3D domain, BlockLattice3D<T,Descriptor>& lattice){
+			for(plint iX = domain.x0; iX <= domain.x1; ++iX){
+				for(plint iY = domain.y0; iY <= domain.y1; ++iY){
+					for(plint iZ = domain.z0; iZ <= domain.z1; ++iZ){
+						lattice.attributeDynamics(iX, iY, iZ,
+						  cloneAndInsertAtTopDynamics(lattice.get(iX, iY, iZ).getDynamics(),
+						    prototype->clone()));
+					}
+				}
+			}
+		}
+
+		virtual ImpedanceWallFunctional3D<T,Descriptor>* clone() const{
+			return new ImpedanceWallFunctional3D<T,Descriptor>(*this);
+		}
+
+		virtual BlockDomain::DomainT appliesTo() const{
+			// Dynamics needs to be instantiated everywhere, including envelope.
+			return BlockDomain::bulkAndEnvelope;
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::dataStructure;
+		}
+
+	private:
+		CompositeDynamics<T,Descriptor> *prototype;
+	};
+
+	/* Impedance wall on the cells of a face of domain, with the face
+	numbering of defineAnechoicLayer. Every cell gets a copy of the model,
+	which is deleted here. The wall leaves out the edges of the face, which
+	are shared with the adjacent faces and belong to another condition, so
+	that walls on adjacent faces never stack on the same cells.*/
+	template<typename T, template<typename U> class Descriptor>
+	void defineImpedanceWall(MultiBlockLattice3D<T,Descriptor>& lattice, Box3D domain,
+	  plint face, ImpedanceModel<T>* model){
+		static const plint orientations[6] = { 1, -1, -1, 1, 1, -1 };
+		plint axis;
+		T outer;
+		Box3D wall = computeAnechoicSlab(domain, face, (T)1, axis, outer);
+		Array<plint,6> bounds = wall.to_plbArray();
+		for(plint iD = 0; iD < 3; ++iD){
+			if(iD != axis){
+				++bounds[2*iD];
+				--bounds[2*iD+1];
+			}
+		}
+		wall.from_plbArray(bounds);
+		plint orientation = orientations[face-1];
+		CompositeDynamics<T,Descriptor> *prototype = 0;
+		NoDynamics<T,Descriptor> *noDynamics = new NoDynamics<T,Descriptor>;
+		switch(2*axis + (orientation > 0 ? 1 : 0)){
+			case 0: prototype = new ImpedanceBoundaryDynamics<T,Descriptor,0,-1>(noDynamics, model); break;
+			case 1: prototype = new ImpedanceBoundaryDynamics<T,Descriptor,0,1>(noDynamics, model); break;
+			case 2: prototype = new ImpedanceBoundaryDynamics<T,Descriptor,1,-1>(noDynamics, model); break;
+			case 3: prototype = new ImpedanceBoundaryDynamics<T,Descriptor,1,1>(noDynamics, model); break;
+			case 4: prototype = new ImpedanceBoundaryDynamics<T,Descriptor,2,-1>(noDynamics, model); break;
+			case 5: prototype = new ImpedanceBoundaryDynamics<T,Descriptor,2,1>(noDynamics, model); break;
+		}
+		applyProcessingFunctional(
+		  new ImpedanceWallFunctional3D<T,Descriptor>(prototype), wall, lattice);
+	}
+
+	/* Impedance on the face of a bounce-back obstacle, the box solid, through
+	which it touches the fluid, with the face numbering of
+	defineImpedanceWall. The cells of the face, ends included, get an
+	ImpedanceBounceBack in place of their BounceBack, each with a copy of
+	the model, which is deleted here.*/
+	template<typename T, template<typename U> class Descriptor>
+	void defineImpedanceBounceBack(MultiBlockLattice3D<T,Descriptor>& lattice, Box3D solid,
+	  plint face, ImpedanceModel<T>* model){
+		static const plint orientations[6] = { 1, -1, -1, 1, 1, -1 };
+		plint axis;
+		T outer;
+		Box3D wall = computeAnechoicSlab(solid, face, (T)1, axis, outer);
+		// The normal from the fluid into the obstacle is the inward normal of the face.
+		plint orientation = -orientations[face-1];
+		Dynamics<T,Descriptor> *prototype = 0;
+		switch(2*axis + (orientation > 0 ? 1 : 0)){
+			case 0: prototype = new ImpedanceBounceBack<T,Descriptor,0,-1>(model); break;
+			case 1: prototype = new ImpedanceBounceBack<T,Descriptor,0,1>(model); break;
+			case 2: prototype = new ImpedanceBounceBack<T,Descriptor,1,-1>(model); break;
+			case 3: prototype = new ImpedanceBounceBack<T,Descriptor,1,1>(model); break;
+			case 4: prototype = new ImpedanceBounceBack<T,Descriptor,2,-1>(model); break;
+			case 5: prototype = new ImpedanceBounceBack<T,Descriptor,2,1>(model); break;
+		}
+		defineDynamics(lattice, wall, prototype);
+	}
+
+}
+
+#endif  // IMPEDANCE_WALL_3D_H
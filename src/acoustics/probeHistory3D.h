@@ -0,0 +1,207 @@
+/* Buffered binary writer for probe time series.
+ *
+ * Samples are kept in memory and written by chunks of chunk_size time
+ * steps, without any text formatting. The file starts with a small header,
+ * followed by a sequence of chunks:
+ *
+ *   header: "PLBPROBE" | uint32 version | uint32 sizeof(T) | uint32 num_probes
+ *           | uint32 num_fields | double dt | string units
+ *           | for each field: string name
+ *           | for each probe: string name, int64 x0,x1,y0,y1,z0,z1
+ *   chunk:  uint32 num_samples | for each field, for each probe:
+ *           num_samples values of type T
+ *
+ * Strings are stored as a uint32 length followed by the characters. Inside
+ * a chunk the data is columnar, so that the history of one probe and one
+ * field is contiguous. Only the main processor writes.
+ */
+
+#ifndef PROBE_HISTORY_3D_H
+#define PROBE_HISTORY_3D_H
+
+#include "palabos3D.h"
+#include "acoustics/probeSet3D.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <stdint.h>
+
+namespace plb_acoustics_3D{
+
+	using namespace plb;
+
+	template<typename T>
+	class ProbeHistoryWriter3D{
+	public:
+		/* Fields written by default: pressure and the three velocity
+		components, as given by append(ProbeSet3D...).*/
+		ProbeHistoryWriter3D(std::string file_name,
+		  std::vector<std::string> const& probe_names_,
+		  std::vector<Box3D> const& probe_locations_,
+		  T dt_, std::string units_ = "lattice", plint chunk_size_ = 1024)
+			: probe_names(probe_names_),
+			  probe_locations(probe_locations_),
+			  dt(dt_), units(units_),
+			  chunk_size(chunk_size_),
+			  num_samples(0)
+		{
+			PLB_ASSERT( probe_names.size() == probe_locations.size() );
+			PLB_ASSERT( chunk_size > 0 );
+			field_names.push_back("pressure");
+			field_names.push_back("velocity_x");
+			field_names.push_back("velocity_y");
+			field_names.push_back("velocity_z");
+			open(file_name);
+		}
+
+		/* Same as above with user-defined fields; every call to append()
+		must then provide num_probes*num_fields values.*/
+		ProbeHistoryWriter3D(std::string file_name,
+		  std::vector<std::string> const& probe_names_,
+		  std::vector<Box3D> const& probe_locations_,
+		  std::vector<std::string> const& field_names_,
+		  T dt_, std::string units_ = "lattice", plint chunk_size_ = 1024)
+			: probe_names(probe_names_),
+			  probe_locations(probe_locations_),
+			  field_names(field_names_),
+			  dt(dt_), units(units_),
+			  chunk_size(chunk_size_),
+			  num_samples(0)
+		{
+			PLB_ASSERT( probe_names.size() == probe_locations.size() );
+			PLB_ASSERT( chunk_size > 0 );
+			open(file_name);
+		}
+
+		~ProbeHistoryWriter3D(){
+			flush();
+		}
+
+		/* Appends one time step, values ordered field by field and, inside
+		a field, probe by probe.*/
+		void append(std::vector<T> const& values){
+			PLB_ASSERT( values.size() == getNumProbes()*getNumFields() );
+			if(!global::mpi().isMainProcessor()){
+				return;
+			}
+			buffer.insert(buffer.end(), values.begin(), values.end());
+			++num_samples;
+			if(num_samples >= chunk_size){
+				flush();
+			}
+		}
+
+		// Appends the pressure and velocities of an already sampled ProbeSet3D
+		template<template<typename U> class Descriptor>
+		void append(ProbeSet3D<T,Descriptor> const& probes, T rho0, T cs2){
+			PLB_ASSERT( getNumFields() == 4 );
+			PLB_ASSERT( probes.getNumProbes() == (plint) getNumProbes() );
+			pluint num_probes = getNumProbes();
+			std::vector<T> values(4*num_probes);
+			for(pluint iProbe = 0; iProbe < num_probes; ++iProbe){
+				Array<T,3> const& velocity = probes.getVelocity(iProbe);
+				values[iProbe] = probes.getPressure(iProbe, rho0, cs2);
+				values[num_probes + iProbe] = velocity[0];
+				values[2*num_probes + iProbe] = velocity[1];
+				values[3*num_probes + iProbe] = velocity[2];
+			}
+			append(values);
+		}
+
+		/* Writes the buffered samples to disk; to be called at checkpoints.
+		It is called automatically every chunk_size samples.*/
+		void flush(){
+			if(!global::mpi().isMainProcessor() || num_samples == 0){
+				return;
+			}
+			pluint num_probes = getNumProbes();
+			pluint num_fields = getNumFields();
+			std::vector<T> columns(buffer.size());
+			// Transpose from one row per sample to one column per probe.
+			for(plint iSample = 0; iSample < num_samples; ++iSample){
+				for(pluint iValue = 0; iValue < num_probes*num_fields; ++iValue){
+					columns[iValue*num_samples + iSample] =
+					  buffer[iSample*num_probes*num_fields + iValue];
+				}
+			}
+			writeUint32((uint32_t) num_samples);
+			file.write((char const*) &columns[0], columns.size()*sizeof(T));
+			file.flush();
+			buffer.clear();
+			num_samples = 0;
+		}
+
+		pluint getNumProbes() const{
+			return probe_names.size();
+		}
+
+		pluint getNumFields() const{
+			return field_names.size();
+		}
+
+	private:
+		ProbeHistoryWriter3D(ProbeHistoryWriter3D<T> const& rhs);
+		ProbeHistoryWriter3D<T>& operator=(ProbeHistoryWriter3D<T> const& rhs);
+
+		// Collective: all processes throw if the main process cannot open the file.
+		void open(std::string const& file_name){
+			bool failed = false;
+			if(global::mpi().isMainProcessor()){
+				file.open(file_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+				failed = !file.is_open();
+			}
+			plbMainProcIOError(failed, "Could not open file " + file_name + " for the probe history.");
+			if(!global::mpi().isMainProcessor()){
+				return;
+			}
+			buffer.reserve(chunk_size*getNumProbes()*getNumFields());
+			writeHeader();
+		}
+
+		void writeHeader(){
+			file.write("PLBPROBE", 8);
+			writeUint32(1);
+			writeUint32((uint32_t) sizeof(T));
+			writeUint32((uint32_t) getNumProbes());
+			writeUint32((uint32_t) getNumFields());
+			double dt_double = (double) dt;
+			file.write((char const*) &dt_double, sizeof(double));
+			writeString(units);
+			for(pluint iField = 0; iField < getNumFields(); ++iField){
+				writeString(field_names[iField]);
+			}
+			for(pluint iProbe = 0; iProbe < getNumProbes(); ++iProbe){
+				writeString(probe_names[iProbe]);
+				Array<plint,6> box = probe_locations[iProbe].to_plbArray();
+				for(plint i = 0; i < 6; ++i){
+					int64_t coordinate = (int64_t) box[i];
+					file.write((char const*) &coordinate, sizeof(int64_t));
+				}
+			}
+			file.flush();
+		}
+
+		void writeUint32(uint32_t value){
+			file.write((char const*) &value, sizeof(uint32_t));
+		}
+
+		void writeString(std::string const& value){
+			writeUint32((uint32_t) value.size());
+			file.write(value.c_str(), value.size());
+		}
+
+	private:
+		std::vector<std::string> probe_names;
+		std::vector<Box3D> probe_locations;
+		std::vector<std::string> field_names;
+		T dt;
+		std::string units;
+		plint chunk_size;
+		plint num_samples;
+		std::vector<T> buffer;
+		std::ofstream file;
+	};
+
+}
+
+#endif  // PROBE_HISTORY_3D_H
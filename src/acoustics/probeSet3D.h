@@ -0,0 +1,166 @@
+/* Set of probes sampled together, with a single reduction per time step.
+ *
+ * Each probe is a Box3D over which density and velocity are averaged. All
+ * the probes are handled by one reductive data processor, applied on the
+ * bounding box of the probes, and their partial sums are gathered in one
+ * combined reduction, instead of one computeAverageDensity and three
+ * computeVelocityComponent calls per probe and per iteration.
+ */
+
+#ifndef PROBE_SET_3D_H
+#define PROBE_SET_3D_H
+
+#include "palabos3D.h"
+#ifndef PLB_PRECOMPILED // Unless precompiled version is used,
+#include "palabos3D.hh"   // include full template code
+#endif
+#include <vector>
+#include <string>
+
+namespace plb_acoustics_3D{
+
+	using namespace plb;
+
+	/* Reductive data processor which sums rhoBar and the three velocity
+	components over every probe box. Four sums are subscribed per probe,
+	in the order rhoBar, u_x, u_y, u_z.*/
+	template<typename T, template<typename U> class Descriptor>
+	class ProbeSetFunctional3D : public ReductiveBoxProcessingFunctional3D_L<T,Descriptor>{
+	public:
+		ProbeSetFunctional3D(std::vector<Box3D> const& locations_)
+			: locations(locations_)
+		{
+			sumIds.resize(4*locations.size());
+			for(pluint i = 0; i < sumIds.size(); ++i){
+				sumIds[i] = this->getStatistics().subscribeSum();
+			}
+		}
+
+		virtual void process(Box3D domain, BlockLattice3D<T,Descriptor>& lattice){
+			BlockStatistics& statistics = this->getStatistics();
+			Dot3D offset = lattice.getLocation();
+			// Work in absolute coordinates, since the probes are defined
+			// with respect to the multi-block.
+			Box3D absoluteDomain = domain.shift(offset.x, offset.y, offset.z);
+			for(pluint iProbe = 0; iProbe < locations.size(); ++iProbe){
+				Box3D inters;
+				if(!intersect(absoluteDomain, locations[iProbe], inters)){
+					continue;
+				}
+				inters = inters.shift(-offset.x, -offset.y, -offset.z);
+				T sumRhoBar = T();
+				Array<T,3> sumVelocity((T)0, (T)0, (T)0);
+				for(plint iX = inters.x0; iX <= inters.x1; ++iX){
+					for(plint iY = inters.y0; iY <= inters.y1; ++iY){
+						for(plint iZ = inters.z0; iZ <= inters.z1; ++iZ){
+							Cell<T,Descriptor> const& cell = lattice.get(iX,iY,iZ);
+							sumRhoBar += cell.getDynamics().computeRhoBar(cell);
+							Array<T,Descriptor<T>::d> velocity;
+							cell.computeVelocity(velocity);
+							sumVelocity[0] += velocity[0];
+							sumVelocity[1] += velocity[1];
+							sumVelocity[2] += velocity[2];
+						}
+					}
+				}
+				statistics.gatherSum(sumIds[4*iProbe], sumRhoBar);
+				statistics.gatherSum(sumIds[4*iProbe+1], sumVelocity[0]);
+				statistics.gatherSum(sumIds[4*iProbe+2], sumVelocity[1]);
+				statistics.gatherSum(sumIds[4*iProbe+3], sumVelocity[2]);
+			}
+		}
+
+		virtual ProbeSetFunctional3D<T,Descriptor>* clone() const{
+			return new ProbeSetFunctional3D<T,Descriptor>(*this);
+		}
+
+		virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const{
+			modified[0] = modif::nothing;
+		}
+
+		T getSumRhoBar(plint iProbe) const{
+			return this->getStatistics().getSum(sumIds[4*iProbe]);
+		}
+
+		T getSumVelocity(plint iProbe, plint iComponent) const{
+			return this->getStatistics().getSum(sumIds[4*iProbe+1+iComponent]);
+		}
+
+	private:
+		std::vector<Box3D> locations;
+		std::vector<plint> sumIds;
+	};
+
+	/* Registers N probe boxes once, then samples all of them with a single
+	data processor and a single reduction per call to sample().*/
+	template<typename T, template<typename U> class Descriptor>
+	class ProbeSet3D{
+	public:
+		ProbeSet3D() { }
+
+		// Returns the index of the new probe
+		plint addProbe(Box3D location, std::string name_probe = std::string()){
+			locations.push_back(location);
+			names.push_back(name_probe);
+			densities.push_back(T());
+			velocities.push_back(Array<T,3>((T)0, (T)0, (T)0));
+			if(locations.size() == 1){
+				boundingBox = location;
+			}
+			else{
+				boundingBox = bound(boundingBox, location);
+			}
+			return (plint) locations.size() - 1;
+		}
+
+		void sample(MultiBlockLattice3D<T,Descriptor>& lattice){
+			if(locations.empty()){
+				return;
+			}
+			ProbeSetFunctional3D<T,Descriptor> functional(locations);
+			applyProcessingFunctional(functional, boundingBox, lattice);
+			for(pluint iProbe = 0; iProbe < locations.size(); ++iProbe){
+				T nCells = (T) locations[iProbe].nCells();
+				densities[iProbe] = Descriptor<T>::fullRho(functional.getSumRhoBar(iProbe) / nCells);
+				for(plint iD = 0; iD < 3; ++iD){
+					velocities[iProbe][iD] = functional.getSumVelocity(iProbe, iD) / nCells;
+				}
+			}
+		}
+
+		plint getNumProbes() const{
+			return (plint) locations.size();
+		}
+
+		Box3D const& getLocation(plint iProbe) const{
+			return locations[iProbe];
+		}
+
+		std::string const& getName(plint iProbe) const{
+			return names[iProbe];
+		}
+
+		// Averages of the last call to sample()
+		T getDensity(plint iProbe) const{
+			return densities[iProbe];
+		}
+
+		T getPressure(plint iProbe, T rho0, T cs2) const{
+			return (densities[iProbe] - rho0)*cs2;
+		}
+
+		Array<T,3> const& getVelocity(plint iProbe) const{
+			return velocities[iProbe];
+		}
+
+	private:
+		std::vector<Box3D> locations;
+		std::vector<std::string> names;
+		Box3D boundingBox;
+		std::vector<T> densities;
+		std::vector<Array<T,3> > velocities;
+	};
+
+}
+
+#endif  // PROBE_SET_3D_H
@@ -0,0 +1,236 @@
+/* In-situ spectral estimation of microphone signals.
+ *
+ * Welch-averaged auto and cross spectra are accumulated during the run at a
+ * list of chosen frequencies. Every signal is cut in Hann-windowed segments
+ * of segment_length samples with 50% overlap, and the discrete Fourier
+ * transform of each segment is evaluated only at the chosen frequencies by
+ * a running phasor, so no history is stored. From the averaged cross
+ * spectra with respect to a reference channel, the complex pressures along
+ * a duct are decomposed in incident and reflected waves (least squares,
+ * as in waveDecomposition.m), which gives the reflection coefficient and
+ * the end correction.
+ */
+
+#ifndef SPECTRAL_ESTIMATOR_3D_H
+#define SPECTRAL_ESTIMATOR_3D_H
+
+#include "palabos3D.h"
+#include "acoustics/probeSet3D.h"
+#include <vector>
+#include <complex>
+#include <string>
+#include <cmath>
+#include <iomanip>
+
+namespace plb_acoustics_3D{
+
+	using namespace plb;
+
+	template<typename T>
+	class SpectralEstimator3D{
+	public:
+		/* frequencies are in cycles per time step; reference_channel is
+		the channel used as phase reference for the cross spectra.*/
+		SpectralEstimator3D(plint num_channels_, std::vector<T> const& frequencies_,
+		  plint segment_length_, plint reference_channel_ = 0)
+			: num_channels(num_channels_),
+			  frequencies(frequencies_),
+			  segment_length(segment_length_),
+			  reference_channel(reference_channel_),
+			  num_samples(0),
+			  num_segments(0)
+		{
+			PLB_ASSERT( segment_length >= 2 );
+			PLB_ASSERT( reference_channel >= 0 && reference_channel < num_channels );
+			pluint num_frequencies = frequencies.size();
+			step_phasors.resize(num_frequencies);
+			for(pluint iF = 0; iF < num_frequencies; ++iF){
+				T angle = -(T)2*std::acos((T)-1)*frequencies[iF];
+				step_phasors[iF] = std::complex<T>(std::cos(angle), std::sin(angle));
+			}
+			window_sum = T();
+			for(plint n = 0; n < segment_length; ++n){
+				window_sum += window(n);
+			}
+			for(plint iSegment = 0; iSegment < 2; ++iSegment){
+				segments[iSegment].position = -iSegment*(segment_length/2);
+				segments[iSegment].dft.assign(num_channels*num_frequencies, std::complex<T>());
+				segments[iSegment].phasors.assign(num_frequencies, std::complex<T>((T)1, (T)0));
+			}
+			cross_spectra.assign(num_channels*num_frequencies, std::complex<T>());
+			auto_spectra.assign(num_channels*num_frequencies, T());
+		}
+
+		// Adds one time step of all the channels
+		void append(std::vector<T> const& signals){
+			PLB_ASSERT( (plint) signals.size() == num_channels );
+			for(plint iSegment = 0; iSegment < 2; ++iSegment){
+				Segment& segment = segments[iSegment];
+				if(segment.position >= 0){
+					accumulate(segment, signals);
+				}
+				++segment.position;
+				if(segment.position == segment_length){
+					closeSegment(segment);
+				}
+			}
+			++num_samples;
+		}
+
+		// Adds the pressures of an already sampled ProbeSet3D
+		template<template<typename U> class Descriptor>
+		void append(ProbeSet3D<T,Descriptor> const& probes, T rho0, T cs2){
+			std::vector<T> signals(num_channels);
+			for(plint iChannel = 0; iChannel < num_channels; ++iChannel){
+				signals[iChannel] = probes.getPressure(iChannel, rho0, cs2);
+			}
+			append(signals);
+		}
+
+		plint getNumSegments() const{
+			return num_segments;
+		}
+
+		std::vector<T> const& getFrequencies() const{
+			return frequencies;
+		}
+
+		// Welch-averaged auto spectrum of a channel
+		T getAutoSpectrum(plint iChannel, plint iFrequency) const{
+			if(num_segments == 0) return T();
+			return auto_spectra[index(iChannel, iFrequency)] / (T) num_segments;
+		}
+
+		// Welch-averaged cross spectrum <X_channel conj(X_reference)>
+		std::complex<T> getCrossSpectrum(plint iChannel, plint iFrequency) const{
+			if(num_segments == 0) return std::complex<T>();
+			return cross_spectra[index(iChannel, iFrequency)] / (T) num_segments;
+		}
+
+		/* Complex amplitude of a channel, with the phase of the reference
+		channel set to zero (H1 estimate scaled by the reference amplitude).*/
+		std::complex<T> getPressure(plint iChannel, plint iFrequency) const{
+			T reference = getAutoSpectrum(reference_channel, iFrequency);
+			if(reference <= T()) return std::complex<T>();
+			return getCrossSpectrum(iChannel, iFrequency) / std::sqrt(reference);
+		}
+
+		/* Reflection coefficient R = p-/p+ at reference_position, for the
+		channels located at positions along the duct axis (lattice units).
+		The wave numbers with mean flow are k/(1+M) and k/(1-M), with M
+		positive in the direction of the incident wave.*/
+		std::complex<T> computeReflectionCoefficient(plint iFrequency,
+		  std::vector<T> const& positions, T reference_position, T mach, T cs) const{
+			PLB_ASSERT( (plint) positions.size() == num_channels );
+			T k = (T)2*std::acos((T)-1)*frequencies[iFrequency]/cs;
+			T k_plus = k/((T)1 + mach);
+			T k_minus = k/((T)1 - mach);
+			std::complex<T> const i_unit((T)0, (T)1);
+			// Normal equations of the least squares problem E [p+ p-]^T = p.
+			std::complex<T> a11, a12, a22, b1, b2;
+			for(plint iChannel = 0; iChannel < num_channels; ++iChannel){
+				T x = positions[iChannel] - reference_position;
+				std::complex<T> e1 = std::exp(-i_unit*k_plus*x);
+				std::complex<T> e2 = std::exp(i_unit*k_minus*x);
+				std::complex<T> p = getPressure(iChannel, iFrequency);
+				a11 += std::conj(e1)*e1;
+				a12 += std::conj(e1)*e2;
+				a22 += std::conj(e2)*e2;
+				b1 += std::conj(e1)*p;
+				b2 += std::conj(e2)*p;
+			}
+			std::complex<T> det = a11*a22 - a12*std::conj(a12);
+			if(std::abs(det) <= T()) return std::complex<T>();
+			std::complex<T> p_plus = (a22*b1 - a12*b2)/det;
+			std::complex<T> p_minus = (a11*b2 - std::conj(a12)*b1)/det;
+			if(std::abs(p_plus) <= T()) return std::complex<T>();
+			return p_minus/p_plus;
+		}
+
+		/* End correction l/a of an unflanged duct of radius a, from the
+		phase of the reflection coefficient at the duct end.*/
+		T computeEndCorrection(plint iFrequency, std::complex<T> reflection, T radius, T cs) const{
+			T k = (T)2*std::acos((T)-1)*frequencies[iFrequency]/cs;
+			if(std::abs(reflection) <= T() || k <= T()) return T();
+			std::complex<T> const i_unit((T)0, (T)1);
+			std::complex<T> l = std::log(-reflection/std::abs(reflection))/(-(T)2*i_unit*k);
+			return std::real(l)/radius;
+		}
+
+		/* Writes one line per frequency: frequency, ka, |R|, arg(R), l/a.
+		Only the main processor writes.*/
+		void writeReflection(std::string file_name, std::vector<T> const& positions,
+		  T reference_position, T mach, T cs, T radius) const{
+			plb_ofstream file(file_name.c_str());
+			for(pluint iF = 0; iF < frequencies.size(); ++iF){
+				std::complex<T> reflection = computeReflectionCoefficient(iF,
+				  positions, reference_position, mach, cs);
+				T ka = (T)2*std::acos((T)-1)*frequencies[iF]*radius/cs;
+				file << std::setprecision(10) << frequencies[iF] << " " << ka << " "
+				     << std::abs(reflection) << " " << std::arg(reflection) << " "
+				     << computeEndCorrection(iF, reflection, radius, cs) << '\n';
+			}
+		}
+
+	private:
+		struct Segment{
+			plint position;
+			std::vector<std::complex<T> > dft;
+			std::vector<std::complex<T> > phasors;
+		};
+
+		T window(plint n) const{
+			return (T)0.5 - (T)0.5*std::cos((T)2*std::acos((T)-1)*(T)n/(T)(segment_length-1));
+		}
+
+		plint index(plint iChannel, plint iFrequency) const{
+			return iChannel*(plint)frequencies.size() + iFrequency;
+		}
+
+		void accumulate(Segment& segment, std::vector<T> const& signals){
+			T w = window(segment.position);
+			pluint num_frequencies = frequencies.size();
+			for(pluint iF = 0; iF < num_frequencies; ++iF){
+				std::complex<T> phasor = w*segment.phasors[iF];
+				for(plint iChannel = 0; iChannel < num_channels; ++iChannel){
+					segment.dft[index(iChannel, iF)] += signals[iChannel]*phasor;
+				}
+				segment.phasors[iF] *= step_phasors[iF];
+			}
+		}
+
+		void closeSegment(Segment& segment){
+			pluint num_frequencies = frequencies.size();
+			T normalization = (T)1/(window_sum*window_sum);
+			for(pluint iF = 0; iF < num_frequencies; ++iF){
+				std::complex<T> reference = segment.dft[index(reference_channel, iF)];
+				for(plint iChannel = 0; iChannel < num_channels; ++iChannel){
+					std::complex<T> value = segment.dft[index(iChannel, iF)];
+					auto_spectra[index(iChannel, iF)] += std::norm(value)*normalization;
+					cross_spectra[index(iChannel, iF)] += value*std::conj(reference)*normalization;
+				}
+			}
+			++num_segments;
+			segment.position = 0;
+			segment.dft.assign(segment.dft.size(), std::complex<T>());
+			// Restart the phasors: the phase of every segment starts at zero.
+			segment.phasors.assign(num_frequencies, std::complex<T>((T)1, (T)0));
+		}
+
+	private:
+		plint num_channels;
+		std::vector<T> frequencies;
+		plint segment_length;
+		plint reference_channel;
+		plint num_samples;
+		plint num_segments;
+		T window_sum;
+		std::vector<std::complex<T> > step_phasors;
+		Segment segments[2];
+		std::vector<std::complex<T> > cross_spectra;
+		std::vector<T> auto_spectra;
+	};
+
+}
+
+#endif  // SPECTRAL_ESTIMATOR_3D_H
@@ -27,9 +27,27 @@
  */
 #include "atomicBlock/atomicBlock3D.h"
 #include "atomicBlock/atomicBlockSerializer3D.h"
+#include <algorithm>
+#include <vector>
 
 namespace plb {
 
+/* *************** Struct BlockDataTransfer3D ******************************* */
+
+void BlockDataTransfer3D::sendStatic(Box3D domain, char* buffer) const {
+    std::vector<char> data;
+    send(domain, data, modif::staticVariables);
+    PLB_ASSERT( (plint)data.size() == domain.nCells()*staticCellSize() );
+    std::copy(data.begin(), data.end(), buffer);
+}
+
+void BlockDataTransfer3D::receiveStatic (
+        Box3D domain, char const* buffer, Dot3D absoluteOffset )
+{
+    std::vector<char> data(buffer, buffer+domain.nCells()*staticCellSize());
+    receive(domain, data, modif::staticVariables, absoluteOffset);
+}
+
 /* *************** Class StatSubscriber3D *********************************** */
 
 StatSubscriber3D::StatSubscriber3D(AtomicBlock3D& block_)
@@ -219,6 +237,29 @@ void AtomicBlock3D::executeInternalProcessors(plint level, DataProcessorVector&
     }
 }
 
+bool AtomicBlock3D::hasBlockLocalProcessors(plint level) const
+{
+    if (level<0) {
+        return hasBlockLocalProcessors(-level-1, explicitInternalProcessors);
+    }
+    else {
+        return hasBlockLocalProcessors(level, automaticInternalProcessors);
+    }
+}
+
+bool AtomicBlock3D::hasBlockLocalProcessors (
+        plint level, DataProcessorVector const& processors ) const
+{
+    if (level<(plint)processors.size()) {
+        for (pluint iProc=0; iProc<processors[level].size(); ++iProc) {
+            if (!processors[level][iProc]->isBlockLocal()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 DataSerializer* AtomicBlock3D::getBlockSerializer (
             Box3D const& domain, IndexOrdering::OrderingT ordering ) const
 {
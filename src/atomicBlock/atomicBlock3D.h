@@ -88,6 +88,33 @@ struct BlockDataTransfer3D {
     {
         attribute(toDomain, deltaX, deltaY, deltaZ, from, kind);
     }
+    /// Send the static data of a domain into a preallocated byte-stream.
+    /** The buffer holds domain.nCells()*staticCellSize() bytes. By default,
+     *  the data goes through send() and is copied into the buffer.
+     **/
+    virtual void sendStatic(Box3D domain, char* buffer) const;
+    /// Receive the static data of a domain from a byte-stream of
+    ///   domain.nCells()*staticCellSize() bytes.
+    virtual void receiveStatic(Box3D domain, char const* buffer, Dot3D absoluteOffset);
+    /// Number of bytes per cell sent by sendOriented().
+    virtual plint orientedCellSize(Dot3D orientation) const {
+        return staticCellSize();
+    }
+    /// Send the static data of a domain which points along an orientation
+    ///   into a preallocated byte-stream.
+    /** Each component of the orientation is -1, 0 or +1, where 0 stands for
+     *  any direction along this axis. By default, the data has no direction
+     *  and the whole static data is sent.
+     **/
+    virtual void sendOriented(Box3D domain, char* buffer, Dot3D orientation) const {
+        sendStatic(domain, buffer);
+    }
+    /// Receive the static data sent by sendOriented().
+    virtual void receiveOriented( Box3D domain, char const* buffer,
+                                  Dot3D orientation, Dot3D absoluteOffset )
+    {
+        receiveStatic(domain, buffer, absoluteOffset);
+    }
 };
 
 class AtomicBlock3D : public Block3D {
@@ -111,6 +138,9 @@ public:
     void executeInternalProcessors();
     /// Execute all internal dataProcessors at a given level.
     void executeInternalProcessors(plint level);
+    /// Tell if all internal dataProcessors at a given level only access
+    ///   the blocks they were generated for (see DataProcessor3D::isBlockLocal()).
+    bool hasBlockLocalProcessors(plint level) const;
     /// Add a dataProcessor, which is executed after each iteration.
     void integrateDataProcessor(DataProcessor3D* processor, plint level);
     /// Remove all data processors.
@@ -156,6 +186,8 @@ private:
                      DataProcessor3D* processor, plint level, DataProcessorVector& processors );
     /// Common implementation for explicit/automatic processors.
     void executeInternalProcessors(plint level, DataProcessorVector& processors);
+    /// Common implementation for explicit/automatic processors.
+    bool hasBlockLocalProcessors(plint level, DataProcessorVector const& processors) const;
     /// Copy processors from one vector to another.
     void copyDataProcessors(DataProcessorVector const& from, DataProcessorVector& to);
     /// Release memory for a given species of lattice processors.
@@ -68,6 +68,17 @@ public:
     {
         attribute(toDomain, deltaX, deltaY, deltaZ, from, kind);
     }
+    /// Serialize the cells of the domain in place into a preallocated buffer.
+    virtual void sendStatic(Box3D domain, char* buffer) const;
+    /// Unserialize the cells of the domain in place from a buffer.
+    virtual void receiveStatic(Box3D domain, char const* buffer, Dot3D absoluteOffset);
+    /// Size of the populations which point along the orientation.
+    virtual plint orientedCellSize(Dot3D orientation) const;
+    /// Send only the populations which point along the orientation.
+    virtual void sendOriented(Box3D domain, char* buffer, Dot3D orientation) const;
+    /// Receive the populations sent by sendOriented().
+    virtual void receiveOriented( Box3D domain, char const* buffer,
+                                  Dot3D orientation, Dot3D absoluteOffset );
 private:
     void send_static(Box3D domain, std::vector<char>& buffer) const;
     void send_dynamic(Box3D domain, std::vector<char>& buffer) const;
@@ -101,7 +112,8 @@ template<typename T_, template<typename U_> class Descriptor_>
 /** A block lattice contains a regular array of Cell objects and
  * some useful methods to execute the LB dynamics on the lattice.
  *
- * This class is not intended to be derived from.
+ * SoABlockLattice3D derives from this class to store the populations
+ * differently; it keeps the cells consistent through the virtual methods.
  */
 template<typename T, template<typename U> class Descriptor>
 class BlockLattice3D : public BlockLatticeBase3D<T,Descriptor>, public AtomicBlock3D
@@ -117,6 +129,8 @@ public:
     BlockLattice3D& operator=(BlockLattice3D<T,Descriptor> const& rhs);
     /// Swap the content of two BlockLattices
     void swap(BlockLattice3D& rhs);
+    /// Copy of the lattice, with its storage
+    virtual BlockLattice3D<T,Descriptor>* clone() const;
 public:
     /// Read/write access to lattice cells
     virtual Cell<T,Descriptor>& get(plint iX, plint iY, plint iZ) {
@@ -147,19 +161,44 @@ public:
     virtual void collideAndStream(Box3D domain);
     /// Apply first collision, then streaming step to the whole domain
     virtual void collideAndStream();
+    /// Apply collision and streaming to the cells of domain outside interior
+    /** First half of collideAndStream(domain), split around a box interior
+     *  which is at least one vicinity inside domain. Cells of domain more than
+     *  one vicinity away from interior are up to date afterwards, and interior
+     *  is not accessed.
+     */
+    void collideAndStreamShell(Box3D domain, Box3D interior);
+    /// Apply collision and streaming to interior, completing collideAndStreamShell()
+    /** Only interior and the cells within one vicinity around it are accessed.
+     */
+    void collideAndStreamInterior(Box3D domain, Box3D interior);
     /// Increment time counter
     /** Warning: don't call this method manually. Instead, call incrementTime()
      *  on the multi-block lattice. Otherwise, the internal time of the multi-block
      *  and the atomic-blocks get out of sync.
      **/
     virtual void incrementTime();
+    /// Choose the streaming algorithm of collideAndStream()
+    /** The pattern can only be changed while the populations are in natural
+     *  order. With the AA pattern, collide() and stream() must not be used,
+     *  and the block must have no internal data processors, which would be
+     *  executed on the reverted layout of even cycles.
+     */
+    void setStreamingPattern(streaming::PatternT pattern);
+    streaming::PatternT getStreamingPattern() const;
+    /// Tell if the populations are stored in natural order
+    /** Always the case with swap streaming. With the AA pattern, only after
+     *  odd cycles: data processors and output which access populations should
+     *  be used on even time steps.
+     */
+    bool hasNaturalLayout() const;
     /// Get access to data transfer between blocks
     virtual BlockLatticeDataTransfer3D<T,Descriptor>& getDataTransfer();
     /// Get access to data transfer between blocks (const version)
     virtual BlockLatticeDataTransfer3D<T,Descriptor> const& getDataTransfer() const;
 public:
     /// Attribute dynamics to a cell.
-    void attributeDynamics(plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics);
+    virtual void attributeDynamics(plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics);
     /// Get a reference to the background dynamics
     Dynamics<T,Descriptor>& getBackgroundDynamics();
     /// Get a const reference to the background dynamics
@@ -176,6 +215,19 @@ private:
     /// Cache-efficient implementation of bulkCollideAndStream(domain)for
     ///   nearest-neighbor lattices.
     void blockwiseBulkCollideAndStream(Box3D domain);
+    /// Collide and stream the cells [iZ0,iZ1] of a line, run by run of equal
+    ///   dynamics.
+    void collideAndSwapLine(plint iX, plint iY, plint iZ0, plint iZ1);
+    /// Stream between the cells of domain and their neighbors in bound, but only
+    ///   with the neighbors inside interior or only with those outside.
+    void shellStream(Box3D bound, Box3D interior, bool intoInterior, Box3D domain);
+    /// Collide-and-stream cycle of the AA pattern. If periodic, the odd cycle
+    ///   wraps populations around the domain, else it bounces them back.
+    void aaCollideAndStream(Box3D domain, bool periodic);
+    /// Odd cycle of the AA pattern on cells whose neighbors are all in the lattice
+    void aaBulkOddStep(Box3D domain);
+    /// Odd cycle of the AA pattern on cells of domain close to the limit bound
+    void aaBoundaryOddStep(Box3D bound, Box3D domain, bool periodic);
 private:
     /// Helper method for memory allocation
     void allocateAndInitialize();
@@ -188,6 +240,8 @@ private:
     Dynamics<T,Descriptor>* backgroundDynamics;
     Cell<T,Descriptor>     *rawData;
     Cell<T,Descriptor>   ***grid;
+    streaming::PatternT streamingPattern;
+    bool aaOddStep;
     BlockLatticeDataTransfer3D<T,Descriptor> dataTransfer;
 public:
     static CachePolicy3D& cachePolicy();
@@ -55,6 +55,8 @@ BlockLattice3D<T,Descriptor>::BlockLattice3D (
         Dynamics<T,Descriptor>* backgroundDynamics_ )
     : AtomicBlock3D(nx_, ny_, nz_),
       backgroundDynamics(backgroundDynamics_),
+      streamingPattern(streaming::swap),
+      aaOddStep(false),
       dataTransfer(*this)
 {
     plint nx = this->getNx();
@@ -94,7 +96,8 @@ BlockLattice3D<T,Descriptor>::~BlockLattice3D()
 }
 
 /** The whole data of the lattice is duplicated. This includes
- * both particle distribution function and external fields.
+ * both particle distribution function and external fields. The cells
+ * of rhs are read through get(), whatever the storage of rhs.
  * \warning The dynamics objects and internalProcessors are not copied
  * \param rhs the lattice to be duplicated
  */
@@ -103,6 +106,8 @@ BlockLattice3D<T,Descriptor>::BlockLattice3D(BlockLattice3D<T,Descriptor> const&
     : BlockLatticeBase3D<T,Descriptor>(rhs),
       AtomicBlock3D(rhs),
       backgroundDynamics(rhs.backgroundDynamics->clone()),
+      streamingPattern(rhs.streamingPattern),
+      aaOddStep(rhs.aaOddStep),
       dataTransfer(*this)
 {
     plint nx = this->getNx();
@@ -114,7 +119,7 @@ BlockLattice3D<T,Descriptor>::BlockLattice3D(BlockLattice3D<T,Descriptor> const&
             for (plint iZ=0; iZ<nz; ++iZ) {
                 Cell<T,Descriptor>& cell = grid[iX][iY][iZ];
                 // Assign cell from rhs
-                cell = rhs.grid[iX][iY][iZ];
+                cell = rhs.get(iX,iY,iZ);
                 // Get an independent clone of the dynamics,
                 //   or assign backgroundDynamics
                 if (&cell.getDynamics()==rhs.backgroundDynamics) {
@@ -153,6 +158,13 @@ void BlockLattice3D<T,Descriptor>::swap(BlockLattice3D& rhs) {
     std::swap(backgroundDynamics, rhs.backgroundDynamics);
     std::swap(rawData, rhs.rawData);
     std::swap(grid, rhs.grid);
+    std::swap(streamingPattern, rhs.streamingPattern);
+    std::swap(aaOddStep, rhs.aaOddStep);
+}
+
+template<typename T, template<typename U> class Descriptor>
+BlockLattice3D<T,Descriptor>* BlockLattice3D<T,Descriptor>::clone() const {
+    return new BlockLattice3D<T,Descriptor>(*this);
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -254,6 +266,11 @@ void BlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
 
+    if (streamingPattern==streaming::aa) {
+        aaCollideAndStream(domain, false);
+        return;
+    }
+
     global::profiler().start("collStream");
     global::profiler().increment("collStreamCells", domain.nCells());
 
@@ -311,14 +328,63 @@ void BlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
     global::profiler().stop("collStream");
 }
 
+/** Together with collideAndStreamInterior(), this yields the same result as
+ * collideAndStream(domain). In between, the up-to-date cells next to the
+ * envelope can be communicated while the interior is still being processed.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndStreamShell(Box3D domain, Box3D interior) {
+    PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    PLB_PRECONDITION( contained(interior.enlarge(Descriptor<T>::vicinity), domain) );
+    PLB_PRECONDITION( streamingPattern==streaming::swap );
+
+    global::profiler().start("collStream");
+    global::profiler().increment("collStreamCells", domain.nCells()-interior.nCells());
+
+    std::vector<Box3D> shell;
+    except(domain, interior, shell);
+    for (pluint iBox=0; iBox<shell.size(); ++iBox) {
+        collide(shell[iBox]);
+    }
+    // Populations exchanged with interior are left for collideAndStreamInterior().
+    for (pluint iBox=0; iBox<shell.size(); ++iBox) {
+        shellStream(domain, interior, false, shell[iBox]);
+    }
+    global::profiler().stop("collStream");
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndStreamInterior(Box3D domain, Box3D interior) {
+    static const plint vicinity = Descriptor<T>::vicinity;
+    PLB_PRECONDITION( contained(interior.enlarge(vicinity), domain) );
+
+    global::profiler().start("collStream");
+    global::profiler().increment("collStreamCells", interior.nCells());
+
+    // The neighbors of interior are already collided, so the bulk algorithm
+    //   is valid on all of interior.
+    bulkCollideAndStream(interior);
+
+    std::vector<Box3D> frame;
+    except(interior.enlarge(vicinity), interior, frame);
+    for (pluint iBox=0; iBox<frame.size(); ++iBox) {
+        shellStream(domain, interior, true, frame[iBox]);
+    }
+    global::profiler().stop("collStream");
+}
+
 /** At the end of this method, finalizeIteration() and
  * executeInternalProcessors() are automatically invoked.
  * \sa collideAndStream(int,int,int,int,int,int) */
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::collideAndStream() {
-    collideAndStream(this->getBoundingBox());
-
-    implementPeriodicity();
+    if (streamingPattern==streaming::aa) {
+        aaCollideAndStream(this->getBoundingBox(), true);
+    }
+    else {
+        collideAndStream(this->getBoundingBox());
+        implementPeriodicity();
+    }
 
     this->executeInternalProcessors();
     this->evaluateStatistics();
@@ -328,6 +394,26 @@ void BlockLattice3D<T,Descriptor>::collideAndStream() {
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::incrementTime() {
     this->getTimeCounter().incrementTime();
+    if (streamingPattern==streaming::aa) {
+        aaOddStep = !aaOddStep;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::setStreamingPattern(streaming::PatternT pattern) {
+    PLB_PRECONDITION( hasNaturalLayout() );
+    streamingPattern = pattern;
+    aaOddStep = false;
+}
+
+template<typename T, template<typename U> class Descriptor>
+streaming::PatternT BlockLattice3D<T,Descriptor>::getStreamingPattern() const {
+    return streamingPattern;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool BlockLattice3D<T,Descriptor>::hasNaturalLayout() const {
+    return !aaOddStep;
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -426,6 +512,32 @@ void BlockLattice3D<T,Descriptor>::boundaryStream(Box3D bound, Box3D domain) {
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::shellStream (
+        Box3D bound, Box3D interior, bool intoInterior, Box3D domain )
+{
+    PLB_PRECONDITION( contained(bound, this->getBoundingBox()) );
+    PLB_PRECONDITION( contained(domain, bound) );
+
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                for (plint iPop=1; iPop<=Descriptor<T>::q/2; ++iPop) {
+                    plint nextX = iX + Descriptor<T>::c[iPop][0];
+                    plint nextY = iY + Descriptor<T>::c[iPop][1];
+                    plint nextZ = iZ + Descriptor<T>::c[iPop][2];
+                    if ( contained(nextX,nextY,nextZ, bound) &&
+                         contained(nextX,nextY,nextZ, interior) == intoInterior )
+                    {
+                        std::swap(grid[iX][iY][iZ][iPop+Descriptor<T>::q/2],
+                                  grid[nextX][nextY][nextZ][iPop]);
+                    }
+                }
+            }
+        }
+    }
+}
+
 /** This method is faster than boundaryStream(int,int,int,int,int,int), but it
  * is erroneous when applied to boundary cells.
  * \sa stream(int,int,int,int,int,int)
@@ -486,10 +598,7 @@ void BlockLattice3D<T,Descriptor>::linearBulkCollideAndStream(Box3D domain) {
 
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
-            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                grid[iX][iY][iZ].collide(this->getInternalStatistics());
-                latticeTemplates<T,Descriptor>::swapAndStream3D(grid, iX, iY, iZ);
-            }
+            collideAndSwapLine(iX, iY, domain.z0, domain.z1);
         }
     }
 }
@@ -532,18 +641,8 @@ void BlockLattice3D<T,Descriptor>::blockwiseBulkCollideAndStream(Box3D domain) {
                         //    the swap-operation of the streaming.
                         plint minZ = outerZ-dx-dy;
                         plint maxZ = minZ+blockSize-1;
-                        for (plint innerZ=std::max(minZ,domain.z0);
-                             innerZ <= std::min(maxZ, domain.z1);
-                             ++innerZ)
-                        {
-                            // Collide the cell.
-                            grid[innerX][innerY][innerZ].collide (
-                                    this->getInternalStatistics() );
-                            // Swap the populations on the cell, and then with post-collision
-                            //   neighboring cell, to perform the streaming step.
-                            latticeTemplates<T,Descriptor>::swapAndStream3D (
-                                    grid, innerX, innerY, innerZ );
-                        }
+                        collideAndSwapLine( innerX, innerY, std::max(minZ,domain.z0),
+                                            std::min(maxZ, domain.z1) );
                     }
                 }
             }
@@ -551,6 +650,195 @@ void BlockLattice3D<T,Descriptor>::blockwiseBulkCollideAndStream(Box3D domain) {
     }
 }
 
+/** The cells [iZ0,iZ1] are cut into runs of consecutive cells which point to
+ *  the same dynamics object, and each run is handed to a single call of
+ *  Dynamics::collideAndStreamBulk(). On homogeneous regions, this replaces the
+ *  virtual call per cell by one per run, and lets the dynamics inline its
+ *  collision into the loop.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndSwapLine(plint iX, plint iY, plint iZ0, plint iZ1) {
+    Cell<T,Descriptor>* line = grid[iX][iY];
+    plint iZ = iZ0;
+    while (iZ <= iZ1) {
+        Dynamics<T,Descriptor>* runDynamics = &line[iZ].getDynamics();
+        plint runEnd = iZ;
+        while (runEnd < iZ1 && &line[runEnd+1].getDynamics() == runDynamics) {
+            ++runEnd;
+        }
+        runDynamics->collideAndStreamBulk(grid, iX, iY, iZ, runEnd, this->getInternalStatistics());
+        iZ = runEnd+1;
+    }
+}
+
+/** The even cycle is a collision followed by a revert(), the populations
+ *  leaving the cell being stored in the opposite slots of the cell itself.
+ *  The odd cycle reads, for a cell x and each direction i, the slot opposite
+ *  to i of the cell x-c_i, which holds the population streaming into x, and
+ *  after the collision writes the populations leaving x into the slot i of
+ *  x+c_i, where they are found in natural order. The slots written by a cell
+ *  are exactly the ones it read, so that the cells can be processed in any
+ *  order, and the result is the one of two cycles of swap streaming.
+ *
+ *  On a multi-block, the envelope cells are collided as the bulk cells, and
+ *  the odd cycle of envelope cells of depth vicinity needs the envelope cells
+ *  of depth 2*vicinity: the envelope must be twice as wide as the vicinity.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::aaCollideAndStream(Box3D domain, bool periodic) {
+    global::profiler().start("collStream");
+    global::profiler().increment("collStreamCells", domain.nCells());
+
+    if (!aaOddStep) {
+        collide(domain);
+    }
+    else {
+        static const plint vicinity = Descriptor<T>::vicinity;
+        aaBoundaryOddStep(domain, Box3D(domain.x0,domain.x0+vicinity-1,
+                                        domain.y0,domain.y1,
+                                        domain.z0,domain.z1), periodic );
+        aaBoundaryOddStep(domain, Box3D(domain.x1-vicinity+1,domain.x1,
+                                        domain.y0,domain.y1,
+                                        domain.z0,domain.z1), periodic );
+        aaBoundaryOddStep(domain, Box3D(domain.x0+vicinity,domain.x1-vicinity,
+                                        domain.y0,domain.y0+vicinity-1,
+                                        domain.z0,domain.z1), periodic );
+        aaBoundaryOddStep(domain, Box3D(domain.x0+vicinity,domain.x1-vicinity,
+                                        domain.y1-vicinity+1,domain.y1,
+                                        domain.z0,domain.z1), periodic );
+        aaBoundaryOddStep(domain, Box3D(domain.x0+vicinity,domain.x1-vicinity,
+                                        domain.y0+vicinity,domain.y1-vicinity,
+                                        domain.z0,domain.z0+vicinity-1), periodic );
+        aaBoundaryOddStep(domain, Box3D(domain.x0+vicinity,domain.x1-vicinity,
+                                        domain.y0+vicinity,domain.y1-vicinity,
+                                        domain.z1-vicinity+1,domain.z1), periodic );
+        aaBulkOddStep(Box3D(domain.x0+vicinity,domain.x1-vicinity,
+                            domain.y0+vicinity,domain.y1-vicinity,
+                            domain.z0+vicinity,domain.z1-vicinity) );
+    }
+    global::profiler().stop("collStream");
+}
+
+/** The populations of a cell are gathered into a temporary cell, which
+ *  points to the same dynamics: the slots of the cell itself belong to its
+ *  neighbors. The neighbors are addressed through their offset in memory.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::aaBulkOddStep(Box3D domain) {
+    static const plint q = Descriptor<T>::q;
+    static const plint numScalars = Descriptor<T>::ExternalField::numScalars;
+    plint offset[q];
+    for (plint iPop=0; iPop<q; ++iPop) {
+        offset[iPop] = ( Descriptor<T>::c[iPop][0]*this->getNy()
+                         + Descriptor<T>::c[iPop][1] ) * this->getNz()
+                       + Descriptor<T>::c[iPop][2];
+    }
+    Cell<T,Descriptor> tmp;
+    // For cache efficiency, the y-z plane is traversed by tiles, each of which
+    //   is swept along x: the neighbors are then found in the last three planes
+    //   of the tile.
+    const plint blockSize = cachePolicy().getBlockSize();
+    for (plint outerY=domain.y0; outerY<=domain.y1; outerY+=blockSize) {
+    for (plint outerZ=domain.z0; outerZ<=domain.z1; outerZ+=blockSize) {
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=outerY; iY<=std::min(outerY+blockSize-1, domain.y1); ++iY) {
+            for (plint iZ=outerZ; iZ<=std::min(outerZ+blockSize-1, domain.z1); ++iZ) {
+                Cell<T,Descriptor>* cell = &grid[iX][iY][iZ];
+                tmp.attributeDynamics(&cell->getDynamics());
+                tmp.specifyStatisticsStatus(cell->takesStatistics());
+                for (plint iExt=0; iExt<numScalars; ++iExt) {
+                    *tmp.getExternal(iExt) = *cell->getExternal(iExt);
+                }
+                tmp[0] = (*cell)[0];
+                for (plint iPop=1; iPop<q; ++iPop) {
+                    tmp[iPop] = cell[-offset[iPop]][indexTemplates::opposite<Descriptor<T> >(iPop)];
+                }
+                tmp.collide(this->getInternalStatistics());
+                (*cell)[0] = tmp[0];
+                for (plint iPop=1; iPop<q; ++iPop) {
+                    cell[offset[iPop]][iPop] = tmp[iPop];
+                }
+                for (plint iExt=0; iExt<numScalars; ++iExt) {
+                    *cell->getExternal(iExt) = *tmp.getExternal(iExt);
+                }
+            }
+        }
+    }
+    }
+    }
+}
+
+/** Populations which would stream into a cell from outside bound are the
+ *  ones which left it in the opposite direction (bounce-back), as with
+ *  boundaryStream(). If periodic, they come from the other side of bound.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::aaBoundaryOddStep(Box3D bound, Box3D domain, bool periodic) {
+    // Make sure bound is contained within current lattice
+    PLB_PRECONDITION( contained(bound, this->getBoundingBox()) );
+    // Make sure domain is contained within bound
+    PLB_PRECONDITION( contained(domain, bound) );
+
+    static const plint q = Descriptor<T>::q;
+    static const plint numScalars = Descriptor<T>::ExternalField::numScalars;
+    plint nx = bound.getNx();
+    plint ny = bound.getNy();
+    plint nz = bound.getNz();
+    Cell<T,Descriptor> tmp;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                Cell<T,Descriptor>& cell = grid[iX][iY][iZ];
+                tmp.attributeDynamics(&cell.getDynamics());
+                tmp.specifyStatisticsStatus(cell.takesStatistics());
+                for (plint iExt=0; iExt<numScalars; ++iExt) {
+                    *tmp.getExternal(iExt) = *cell.getExternal(iExt);
+                }
+                tmp[0] = cell[0];
+                for (plint iPop=1; iPop<q; ++iPop) {
+                    plint prevX = iX - Descriptor<T>::c[iPop][0];
+                    plint prevY = iY - Descriptor<T>::c[iPop][1];
+                    plint prevZ = iZ - Descriptor<T>::c[iPop][2];
+                    if (contained(prevX,prevY,prevZ, bound)) {
+                        tmp[iPop] = grid[prevX][prevY][prevZ][indexTemplates::opposite<Descriptor<T> >(iPop)];
+                    }
+                    else if (periodic) {
+                        prevX = bound.x0 + (prevX-bound.x0+nx) % nx;
+                        prevY = bound.y0 + (prevY-bound.y0+ny) % ny;
+                        prevZ = bound.z0 + (prevZ-bound.z0+nz) % nz;
+                        tmp[iPop] = grid[prevX][prevY][prevZ][indexTemplates::opposite<Descriptor<T> >(iPop)];
+                    }
+                    else {
+                        tmp[iPop] = cell[iPop];
+                    }
+                }
+                tmp.collide(this->getInternalStatistics());
+                cell[0] = tmp[0];
+                for (plint iPop=1; iPop<q; ++iPop) {
+                    plint nextX = iX + Descriptor<T>::c[iPop][0];
+                    plint nextY = iY + Descriptor<T>::c[iPop][1];
+                    plint nextZ = iZ + Descriptor<T>::c[iPop][2];
+                    if (contained(nextX,nextY,nextZ, bound)) {
+                        grid[nextX][nextY][nextZ][iPop] = tmp[iPop];
+                    }
+                    else if (periodic) {
+                        nextX = bound.x0 + (nextX-bound.x0+nx) % nx;
+                        nextY = bound.y0 + (nextY-bound.y0+ny) % ny;
+                        nextZ = bound.z0 + (nextZ-bound.z0+nz) % nz;
+                        grid[nextX][nextY][nextZ][iPop] = tmp[iPop];
+                    }
+                    else {
+                        cell[indexTemplates::opposite<Descriptor<T> >(iPop)] = tmp[iPop];
+                    }
+                }
+                for (plint iExt=0; iExt<numScalars; ++iExt) {
+                    *cell.getExternal(iExt) = *tmp.getExternal(iExt);
+                }
+            }
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::implementPeriodicity() {
     static const plint vicinity = Descriptor<T>::vicinity;
@@ -677,12 +965,20 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::send_static (
     // Avoid dereferencing uninitialized pointer.
     if (numBytes==0) return;
     buffer.resize(numBytes);
+    sendStatic(domain, &buffer[0]);
+}
 
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::sendStatic (
+        Box3D domain, char* buffer ) const
+{
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    plint cellSize = staticCellSize();
     plint iData=0;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                lattice.get(iX,iY,iZ).serialize(&buffer[iData]);
+                lattice.get(iX,iY,iZ).serialize(buffer+iData);
                 iData += cellSize;
             }
         }
@@ -764,19 +1060,77 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::receive_static (
     PLB_PRECONDITION( (plint) buffer.size() == domain.nCells()*staticCellSize() );
     // Avoid dereferencing uninitialized pointer.
     if (buffer.empty()) return;
-    plint cellSize = staticCellSize();
+    receiveStatic(domain, &buffer[0], Dot3D());
+}
 
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::receiveStatic (
+        Box3D domain, char const* buffer, Dot3D absoluteOffset )
+{
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    plint cellSize = staticCellSize();
     plint iData=0;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                lattice.get(iX,iY,iZ).unSerialize(&buffer[iData]);
+                lattice.get(iX,iY,iZ).unSerialize(buffer+iData);
                 iData += cellSize;
             }
         }
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+plint BlockLatticeDataTransfer3D<T,Descriptor>::orientedCellSize(Dot3D orientation) const
+{
+    return sizeof(T) * indexTemplates::subIndexOriented3D<Descriptor<T> > (
+                           orientation.x, orientation.y, orientation.z ).size();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::sendOriented (
+        Box3D domain, char* buffer, Dot3D orientation ) const
+{
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    std::vector<plint> const& indices = indexTemplates::subIndexOriented3D<Descriptor<T> > (
+                                            orientation.x, orientation.y, orientation.z );
+    plint numIndices = (plint)indices.size();
+    plint iData=0;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                Cell<T,Descriptor> const& cell = lattice.get(iX,iY,iZ);
+                for (plint iIndex=0; iIndex<numIndices; ++iIndex) {
+                    memcpy((void*)(buffer+iData), (const void*)(&cell[indices[iIndex]]), sizeof(T));
+                    iData += sizeof(T);
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::receiveOriented (
+        Box3D domain, char const* buffer, Dot3D orientation, Dot3D absoluteOffset )
+{
+    PLB_PRECONDITION(contained(domain, lattice.getBoundingBox()));
+    std::vector<plint> const& indices = indexTemplates::subIndexOriented3D<Descriptor<T> > (
+                                            orientation.x, orientation.y, orientation.z );
+    plint numIndices = (plint)indices.size();
+    plint iData=0;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                Cell<T,Descriptor>& cell = lattice.get(iX,iY,iZ);
+                for (plint iIndex=0; iIndex<numIndices; ++iIndex) {
+                    memcpy((void*)(&cell[indices[iIndex]]), (const void*)(buffer+iData), sizeof(T));
+                    iData += sizeof(T);
+                }
+            }
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLatticeDataTransfer3D<T,Descriptor>::receive_dynamic (
         Box3D domain, std::vector<char> const& buffer )
@@ -852,7 +1206,7 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute (
         Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
         AtomicBlock3D const& from, modif::ModifT kind )
 {
-    PLB_PRECONDITION (typeid(from) == typeid(BlockLattice3D<T,Descriptor> const&));
+    PLB_PRECONDITION ((dynamic_cast<BlockLattice3D<T,Descriptor> const*>(&from)));
     PLB_PRECONDITION(contained(toDomain, lattice.getBoundingBox()));
     BlockLattice3D<T,Descriptor> const& fromLattice = (BlockLattice3D<T,Descriptor> const&) from;
     switch(kind) {
@@ -75,6 +75,10 @@ int BoxProcessingFunctional3D::getStaticId() const {
     return -1;
 }
 
+bool BoxProcessingFunctional3D::isBlockLocal() const {
+    return true;
+}
+
 void BoxProcessingFunctional3D::getModificationPattern(std::vector<bool>& isWritten) const {
     std::vector<modif::ModifT> modified(isWritten.size());
     getTypeOfModification(modified);
@@ -123,6 +127,10 @@ int BoxProcessor3D::getStaticId() const {
     return functional->getStaticId();
 }
 
+bool BoxProcessor3D::isBlockLocal() const {
+    return functional->isBlockLocal();
+}
+
 
 /* *************** Class BoxProcessorGenerator3D *************************** */
 
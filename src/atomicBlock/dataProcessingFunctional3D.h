@@ -70,6 +70,8 @@ public:
     virtual void serialize(std::string& data) const;
     virtual void unserialize(std::string& data);
     virtual int getStaticId() const;
+    /// See DataProcessor3D::isBlockLocal().
+    virtual bool isBlockLocal() const;
 private:
     int dxScale, dtScale;
 };
@@ -86,6 +88,7 @@ public:
     virtual void process();
     virtual BoxProcessor3D* clone() const;
     virtual int getStaticId() const;
+    virtual bool isBlockLocal() const;
 private:
     BoxProcessingFunctional3D* functional;
     Box3D domain;
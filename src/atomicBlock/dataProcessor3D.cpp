@@ -66,6 +66,18 @@ int DataProcessor3D::getStaticId() const {
     return -1;
 }
 
+/** With PLB_SMP_PARALLEL, the internal processors of the blocks of a
+ *  multi-block are executed concurrently (see MultiBlock3D::executeInternalProcessors()).
+ *  This is correct as long as a processor only reads and writes the atomic
+ *  blocks it was generated for, which is the default assumption. A processor
+ *  which writes into an object shared by all blocks, like an accumulator,
+ *  must return false: the blocks are then processed one after the other
+ *  at its level.
+ **/
+bool DataProcessor3D::isBlockLocal() const {
+    return true;
+}
+
 
 ////////////////////// Class DataProcessorGenerator3D /////////////////
 
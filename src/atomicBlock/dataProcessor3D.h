@@ -53,6 +53,8 @@ struct DataProcessor3D {
     /// Unique identifier for a given DataProcessor class. Produces the same ID as
     ///   the corresponding processor generator.
     virtual int getStaticId() const;
+    /// Tell if the processor only accesses the atomic blocks it was generated for
+    virtual bool isBlockLocal() const;
 };
 
 /// This is a factory class generating LatticeProcessors
@@ -0,0 +1,178 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * A 3D block lattice with structure-of-arrays storage -- header file.
+ */
+#ifndef SOA_BLOCK_LATTICE_3D_H
+#define SOA_BLOCK_LATTICE_3D_H
+
+#include "core/globalDefs.h"
+#include "core/plbDebug.h"
+#include "core/cell.h"
+#include "atomicBlock/atomicBlock3D.h"
+#include "atomicBlock/blockLattice3D.h"
+#include "core/blockIdentifiers.h"
+#include <vector>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor> struct Dynamics;
+template<typename T, template<typename U> class Descriptor, typename S=T> class SoABlockLattice3D;
+
+
+/// Data transfer of a SoABlockLattice3D, with the byte format of a BlockLattice3D.
+/** Static data is read from and written to the arrays of populations, without
+ *  synchronizing the cells. The other kinds of data go through the cells.
+ */
+template<typename T, template<typename U> class Descriptor, typename S=T>
+class SoABlockLatticeDataTransfer3D : public BlockLatticeDataTransfer3D<T,Descriptor> {
+public:
+    SoABlockLatticeDataTransfer3D(SoABlockLattice3D<T,Descriptor,S>& lattice_);
+    using BlockLatticeDataTransfer3D<T,Descriptor>::attribute;
+    /// Attribute data between two lattices.
+    virtual void attribute(Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
+                           AtomicBlock3D const& from, modif::ModifT kind);
+    /// Serialize the cells of the domain in place into a preallocated buffer.
+    virtual void sendStatic(Box3D domain, char* buffer) const;
+    /// Unserialize the cells of the domain in place from a buffer.
+    virtual void receiveStatic(Box3D domain, char const* buffer, Dot3D absoluteOffset);
+private:
+    SoABlockLattice3D<T,Descriptor,S>& lattice;
+};
+
+/// A 3D block lattice which stores its populations as a structure of arrays.
+/** The populations of each direction are contiguous in memory, with z as
+ *  the fastest index, so that a collision kernel can process a run of
+ *  cells along z with vector instructions. The streaming is a push into a
+ *  second set of arrays, which have a layer of ghost cells around the
+ *  block. collideAndStream(domain) has the result of the one of
+ *  BlockLattice3D: populations which would stream out of the domain are
+ *  bounced back, and the cells outside the domain are left unchanged.
+ *  collideAndStream() folds the ghost layer back periodically.
+ *
+ *  Runs of cells whose dynamics have a kernel (see SoAkernelSelector in
+ *  soaKernels.h) are collided by the kernel. All other cells, e.g. those of
+ *  boundaries, are collided in place by their dynamics and their populations
+ *  are pushed into the arrays.
+ *
+ *  The class is a BlockLattice3D, and is used as a component of
+ *  MultiBlockLattice3D with setPopulationStorage(). Its cells keep the
+ *  dynamics, the statistics flags and the external scalars; the arrays hold
+ *  the populations. A cell is refreshed from the arrays when it is accessed
+ *  through get(), and a cell accessed for writing is loaded back into the
+ *  arrays before the next collideAndStream(). Data processors, I/O and the
+ *  data transfer therefore work as on a BlockLattice3D. The memory of the
+ *  cells comes in addition to the two sets of arrays. Not supported are the
+ *  AA pattern, collideAndStreamShell() and collideAndStreamInterior(), and
+ *  the processors which access the cells of a BlockLattice3D directly
+ *  (ExternalRhoJcollideAndStream3D and related ones); collide() and stream()
+ *  work, by way of the cells.
+ *
+ *  The populations are stored with the type S; S=T is the standard case,
+ *  and S=float with T=double halves the memory of the arrays (see
+ *  storage::soaFloat). The arithmetic is done with the type T, and the
+ *  populations are rounded to S when they are stored. The cells, and the
+ *  data transfer, keep the type T.
+ */
+template<typename T, template<typename U> class Descriptor, typename S>
+class SoABlockLattice3D : public BlockLattice3D<T,Descriptor>
+{
+public:
+    SoABlockLattice3D(plint nx_, plint ny_, plint nz_, Dynamics<T,Descriptor>* backgroundDynamics_);
+    /// Copy of a BlockLattice3D of any storage, with its cells and dynamics
+    SoABlockLattice3D(BlockLattice3D<T,Descriptor> const& rhs);
+    SoABlockLattice3D(SoABlockLattice3D<T,Descriptor,S> const& rhs);
+    ~SoABlockLattice3D();
+    SoABlockLattice3D& operator=(SoABlockLattice3D<T,Descriptor,S> const& rhs);
+    void swap(SoABlockLattice3D& rhs);
+    virtual SoABlockLattice3D<T,Descriptor,S>* clone() const;
+public:
+    /// Read/write access to lattice cells, loaded into the arrays before the next cycle
+    virtual Cell<T,Descriptor>& get(plint iX, plint iY, plint iZ);
+    /// Read only access to lattice cells
+    virtual Cell<T,Descriptor> const& get(plint iX, plint iY, plint iZ) const;
+    virtual void specifyStatisticsStatus(Box3D domain, bool status);
+    virtual void attributeDynamics(plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics);
+    virtual void collide(Box3D domain);
+    virtual void collide();
+    virtual void stream(Box3D domain);
+    virtual void stream();
+    virtual void collideAndStream(Box3D domain);
+    virtual void collideAndStream();
+    /// Get access to data transfer between blocks
+    virtual SoABlockLatticeDataTransfer3D<T,Descriptor,S>& getDataTransfer();
+    /// Get access to data transfer between blocks (const version)
+    virtual SoABlockLatticeDataTransfer3D<T,Descriptor,S> const& getDataTransfer() const;
+public:
+    /// Serialize a cell in the format of Cell::serialize()
+    void serializeCell(plint iX, plint iY, plint iZ, char* data) const;
+    /// Unserialize a cell in the format of Cell::unSerialize()
+    void unSerializeCell(plint iX, plint iY, plint iZ, char const* data);
+private:
+    /// State of a cell with respect to the arrays
+    enum CellState { stale=0, current=1, modified=2 };
+    plint index(plint iX, plint iY, plint iZ) const {
+        return (iX*this->getNy() + iY)*this->getNz() + iZ;
+    }
+    plint ghostedIndex(plint iX, plint iY, plint iZ) const {
+        return ( (iX+ghostWidth)*(this->getNy()+2*ghostWidth) + iY+ghostWidth )
+                   * (this->getNz()+2*ghostWidth) + iZ+ghostWidth;
+    }
+    /// Offset, in the ghosted arrays, of the neighbor in direction iPop
+    plint neighborOffset(plint iPop) const;
+    /// Copy the populations of a stale cell from the arrays
+    void refreshCell(plint iX, plint iY, plint iZ) const;
+    /// Copy the populations of the modified cells into the arrays
+    void loadModifiedCells();
+    /// Code of the run a cell belongs to: 0 for the generic path, else
+    ///   two times (one plus the index of its kernel), plus one with statistics.
+    int computeRunKey(Cell<T,Descriptor> const& cell);
+    /// Collide the cells of the domain and push them into the other arrays
+    void collideAndPush(Box3D domain);
+    /// Collide the cells [iZ0,iZ1] of a line through their dynamics
+    void genericCollideAndPush(plint iX, plint iY, plint iZ0, plint iZ1);
+    /// Bounce back the populations which were pushed out of the domain
+    void bounceBackOutside(Box3D domain);
+    /// Fold the populations pushed into the ghost layer back into the block
+    void foldGhostLayer();
+    /// Make the pushed arrays the current ones
+    void completeStreaming();
+    void allocateAndInitialize();
+    void releaseMemory();
+private:
+    static const plint ghostWidth = Descriptor<T>::vicinity;
+    plint volume, ghostedVolume;
+    S *populations[2];
+    plint currentPopulations;
+    mutable char *cellStates;
+    int *runKeys;
+    std::vector<plint> modifiedCells;
+    std::vector<Dynamics<T,Descriptor>*> kernelDynamics;
+    SoABlockLatticeDataTransfer3D<T,Descriptor,S> dataTransfer;
+};
+
+}  // namespace plb
+
+#endif  // SOA_BLOCK_LATTICE_3D_H
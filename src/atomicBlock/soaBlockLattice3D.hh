@@ -0,0 +1,595 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * A 3D block lattice with structure-of-arrays storage -- generic implementation.
+ */
+#ifndef SOA_BLOCK_LATTICE_3D_HH
+#define SOA_BLOCK_LATTICE_3D_HH
+
+#include "atomicBlock/soaBlockLattice3D.h"
+#include "core/dynamics.h"
+#include "core/cell.h"
+#include "core/plbProfiler.h"
+#include "latticeBoltzmann/indexTemplates.h"
+#include "latticeBoltzmann/soaKernels.h"
+#include <algorithm>
+#include <cstring>
+
+namespace plb {
+
+// Class SoABlockLattice3D /////////////////////////
+
+template<typename T, template<typename U> class Descriptor, typename S>
+SoABlockLattice3D<T,Descriptor,S>::SoABlockLattice3D (
+        plint nx_, plint ny_, plint nz_,
+        Dynamics<T,Descriptor>* backgroundDynamics_ )
+    : BlockLattice3D<T,Descriptor>(nx_, ny_, nz_, backgroundDynamics_),
+      dataTransfer(*this)
+{
+    allocateAndInitialize();
+}
+
+/** The cells and dynamics are copied as by the copy constructor of
+ *  BlockLattice3D, and the populations are then loaded into the arrays.
+ */
+template<typename T, template<typename U> class Descriptor, typename S>
+SoABlockLattice3D<T,Descriptor,S>::SoABlockLattice3D(BlockLattice3D<T,Descriptor> const& rhs)
+    : BlockLattice3D<T,Descriptor>(rhs),
+      dataTransfer(*this)
+{
+    allocateAndInitialize();
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+SoABlockLattice3D<T,Descriptor,S>::SoABlockLattice3D(SoABlockLattice3D<T,Descriptor,S> const& rhs)
+    : BlockLattice3D<T,Descriptor>(rhs),
+      dataTransfer(*this)
+{
+    allocateAndInitialize();
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+SoABlockLattice3D<T,Descriptor,S>::~SoABlockLattice3D()
+{
+    releaseMemory();
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+SoABlockLattice3D<T,Descriptor,S>& SoABlockLattice3D<T,Descriptor,S>::operator= (
+        SoABlockLattice3D<T,Descriptor,S> const& rhs )
+{
+    SoABlockLattice3D<T,Descriptor,S> tmp(rhs);
+    swap(tmp);
+    return *this;
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::swap(SoABlockLattice3D& rhs) {
+    BlockLattice3D<T,Descriptor>::swap(rhs);
+    std::swap(volume, rhs.volume);
+    std::swap(ghostedVolume, rhs.ghostedVolume);
+    std::swap(populations[0], rhs.populations[0]);
+    std::swap(populations[1], rhs.populations[1]);
+    std::swap(currentPopulations, rhs.currentPopulations);
+    std::swap(cellStates, rhs.cellStates);
+    std::swap(runKeys, rhs.runKeys);
+    modifiedCells.swap(rhs.modifiedCells);
+    kernelDynamics.swap(rhs.kernelDynamics);
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+SoABlockLattice3D<T,Descriptor,S>* SoABlockLattice3D<T,Descriptor,S>::clone() const {
+    return new SoABlockLattice3D<T,Descriptor,S>(*this);
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+Cell<T,Descriptor>& SoABlockLattice3D<T,Descriptor,S>::get(plint iX, plint iY, plint iZ) {
+    plint iCell = index(iX,iY,iZ);
+    if (cellStates[iCell] != modified) {
+        refreshCell(iX,iY,iZ);
+        cellStates[iCell] = modified;
+        modifiedCells.push_back(iCell);
+    }
+    return BlockLattice3D<T,Descriptor>::get(iX,iY,iZ);
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+Cell<T,Descriptor> const& SoABlockLattice3D<T,Descriptor,S>::get(plint iX, plint iY, plint iZ) const {
+    refreshCell(iX,iY,iZ);
+    return BlockLattice3D<T,Descriptor>::get(iX,iY,iZ);
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::specifyStatisticsStatus(Box3D domain, bool status) {
+    PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                get(iX,iY,iZ).specifyStatisticsStatus(status);
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::attributeDynamics (
+        plint iX, plint iY, plint iZ, Dynamics<T,Descriptor>* dynamics )
+{
+    // Marks the cell as modified, so that its run is recomputed.
+    get(iX,iY,iZ);
+    BlockLattice3D<T,Descriptor>::attributeDynamics(iX,iY,iZ, dynamics);
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::collide(Box3D domain) {
+    PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                get(iX,iY,iZ);
+            }
+        }
+    }
+    BlockLattice3D<T,Descriptor>::collide(domain);
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::collide() {
+    collide(this->getBoundingBox());
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::stream(Box3D domain) {
+    PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                get(iX,iY,iZ);
+            }
+        }
+    }
+    BlockLattice3D<T,Descriptor>::stream(domain);
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::stream() {
+    // All cells are modified by stream(bounding box), before the periodicity.
+    BlockLattice3D<T,Descriptor>::stream();
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::collideAndStream(Box3D domain) {
+    PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    PLB_PRECONDITION( this->getStreamingPattern()==streaming::swap );
+    global::profiler().start("collStream");
+    global::profiler().increment("collStreamCells", domain.nCells());
+
+    collideAndPush(domain);
+    bounceBackOutside(domain);
+    // The cells outside the domain keep their populations.
+    static const plint q = Descriptor<T>::q;
+    S const* fromPop = populations[currentPopulations];
+    S* toPop = populations[1-currentPopulations];
+    std::vector<Box3D> outside;
+    except(this->getBoundingBox(), domain, outside);
+    for (pluint iBox=0; iBox<outside.size(); ++iBox) {
+        Box3D box = outside[iBox];
+        for (plint iX=box.x0; iX<=box.x1; ++iX) {
+            for (plint iY=box.y0; iY<=box.y1; ++iY) {
+                for (plint iPop=0; iPop<q; ++iPop) {
+                    plint offset = iPop*ghostedVolume;
+                    std::copy( fromPop+offset+ghostedIndex(iX,iY,box.z0),
+                               fromPop+offset+ghostedIndex(iX,iY,box.z1)+1,
+                               toPop+offset+ghostedIndex(iX,iY,box.z0) );
+                }
+            }
+        }
+    }
+    completeStreaming();
+    global::profiler().stop("collStream");
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::collideAndStream() {
+    PLB_PRECONDITION( this->getStreamingPattern()==streaming::swap );
+    global::profiler().start("collStream");
+    global::profiler().increment("collStreamCells", volume);
+    collideAndPush(this->getBoundingBox());
+    foldGhostLayer();
+    completeStreaming();
+    global::profiler().stop("collStream");
+
+    this->executeInternalProcessors();
+    this->evaluateStatistics();
+    this->incrementTime();
+}
+
+/** The lines along z are cut into runs of cells with the same run key,
+ *  which go to the kernel, or through their dynamics for the generic path.
+ */
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::collideAndPush(Box3D domain) {
+    static const plint q = Descriptor<T>::q;
+    loadModifiedCells();
+    S* fromPop = populations[currentPopulations];
+    S* toPop   = populations[1-currentPopulations];
+    plint offsets[q];
+    for (plint iPop=0; iPop<q; ++iPop) {
+        offsets[iPop] = iPop*ghostedVolume + neighborOffset(iPop);
+    }
+    S const* in[q];
+    S* out[q];
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            plint lineIndex = index(iX,iY,0);
+            plint ghostedLineIndex = ghostedIndex(iX,iY,0);
+            plint iZ = domain.z0;
+            while (iZ<=domain.z1) {
+                int key = runKeys[lineIndex+iZ];
+                plint iZ1 = iZ;
+                while (iZ1<domain.z1 && runKeys[lineIndex+iZ1+1]==key) {
+                    ++iZ1;
+                }
+                if (key>1) {
+                    plint start = ghostedLineIndex+iZ;
+                    for (plint iPop=0; iPop<q; ++iPop) {
+                        in[iPop]  = fromPop + iPop*ghostedVolume + start;
+                        out[iPop] = toPop + offsets[iPop] + start;
+                    }
+                    BlockStatistics* statistics = key%2==1 ? &this->getInternalStatistics() : 0;
+                    SoAkernelSelector<T,Descriptor>::collide (
+                            *kernelDynamics[key/2-1], in, out, iZ1-iZ+1, statistics );
+                }
+                else {
+                    genericCollideAndPush(iX, iY, iZ, iZ1);
+                }
+                iZ = iZ1+1;
+            }
+        }
+    }
+}
+
+/** The cell is collided in place, and it is stale afterwards.
+ */
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::genericCollideAndPush (
+        plint iX, plint iY, plint iZ0, plint iZ1 )
+{
+    static const plint q = Descriptor<T>::q;
+    S const* fromPop = populations[currentPopulations];
+    S* toPop   = populations[1-currentPopulations];
+    for (plint iZ=iZ0; iZ<=iZ1; ++iZ) {
+        plint iGhosted = ghostedIndex(iX,iY,iZ);
+        Cell<T,Descriptor>& cell = BlockLattice3D<T,Descriptor>::get(iX,iY,iZ);
+        for (plint iPop=0; iPop<q; ++iPop) {
+            cell[iPop] = fromPop[iPop*ghostedVolume + iGhosted];
+        }
+        cell.collide(this->getInternalStatistics());
+        for (plint iPop=0; iPop<q; ++iPop) {
+            toPop[iPop*ghostedVolume + iGhosted + neighborOffset(iPop)] = (S)cell[iPop];
+        }
+    }
+}
+
+/** For a cell x of the domain whose neighbor x-c_i is outside, the population
+ *  f_i(x) becomes the post-collision f_opp(i)(x), which was pushed to x-c_i.
+ */
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::bounceBackOutside(Box3D domain) {
+    static const plint q = Descriptor<T>::q;
+    S* toPop = populations[1-currentPopulations];
+    std::vector<Box3D> shell;
+    except(domain, domain.enlarge(-ghostWidth), shell);
+    for (pluint iBox=0; iBox<shell.size(); ++iBox) {
+        Box3D box = shell[iBox];
+        for (plint iX=box.x0; iX<=box.x1; ++iX) {
+            for (plint iY=box.y0; iY<=box.y1; ++iY) {
+                for (plint iZ=box.z0; iZ<=box.z1; ++iZ) {
+                    plint iGhosted = ghostedIndex(iX,iY,iZ);
+                    for (plint iPop=1; iPop<q; ++iPop) {
+                        plint prevX = iX - Descriptor<T>::c[iPop][0];
+                        plint prevY = iY - Descriptor<T>::c[iPop][1];
+                        plint prevZ = iZ - Descriptor<T>::c[iPop][2];
+                        if ( !contained(prevX,prevY,prevZ, domain) ) {
+                            plint opp = indexTemplates::opposite<Descriptor<T> >(iPop);
+                            toPop[iPop*ghostedVolume + iGhosted] =
+                                toPop[opp*ghostedVolume + ghostedIndex(prevX,prevY,prevZ)];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/** A population pushed out of the block through a face, edge or corner
+ *  re-enters through the opposite one.
+ */
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::foldGhostLayer() {
+    static const plint q = Descriptor<T>::q;
+    plint nx = this->getNx();
+    plint ny = this->getNy();
+    plint nz = this->getNz();
+    S* toPop = populations[1-currentPopulations];
+    for (plint iX=-ghostWidth; iX<nx+ghostWidth; ++iX) {
+        for (plint iY=-ghostWidth; iY<ny+ghostWidth; ++iY) {
+            bool interiorLine = iX>=0 && iX<nx && iY>=0 && iY<ny;
+            for (plint iZ=-ghostWidth; iZ<nz+ghostWidth; ++iZ) {
+                if (interiorLine && iZ==0) {
+                    // Skip the interior of the line.
+                    iZ = nz-1;
+                    continue;
+                }
+                plint iGhosted = ghostedIndex(iX,iY,iZ);
+                plint iFolded = ghostedIndex((iX+nx)%nx, (iY+ny)%ny, (iZ+nz)%nz);
+                for (plint iPop=1; iPop<q; ++iPop) {
+                    plint prevX = iX - Descriptor<T>::c[iPop][0];
+                    plint prevY = iY - Descriptor<T>::c[iPop][1];
+                    plint prevZ = iZ - Descriptor<T>::c[iPop][2];
+                    if ( prevX>=0 && prevX<nx && prevY>=0 && prevY<ny &&
+                         prevZ>=0 && prevZ<nz )
+                    {
+                        toPop[iPop*ghostedVolume + iFolded] = toPop[iPop*ghostedVolume + iGhosted];
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::completeStreaming() {
+    currentPopulations = 1-currentPopulations;
+    std::fill(cellStates, cellStates+volume, (char)stale);
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+plint SoABlockLattice3D<T,Descriptor,S>::neighborOffset(plint iPop) const {
+    return ( Descriptor<T>::c[iPop][0]*(this->getNy()+2*ghostWidth)
+             + Descriptor<T>::c[iPop][1] ) * (this->getNz()+2*ghostWidth)
+           + Descriptor<T>::c[iPop][2];
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::refreshCell(plint iX, plint iY, plint iZ) const {
+    plint iCell = index(iX,iY,iZ);
+    if (cellStates[iCell] == stale) {
+        Cell<T,Descriptor>& cell =
+            const_cast<Cell<T,Descriptor>&>( BlockLattice3D<T,Descriptor>::get(iX,iY,iZ) );
+        S const* fromPop = populations[currentPopulations];
+        plint iGhosted = ghostedIndex(iX,iY,iZ);
+        for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+            cell[iPop] = fromPop[iPop*ghostedVolume + iGhosted];
+        }
+        cellStates[iCell] = current;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::loadModifiedCells() {
+    S* fromPop = populations[currentPopulations];
+    plint ny = this->getNy();
+    plint nz = this->getNz();
+    for (pluint iModified=0; iModified<modifiedCells.size(); ++iModified) {
+        plint iCell = modifiedCells[iModified];
+        plint iX = iCell / (ny*nz);
+        plint iY = (iCell / nz) % ny;
+        plint iZ = iCell % nz;
+        Cell<T,Descriptor> const& cell = BlockLattice3D<T,Descriptor>::get(iX,iY,iZ);
+        plint iGhosted = ghostedIndex(iX,iY,iZ);
+        for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+            fromPop[iPop*ghostedVolume + iGhosted] = (S)cell[iPop];
+        }
+        runKeys[iCell] = computeRunKey(cell);
+        cellStates[iCell] = current;
+    }
+    modifiedCells.clear();
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+int SoABlockLattice3D<T,Descriptor,S>::computeRunKey(Cell<T,Descriptor> const& cell) {
+    Dynamics<T,Descriptor> const& dynamics = cell.getDynamics();
+    if (!SoAkernelSelector<T,Descriptor>::hasKernel(dynamics)) {
+        return 0;
+    }
+    pluint iKernel=0;
+    while ( iKernel<kernelDynamics.size() &&
+            !SoAkernelSelector<T,Descriptor>::sameKernel(*kernelDynamics[iKernel], dynamics) )
+    {
+        ++iKernel;
+    }
+    if (iKernel==kernelDynamics.size()) {
+        kernelDynamics.push_back(dynamics.clone());
+    }
+    return 2*(int)(iKernel+1) + (cell.takesStatistics() ? 1 : 0);
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::serializeCell(plint iX, plint iY, plint iZ, char* data) const
+{
+    static const plint numPop = Descriptor<T>::numPop;
+    static const plint numExt = Descriptor<T>::ExternalField::numScalars;
+    Cell<T,Descriptor> const& cell = BlockLattice3D<T,Descriptor>::get(iX,iY,iZ);
+    if (cellStates[index(iX,iY,iZ)] == stale) {
+        S const* fromPop = populations[currentPopulations];
+        plint iGhosted = ghostedIndex(iX,iY,iZ);
+        for (plint iPop=0; iPop<numPop; ++iPop) {
+            T value = fromPop[iPop*ghostedVolume + iGhosted];
+            memcpy((void*)(data+iPop*sizeof(T)), (const void*)(&value), sizeof(T));
+        }
+        if (numExt>0) {
+            memcpy((void*)(data+numPop*sizeof(T)), (const void*)(cell.getExternal(0)), numExt*sizeof(T));
+        }
+    }
+    else {
+        cell.serialize(data);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::unSerializeCell(plint iX, plint iY, plint iZ, char const* data)
+{
+    static const plint numPop = Descriptor<T>::numPop;
+    static const plint numExt = Descriptor<T>::ExternalField::numScalars;
+    plint iCell = index(iX,iY,iZ);
+    Cell<T,Descriptor>& cell = BlockLattice3D<T,Descriptor>::get(iX,iY,iZ);
+    if (cellStates[iCell] == modified) {
+        cell.unSerialize(data);
+    }
+    else {
+        S* toPop = populations[currentPopulations];
+        plint iGhosted = ghostedIndex(iX,iY,iZ);
+        for (plint iPop=0; iPop<numPop; ++iPop) {
+            T value;
+            memcpy((void*)(&value), (const void*)(data+iPop*sizeof(T)), sizeof(T));
+            toPop[iPop*ghostedVolume + iGhosted] = (S)value;
+        }
+        if (numExt>0) {
+            memcpy((void*)(cell.getExternal(0)), (const void*)(data+numPop*sizeof(T)), numExt*sizeof(T));
+        }
+        cellStates[iCell] = stale;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+SoABlockLatticeDataTransfer3D<T,Descriptor,S>& SoABlockLattice3D<T,Descriptor,S>::getDataTransfer() {
+    return dataTransfer;
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+SoABlockLatticeDataTransfer3D<T,Descriptor,S> const& SoABlockLattice3D<T,Descriptor,S>::getDataTransfer() const {
+    return dataTransfer;
+}
+
+/** The arrays are filled from the cells, which are all current afterwards.
+ */
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::allocateAndInitialize() {
+    static const plint q = Descriptor<T>::q;
+    plint nx = this->getNx();
+    plint ny = this->getNy();
+    plint nz = this->getNz();
+    volume = nx*ny*nz;
+    ghostedVolume = (nx+2*ghostWidth) * (ny+2*ghostWidth) * (nz+2*ghostWidth);
+    currentPopulations = 0;
+    for (plint iBuffer=0; iBuffer<2; ++iBuffer) {
+        populations[iBuffer] = new S[q*ghostedVolume];
+        std::fill(populations[iBuffer], populations[iBuffer]+q*ghostedVolume, S());
+    }
+    cellStates = new char[volume];
+    runKeys = new int[volume];
+    modifiedCells.resize(volume);
+    for (plint iCell=0; iCell<volume; ++iCell) {
+        cellStates[iCell] = modified;
+        modifiedCells[iCell] = iCell;
+    }
+    loadModifiedCells();
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLattice3D<T,Descriptor,S>::releaseMemory() {
+    delete [] populations[0];
+    delete [] populations[1];
+    delete [] cellStates;
+    delete [] runKeys;
+    for (pluint iKernel=0; iKernel<kernelDynamics.size(); ++iKernel) {
+        delete kernelDynamics[iKernel];
+    }
+}
+
+
+////////////////////// Class SoABlockLatticeDataTransfer3D /////////////////////////
+
+template<typename T, template<typename U> class Descriptor, typename S>
+SoABlockLatticeDataTransfer3D<T,Descriptor,S>::SoABlockLatticeDataTransfer3D (
+        SoABlockLattice3D<T,Descriptor,S>& lattice_ )
+    : BlockLatticeDataTransfer3D<T,Descriptor>(lattice_),
+      lattice(lattice_)
+{ }
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLatticeDataTransfer3D<T,Descriptor,S>::sendStatic (
+        Box3D domain, char* buffer ) const
+{
+    PLB_PRECONDITION( contained(domain, lattice.getBoundingBox()) );
+    plint cellSize = this->staticCellSize();
+    plint iData=0;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                lattice.serializeCell(iX,iY,iZ, buffer+iData);
+                iData += cellSize;
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLatticeDataTransfer3D<T,Descriptor,S>::receiveStatic (
+        Box3D domain, char const* buffer, Dot3D absoluteOffset )
+{
+    PLB_PRECONDITION( contained(domain, lattice.getBoundingBox()) );
+    plint cellSize = this->staticCellSize();
+    plint iData=0;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                lattice.unSerializeCell(iX,iY,iZ, buffer+iData);
+                iData += cellSize;
+            }
+        }
+    }
+}
+
+/** Static data between two lattices with the same storage goes from array
+ *  to array; everything else goes through the cells.
+ */
+template<typename T, template<typename U> class Descriptor, typename S>
+void SoABlockLatticeDataTransfer3D<T,Descriptor,S>::attribute (
+        Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
+        AtomicBlock3D const& from, modif::ModifT kind )
+{
+    SoABlockLattice3D<T,Descriptor,S> const* fromLattice =
+        dynamic_cast<SoABlockLattice3D<T,Descriptor,S> const*>(&from);
+    if (kind!=modif::staticVariables || !fromLattice) {
+        BlockLatticeDataTransfer3D<T,Descriptor>::attribute(toDomain, deltaX, deltaY, deltaZ, from, kind);
+        return;
+    }
+    PLB_PRECONDITION( contained(toDomain, lattice.getBoundingBox()) );
+    std::vector<char> cellData(this->staticCellSize());
+    for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
+        for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
+            for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
+                fromLattice->serializeCell(iX+deltaX,iY+deltaY,iZ+deltaZ, &cellData[0]);
+                lattice.unSerializeCell(iX,iY,iZ, &cellData[0]);
+            }
+        }
+    }
+}
+
+}  // namespace plb
+
+#endif  // SOA_BLOCK_LATTICE_3D_HH
@@ -131,6 +131,10 @@ public:
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics& statistics_);
 
+    /// Collision and streaming of a line of cells, without virtual call per cell
+    virtual void collideAndStreamBulk( Cell<T,Descriptor>*** grid, plint iX, plint iY,
+                                       plint iZ0, plint iZ1, BlockStatistics& statistics );
+
     /// Implementation of the collision step, with imposed macroscopic variables
     virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
                          Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat);
@@ -146,12 +150,75 @@ private:
 };
 
 
-/// Implementation of O(Ma^2) Anechoic dynamics
+/// Default law of the anechoic layers
+namespace anechoicDefaults {
+    /// Absorption coefficient on the outer border of a layer
+    const double sigmaMax = 0.3;
+
+    /// Thickness of a layer in cells: 20 on D3Q27, as the former hard-coded
+    ///   collision of this lattice, 30 on the others
+    template<typename T, template<typename U> class Descriptor>
+    T bufferSize() {
+        return (Descriptor<T>::d == 3 && Descriptor<T>::q == 27) ? (T)20 : (T)30;
+    }
+
+    /// Absorption coefficient at depth x into a layer, 0 on its inner border
+    ///   and 1 on the outer one: sigma = sigmaMax*x^2
+    template<typename T>
+    T sigma(T x) {
+        return (T)sigmaMax*x*x;
+    }
+}
+
+/// Parameters of an anechoic layer, shared by the anechoic dynamics
+///   (AnechoicDynamics, AnechoicMRTdynamics, AnechoicCumulantDynamics). The
+///   absorption coefficient sigma follows from the position delta of the cell
+///   in a layer of buffer_size cells with anechoicDefaults::sigma, unless it
+///   is imposed with setSigma().
+template<typename T, template<typename U> class Descriptor>
+class AnechoicLayerParameters {
+public:
+    AnechoicLayerParameters();
+    virtual ~AnechoicLayerParameters() { }
+    virtual void setDelta(T delta_);
+    virtual T getDelta();
+    virtual void setRhoBar_target(T rhoBar_target_);
+    virtual T getRhoBar_target();
+    virtual void setJ_target(Array<T,Descriptor<T>::d> j_target_);
+    virtual Array<T,Descriptor<T>::d> getJ_target();
+    virtual void setBuffer_size(T buffer_size_);
+    virtual T getBuffer_size();
+    /// Absorption coefficient, recomputed whenever delta or buffer_size change
+    T getSigma() const;
+    /// Impose the absorption coefficient, e.g. from a precomputed profile
+    void setSigma(T sigma_);
+protected:
+    /// Refresh the values a dynamics derives from the targets
+    virtual void updateTargets();
+    /// Append the parameters of the layer to the serialized dynamics
+    void serializeLayer(HierarchicSerializer& serializer) const;
+    void unserializeLayer(HierarchicUnserializer& unserializer);
+private:
+    void updateSigma();
+private:
+    T delta;
+    T rhoBar_target;
+    Array<T,Descriptor<T>::d> j_target;
+    T buffer_size;
+    T sigma;
+};
+
+/// Implementation of O(Ma^2) Anechoic dynamics: BGK collision with an absorption
+///   term -sigma*(fEq - fEq_target). The equilibrium is the complete one on the
+///   lattices for which it is specialized (D2Q9, D3Q27).
 template<typename T, template<typename U> class Descriptor>
-class AnechoicDynamics : public IsoThermalBulkDynamics<T,Descriptor> {
+class AnechoicDynamics : public IsoThermalBulkDynamics<T,Descriptor>,
+                         public AnechoicLayerParameters<T,Descriptor>
+{
 public:
 /* *************** Construction / Destruction ************************ */
     AnechoicDynamics(T omega_);
+    AnechoicDynamics(HierarchicUnserializer& unserializer);
 
     /// Clone the object on its dynamic type.
     virtual AnechoicDynamics<T,Descriptor>* clone() const;
@@ -159,6 +226,12 @@ public:
     /// Return a unique ID for this class.
     virtual int getId() const;
 
+    /// Serialize the dynamics object.
+    virtual void serialize(HierarchicSerializer& serializer) const;
+
+    /// Un-Serialize the dynamics object.
+    virtual void unserialize(HierarchicUnserializer& unserializer);
+
 /* *************** Collision and Equilibrium ************************* */
 
     /// Implementation of the collision step
@@ -173,22 +246,44 @@ public:
     /// Compute equilibrium distribution function
     virtual T computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
                                  T jSqr, T thetaBar=T()) const;
-    virtual void setDelta(T delta);
-    virtual T getDelta();
-    virtual void setRhoBar_target(T rhoBar_target);
-    virtual T getRhoBar_target();
-    virtual void setJ_target(Array<T,Descriptor<T>::d> j_target);
-    virtual Array<T,Descriptor<T>::d> getJ_target();
+    /// Get local value of any generic parameter (anechoicSigma or omega)
+    virtual T getParameter(plint whichParameter) const;
+    /// Set local value of any generic parameter (anechoicSigma or omega)
+    virtual void setParameter(plint whichParameter, T value);
 private:
     virtual void decomposeOrder0(Cell<T,Descriptor> const& cell, std::vector<T>& rawData) const;
     virtual void recomposeOrder0(Cell<T,Descriptor>& cell, std::vector<T> const& rawData) const;
 private:
     static int id;
+};
+
+/// Anechoic dynamics with the plain O(Ma^2) BGK equilibrium on every lattice
+template<typename T, template<typename U> class Descriptor>
+class AnechoicBGKdynamics : public AnechoicDynamics<T,Descriptor> {
+public:
+/* *************** Construction / Destruction ************************ */
+    AnechoicBGKdynamics(T omega_);
+    AnechoicBGKdynamics(HierarchicUnserializer& unserializer);
+
+    /// Clone the object on its dynamic type.
+    virtual AnechoicBGKdynamics<T,Descriptor>* clone() const;
+
+    /// Return a unique ID for this class.
+    virtual int getId() const;
+
+/* *************** Collision and Equilibrium ************************* */
+
+    /// Implementation of the collision step
+    virtual void collide(Cell<T,Descriptor>& cell,
+                         BlockStatistics& statistics_);
+
+    /// Implementation of the collision step, with imposed macroscopic variables
+    virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
+                         Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat);
 private:
-    T delta;
-    T omega;
-    T rhoBar_target;
-    Array<T,Descriptor<T>::d> j_target;
+    T anechoicCollision(Cell<T,Descriptor>& cell, T rhoBar, Array<T,Descriptor<T>::d> const& j);
+private:
+    static int id;
 };
 
 
@@ -721,6 +816,10 @@ public:
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics& statistics_);
 
+    /// Collision and streaming of a line of cells, without virtual call per cell
+    virtual void collideAndStreamBulk( Cell<T,Descriptor>*** grid, plint iX, plint iY,
+                                       plint iZ0, plint iZ1, BlockStatistics& statistics );
+
     /// Implementation of the collision step, with imposed macroscopic variables
     virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
                          Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat);
@@ -329,6 +329,14 @@ void BGKdynamics<T,Descriptor>::collide (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void BGKdynamics<T,Descriptor>::collideAndStreamBulk (
+        Cell<T,Descriptor>*** grid, plint iX, plint iY,
+        plint iZ0, plint iZ1, BlockStatistics& statistics )
+{
+    collideAndStreamBulkStatically(*this, grid, iX, iY, iZ0, iZ1, statistics);
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BGKdynamics<T,Descriptor>::collideExternal (
         Cell<T,Descriptor>& cell, T rhoBar,
@@ -394,18 +402,132 @@ void BGKdynamics<T,Descriptor>::recomposeOrder0 (
 }
 
 
+/* *************** Class AnechoicLayerParameters ******************************************* */
+
+/** By default the cell lies on the inner border of a layer of
+ *  anechoicDefaults::bufferSize() cells and does not absorb, so that the
+ *  anechoic dynamics can also serve as background dynamics.
+ */
+template<typename T, template<typename U> class Descriptor>
+AnechoicLayerParameters<T,Descriptor>::AnechoicLayerParameters()
+    : delta(T()),
+      rhoBar_target(T()),
+      buffer_size(anechoicDefaults::bufferSize<T,Descriptor>())
+{
+    j_target.resetToZero();
+    updateSigma();
+}
+
+// Delta distance because anechoic condition have a buffer
+template<typename T, template<typename U> class Descriptor>
+void AnechoicLayerParameters<T,Descriptor>::setDelta(T delta_){
+    delta = delta_;
+    updateSigma();
+}
+
+template<typename T, template<typename U> class Descriptor>
+T AnechoicLayerParameters<T,Descriptor>::getDelta(){
+    return delta;
+}
+
+// RhoBar_target to develop outflow
+template<typename T, template<typename U> class Descriptor>
+void AnechoicLayerParameters<T,Descriptor>::setRhoBar_target(T rhoBar_target_){
+    rhoBar_target = rhoBar_target_;
+    updateTargets();
+}
+
+template<typename T, template<typename U> class Descriptor>
+T AnechoicLayerParameters<T,Descriptor>::getRhoBar_target(){
+    return rhoBar_target;
+}
+
+// J_target is velocity to anechoic
+template<typename T, template<typename U> class Descriptor>
+void AnechoicLayerParameters<T,Descriptor>::setJ_target(Array<T,Descriptor<T>::d> j_target_){
+    j_target = j_target_;
+    updateTargets();
+}
+
+template<typename T, template<typename U> class Descriptor>
+Array<T,Descriptor<T>::d> AnechoicLayerParameters<T,Descriptor>::getJ_target(){
+    return j_target;
+}
+
+// size anechoic buffer
+template<typename T, template<typename U> class Descriptor>
+void AnechoicLayerParameters<T,Descriptor>::setBuffer_size(T buffer_size_){
+    buffer_size = buffer_size_;
+    updateSigma();
+}
+
+template<typename T, template<typename U> class Descriptor>
+T AnechoicLayerParameters<T,Descriptor>::getBuffer_size(){
+    return buffer_size;
+}
+
+template<typename T, template<typename U> class Descriptor>
+T AnechoicLayerParameters<T,Descriptor>::getSigma() const {
+    return sigma;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicLayerParameters<T,Descriptor>::setSigma(T sigma_) {
+    sigma = sigma_;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicLayerParameters<T,Descriptor>::updateTargets()
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicLayerParameters<T,Descriptor>::serializeLayer(HierarchicSerializer& serializer) const
+{
+    serializer.addValue(delta);
+    serializer.addValue(rhoBar_target);
+    serializer.addValues<T,Descriptor<T>::d>(j_target);
+    serializer.addValue(buffer_size);
+    // Sigma is stored as well, because it may have been imposed with setSigma().
+    serializer.addValue(sigma);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicLayerParameters<T,Descriptor>::unserializeLayer(HierarchicUnserializer& unserializer)
+{
+    unserializer.readValue(delta);
+    unserializer.readValue(rhoBar_target);
+    unserializer.readValues<T,Descriptor<T>::d>(j_target);
+    unserializer.readValue(buffer_size);
+    unserializer.readValue(sigma);
+    updateTargets();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicLayerParameters<T,Descriptor>::updateSigma() {
+    sigma = anechoicDefaults::sigma(delta/buffer_size);
+}
+
+
 /* *************** Class AnechoicDynamics *********************************************** */
 
 template<typename T, template<typename U> class Descriptor>
 int AnechoicDynamics<T,Descriptor>::id =
-    meta::registerOneParamDynamics<T,Descriptor,AnechoicDynamics<T,Descriptor> >("Anechoic");
+    // Not a OneParamDynamics: the parameters of the layer must survive a regeneration.
+    meta::registerGeneralDynamics<T,Descriptor,AnechoicDynamics<T,Descriptor> >("Anechoic");
 
 /** \param omega_ relaxation parameter, related to the dynamic viscosity
  */
 template<typename T, template<typename U> class Descriptor>
 AnechoicDynamics<T,Descriptor>::AnechoicDynamics(T omega_)
     : IsoThermalBulkDynamics<T,Descriptor>(omega_)
-{this->delta = (T) 30;}
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+AnechoicDynamics<T,Descriptor>::AnechoicDynamics(HierarchicUnserializer& unserializer)
+    : IsoThermalBulkDynamics<T,Descriptor>((T)1)
+{
+    unserialize(unserializer);
+}
 
 template<typename T, template<typename U> class Descriptor>
 AnechoicDynamics<T,Descriptor>* AnechoicDynamics<T,Descriptor>::clone() const {
@@ -417,17 +539,27 @@ int AnechoicDynamics<T,Descriptor>::getId() const {
     return id;
 }
 
+template<typename T, template<typename U> class Descriptor>
+void AnechoicDynamics<T,Descriptor>::serialize(HierarchicSerializer& serializer) const
+{
+    IsoThermalBulkDynamics<T,Descriptor>::serialize(serializer);
+    this->serializeLayer(serializer);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicDynamics<T,Descriptor>::unserialize(HierarchicUnserializer& unserializer)
+{
+    IsoThermalBulkDynamics<T,Descriptor>::unserialize(unserializer);
+    this->unserializeLayer(unserializer);
+}
+
 template<typename T, template<typename U> class Descriptor>
 void AnechoicDynamics<T,Descriptor>::collide(Cell<T,Descriptor>& cell, BlockStatistics& statistics){
     T rhoBar;
     Array<T,Descriptor<T>::d> j;
     momentTemplates<T,Descriptor>::get_rhoBar_j(cell, rhoBar, j);
-    //j[0] = 0.001;
-    //j[1] = 0.001; 
-    //std::cout << "velocity x: " << j[0] << " - velocity y: " << j[1] << std::endl;
-    // Some times collide external is called
     T uSqr = dynamicsTemplates<T,Descriptor>::anechoic_ma2_collision(cell, rhoBar, j, 
-        this->getOmega(), this->getDelta(), this->getRhoBar_target(), this->getJ_target());
+        this->getOmega(), this->getSigma(), this->getRhoBar_target(), this->getJ_target());
     if (cell.takesStatistics()) {
         gatherStatistics(statistics, rhoBar, uSqr);
     }
@@ -440,7 +572,7 @@ void AnechoicDynamics<T,Descriptor>::collideExternal (
         Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat )
 {
     dynamicsTemplates<T,Descriptor>::anechoic_ma2_collision(cell, rhoBar, j, this->getOmega(),
-     this->getDelta(), this->getRhoBar_target(), this->getJ_target());
+        this->getSigma(), this->getRhoBar_target(), this->getJ_target());
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -451,37 +583,22 @@ T AnechoicDynamics<T,Descriptor>::computeEquilibrium(plint iPop, T rhoBar, Array
     return dynamicsTemplates<T,Descriptor>::bgk_ma2_equilibrium(iPop, rhoBar, invRho, j, jSqr);
 }
 
-// Delta distance because anechoic condition have a buffer
-template<typename T, template<typename U> class Descriptor>
-void AnechoicDynamics<T,Descriptor>::setDelta(T delta){
-    this->delta = delta;
-}
-
-template<typename T, template<typename U> class Descriptor>
-T AnechoicDynamics<T,Descriptor>::getDelta(){
-    return this->delta;
-}
-
-// RhoBar_target to develop outflow
 template<typename T, template<typename U> class Descriptor>
-void AnechoicDynamics<T,Descriptor>::setRhoBar_target(T rhoBar_target){
-    this->rhoBar_target = rhoBar_target;
-}
-
-template<typename T, template<typename U> class Descriptor>
-T AnechoicDynamics<T,Descriptor>::getRhoBar_target(){
-    return this->rhoBar_target;
-}
-
-// J_target is velocity to anechoic
-template<typename T, template<typename U> class Descriptor>
-void AnechoicDynamics<T,Descriptor>::setJ_target(Array<T,Descriptor<T>::d> j_target){
-    this->j_target = j_target;
+T AnechoicDynamics<T,Descriptor>::getParameter(plint whichParameter) const {
+    if (whichParameter == dynamicParams::anechoicSigma) {
+        return this->getSigma();
+    }
+    return IsoThermalBulkDynamics<T,Descriptor>::getParameter(whichParameter);
 }
 
 template<typename T, template<typename U> class Descriptor>
-Array<T,Descriptor<T>::d> AnechoicDynamics<T,Descriptor>::getJ_target(){
-    return this->j_target;
+void AnechoicDynamics<T,Descriptor>::setParameter(plint whichParameter, T value) {
+    if (whichParameter == dynamicParams::anechoicSigma) {
+        this->setSigma(value);
+    }
+    else {
+        IsoThermalBulkDynamics<T,Descriptor>::setParameter(whichParameter, value);
+    }
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -532,6 +649,73 @@ void AnechoicDynamics<T,Descriptor>::recomposeOrder0 (
     }
 }
 
+/* *************** Class AnechoicBGKdynamics *********************************************** */
+
+template<typename T, template<typename U> class Descriptor>
+int AnechoicBGKdynamics<T,Descriptor>::id =
+    meta::registerGeneralDynamics<T,Descriptor,AnechoicBGKdynamics<T,Descriptor> >("AnechoicBGK");
+
+/** \param omega_ relaxation parameter, related to the dynamic viscosity
+ */
+template<typename T, template<typename U> class Descriptor>
+AnechoicBGKdynamics<T,Descriptor>::AnechoicBGKdynamics(T omega_)
+    : AnechoicDynamics<T,Descriptor>(omega_)
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+AnechoicBGKdynamics<T,Descriptor>::AnechoicBGKdynamics(HierarchicUnserializer& unserializer)
+    : AnechoicDynamics<T,Descriptor>(unserializer)
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+AnechoicBGKdynamics<T,Descriptor>* AnechoicBGKdynamics<T,Descriptor>::clone() const {
+    return new AnechoicBGKdynamics<T,Descriptor>(*this);
+}
+
+template<typename T, template<typename U> class Descriptor>
+int AnechoicBGKdynamics<T,Descriptor>::getId() const {
+    return id;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicBGKdynamics<T,Descriptor>::collide(Cell<T,Descriptor>& cell, BlockStatistics& statistics){
+    T rhoBar;
+    Array<T,Descriptor<T>::d> j;
+    momentTemplates<T,Descriptor>::get_rhoBar_j(cell, rhoBar, j);
+    T uSqr = anechoicCollision(cell, rhoBar, j);
+    if (cell.takesStatistics()) {
+        gatherStatistics(statistics, rhoBar, uSqr);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicBGKdynamics<T,Descriptor>::collideExternal (
+        Cell<T,Descriptor>& cell, T rhoBar,
+        Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat )
+{
+    anechoicCollision(cell, rhoBar, j);
+}
+
+template<typename T, template<typename U> class Descriptor>
+T AnechoicBGKdynamics<T,Descriptor>::anechoicCollision (
+        Cell<T,Descriptor>& cell, T rhoBar, Array<T,Descriptor<T>::d> const& j )
+{
+    T invRho = Descriptor<T>::invRho(rhoBar);
+    T jSqr = VectorTemplate<T,Descriptor>::normSqr(j);
+    Array<T,Descriptor<T>::d> j_target = this->getJ_target();
+    T jSqr_target = VectorTemplate<T,Descriptor>::normSqr(j_target);
+    Array<T,Descriptor<T>::q> fEq, f_target;
+    dynamicsTemplates<T,Descriptor>::bgk_ma2_equilibria( rhoBar, invRho, j, jSqr, fEq );
+    dynamicsTemplates<T,Descriptor>::bgk_ma2_equilibria( this->getRhoBar_target(), invRho,
+                                                         j_target, jSqr_target, f_target );
+    T omega = this->getOmega();
+    T sigma = this->getSigma();
+    for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+        cell[iPop] = ((T)1-omega)*cell[iPop] + omega*fEq[iPop] - sigma*(fEq[iPop]-f_target[iPop]);
+    }
+    return jSqr*invRho*invRho;
+}
+
 /* *************** Class CompleteBGKdynamics *********************************************** */
 
 template<typename T, template<typename U> class Descriptor>
@@ -1740,6 +1924,14 @@ void RegularizedBGKdynamics<T,Descriptor>::collide (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void RegularizedBGKdynamics<T,Descriptor>::collideAndStreamBulk (
+        Cell<T,Descriptor>*** grid, plint iX, plint iY,
+        plint iZ0, plint iZ1, BlockStatistics& statistics )
+{
+    collideAndStreamBulkStatically(*this, grid, iX, iY, iZ0, iZ1, statistics);
+}
+
 template<typename T, template<typename U> class Descriptor>
 void RegularizedBGKdynamics<T,Descriptor>::collideExternal (
         Cell<T,Descriptor>& cell, T rhoBar,
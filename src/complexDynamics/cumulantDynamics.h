@@ -0,0 +1,147 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Cumulant LB dynamics for lattices with 27 velocities in 3D, after
+ * M. Geier et al., Computers and Mathematics with Applications 70 (2015)
+ * 507-547 -- header file.
+ *
+ * - CumulantDynamics: the cumulant collision, with higher-order cumulants
+ *   relaxed to zero (see cumulantTemplates.h).
+ * - AnechoicCumulantDynamics: the same collision, with the absorption term
+ *   -sigma*(fEq - fEq_target) of the anechoic layers.
+ */
+#ifndef CUMULANT_DYNAMICS_H
+#define CUMULANT_DYNAMICS_H
+
+#include "core/globalDefs.h"
+#include "basicDynamics/isoThermalDynamics.h"
+
+namespace plb {
+
+/// Implementation of the cumulant collision step
+/** Defined for D3Q27 only. The deviatoric second-order moments relax with
+ *  omega, the trace with the bulk rate (omega by default, parameter
+ *  dynamicParams::omega_bulk), all higher-order cumulants with rate one,
+ *  which keeps the model stable at omega close to 2.
+ */
+template<typename T, template<typename U> class Descriptor>
+class CumulantDynamics : public IsoThermalBulkDynamics<T,Descriptor> {
+public:
+    /* *************** Construction / Destruction ************************ */
+    CumulantDynamics(T omega_);
+    
+    /// Clone the object on its dynamic type.
+    virtual CumulantDynamics<T,Descriptor>* clone() const;
+    
+    /// Return a unique ID for this class.
+    virtual int getId() const;
+    
+    /* *************** Collision and Equilibrium ************************* */
+    
+    /// Implementation of the collision step
+    virtual void collide(Cell<T,Descriptor>& cell,
+                         BlockStatistics& statistics_);
+    
+    /// Collision and streaming of a line of cells, without virtual call per cell
+    virtual void collideAndStreamBulk( Cell<T,Descriptor>*** grid, plint iX, plint iY,
+                                       plint iZ0, plint iZ1, BlockStatistics& statistics );
+    
+    /// Implementation of the collision step, with imposed macroscopic variables
+    virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
+                                 Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat);
+    
+    /// Compute equilibrium distribution function
+    virtual T computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
+                                 T jSqr, T thetaBar=T()) const;
+    /// Get local value of any generic parameter (omega_bulk or omega)
+    virtual T getParameter(plint whichParameter) const;
+    /// Set local value of any generic parameter (omega_bulk or omega)
+    virtual void setParameter(plint whichParameter, T value);
+private:
+    static int id;
+private:
+    T omegaBulk;
+};
+
+/// Implementation of the anechoic cumulant collision step
+/** The cumulant collision is followed by the absorption term
+ *  -sigma*(fEq - fEq_target) of AnechoicBGKdynamics, with the O(Ma^2)
+ *  equilibrium. The target equilibrium is evaluated only when the targets
+ *  of the layer change.
+ */
+template<typename T, template<typename U> class Descriptor>
+class AnechoicCumulantDynamics : public IsoThermalBulkDynamics<T,Descriptor>,
+                                 public AnechoicLayerParameters<T,Descriptor>
+{
+public:
+    /* *************** Construction / Destruction ************************ */
+    AnechoicCumulantDynamics(T omega_);
+    AnechoicCumulantDynamics(HierarchicUnserializer& unserializer);
+    
+    /// Clone the object on its dynamic type.
+    virtual AnechoicCumulantDynamics<T,Descriptor>* clone() const;
+    
+    /// Return a unique ID for this class.
+    virtual int getId() const;
+
+    /// Serialize the dynamics object.
+    virtual void serialize(HierarchicSerializer& serializer) const;
+
+    /// Un-Serialize the dynamics object.
+    virtual void unserialize(HierarchicUnserializer& unserializer);
+    
+    /* *************** Collision and Equilibrium ************************* */
+    
+    /// Implementation of the collision step
+    virtual void collide(Cell<T,Descriptor>& cell,
+                         BlockStatistics& statistics_);
+    
+    /// Implementation of the collision step, with imposed macroscopic variables
+    virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
+                                 Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat);
+    
+    /// Compute equilibrium distribution function
+    virtual T computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
+                                 T jSqr, T thetaBar=T()) const;
+    /// Get local value of any generic parameter (anechoicSigma, omega_bulk or omega)
+    virtual T getParameter(plint whichParameter) const;
+    /// Set local value of any generic parameter (anechoicSigma, omega_bulk or omega)
+    virtual void setParameter(plint whichParameter, T value);
+protected:
+    /// Refresh the cached target equilibrium
+    virtual void updateTargets();
+private:
+    /// Collision and absorption, for given rhoBar and j; returns uSqr
+    T anechoicCollision(Cell<T,Descriptor>& cell, T rhoBar, Array<T,Descriptor<T>::d> const& j);
+private:
+    static int id;
+private:
+    T omegaBulk;
+    Array<T,Descriptor<T>::q> targetEquilibrium;
+};
+
+}  // namespace plb
+
+#endif  // CUMULANT_DYNAMICS_H
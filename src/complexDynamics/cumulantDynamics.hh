@@ -0,0 +1,259 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Cumulant LB dynamics -- generic implementation.
+ */
+#ifndef CUMULANT_DYNAMICS_HH
+#define CUMULANT_DYNAMICS_HH
+
+#include "complexDynamics/cumulantDynamics.h"
+#include "latticeBoltzmann/cumulantTemplates.h"
+#include "latticeBoltzmann/dynamicsTemplates.h"
+#include "latticeBoltzmann/momentTemplates.h"
+#include "core/latticeStatistics.h"
+
+namespace plb {
+
+/* *************** Class CumulantDynamics *********************************************** */
+
+template<typename T, template<typename U> class Descriptor>
+int CumulantDynamics<T,Descriptor>::id =
+    meta::registerOneParamDynamics<T,Descriptor,CumulantDynamics<T,Descriptor> >("Cumulant");
+
+/** \param omega_ relaxation parameter, related to the dynamic viscosity
+ */
+template<typename T, template<typename U> class Descriptor>
+CumulantDynamics<T,Descriptor>::CumulantDynamics(T omega_ )
+    : IsoThermalBulkDynamics<T,Descriptor>(omega_),
+      omegaBulk(omega_)
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+CumulantDynamics<T,Descriptor>* CumulantDynamics<T,Descriptor>::clone() const {
+    return new CumulantDynamics<T,Descriptor>(*this);
+}
+ 
+template<typename T, template<typename U> class Descriptor>
+int CumulantDynamics<T,Descriptor>::getId() const {
+    return id;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void CumulantDynamics<T,Descriptor>::collide (
+        Cell<T,Descriptor>& cell, BlockStatistics& statistics )
+{
+    T rhoBar;
+    Array<T,Descriptor<T>::d> j;
+    momentTemplates<T,Descriptor>::get_rhoBar_j(cell, rhoBar, j);
+    T uSqr = cumulantTemplates<T,Descriptor>::cumulantCollision(cell, rhoBar, j, this->getOmega(), omegaBulk);
+    if (cell.takesStatistics()) {
+        gatherStatistics(statistics, rhoBar, uSqr);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void CumulantDynamics<T,Descriptor>::collideAndStreamBulk (
+        Cell<T,Descriptor>*** grid, plint iX, plint iY,
+        plint iZ0, plint iZ1, BlockStatistics& statistics )
+{
+    collideAndStreamBulkStatically(*this, grid, iX, iY, iZ0, iZ1, statistics);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void CumulantDynamics<T,Descriptor>::collideExternal (
+        Cell<T,Descriptor>& cell, T rhoBar, Array<T,Descriptor<T>::d> const& j,
+        T thetaBar, BlockStatistics& statistics )
+{
+    T uSqr = cumulantTemplates<T,Descriptor>::cumulantCollision(cell, rhoBar, j, this->getOmega(), omegaBulk);
+    if (cell.takesStatistics()) {
+        gatherStatistics(statistics, rhoBar, uSqr);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+T CumulantDynamics<T,Descriptor>::computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
+                                                     T jSqr, T thetaBar) const
+{
+    T invRho = Descriptor<T>::invRho(rhoBar);
+    return dynamicsTemplates<T,Descriptor>::bgk_ma2_equilibrium(iPop, rhoBar, invRho, j, jSqr);
+}
+
+template<typename T, template<typename U> class Descriptor>
+T CumulantDynamics<T,Descriptor>::getParameter(plint whichParameter) const {
+    if (whichParameter == dynamicParams::omega_bulk) {
+        return omegaBulk;
+    }
+    return IsoThermalBulkDynamics<T,Descriptor>::getParameter(whichParameter);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void CumulantDynamics<T,Descriptor>::setParameter(plint whichParameter, T value) {
+    if (whichParameter == dynamicParams::omega_bulk) {
+        omegaBulk = value;
+    }
+    else {
+        IsoThermalBulkDynamics<T,Descriptor>::setParameter(whichParameter, value);
+    }
+}
+
+/* *************** Class AnechoicCumulantDynamics *********************************************** */
+
+template<typename T, template<typename U> class Descriptor>
+int AnechoicCumulantDynamics<T,Descriptor>::id =
+    // Not a OneParamDynamics: the parameters of the layer must survive a regeneration.
+    meta::registerGeneralDynamics<T,Descriptor,AnechoicCumulantDynamics<T,Descriptor> >("AnechoicCumulant");
+
+/** \param omega_ relaxation parameter, related to the dynamic viscosity
+ */
+template<typename T, template<typename U> class Descriptor>
+AnechoicCumulantDynamics<T,Descriptor>::AnechoicCumulantDynamics(T omega_ )
+    : IsoThermalBulkDynamics<T,Descriptor>(omega_),
+      omegaBulk(omega_)
+{
+    updateTargets();
+}
+
+template<typename T, template<typename U> class Descriptor>
+AnechoicCumulantDynamics<T,Descriptor>::AnechoicCumulantDynamics(HierarchicUnserializer& unserializer)
+    : IsoThermalBulkDynamics<T,Descriptor>((T)1),
+      omegaBulk((T)1)
+{
+    unserialize(unserializer);
+}
+
+template<typename T, template<typename U> class Descriptor>
+AnechoicCumulantDynamics<T,Descriptor>* AnechoicCumulantDynamics<T,Descriptor>::clone() const {
+    return new AnechoicCumulantDynamics<T,Descriptor>(*this);
+}
+ 
+template<typename T, template<typename U> class Descriptor>
+int AnechoicCumulantDynamics<T,Descriptor>::getId() const {
+    return id;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicCumulantDynamics<T,Descriptor>::serialize(HierarchicSerializer& serializer) const
+{
+    IsoThermalBulkDynamics<T,Descriptor>::serialize(serializer);
+    serializer.addValue(omegaBulk);
+    this->serializeLayer(serializer);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicCumulantDynamics<T,Descriptor>::unserialize(HierarchicUnserializer& unserializer)
+{
+    IsoThermalBulkDynamics<T,Descriptor>::unserialize(unserializer);
+    unserializer.readValue(omegaBulk);
+    // Also refreshes the target equilibrium.
+    this->unserializeLayer(unserializer);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicCumulantDynamics<T,Descriptor>::collide (
+        Cell<T,Descriptor>& cell, BlockStatistics& statistics )
+{
+    T rhoBar;
+    Array<T,Descriptor<T>::d> j;
+    momentTemplates<T,Descriptor>::get_rhoBar_j(cell, rhoBar, j);
+    T uSqr = anechoicCollision(cell, rhoBar, j);
+    if (cell.takesStatistics()) {
+        gatherStatistics(statistics, rhoBar, uSqr);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicCumulantDynamics<T,Descriptor>::collideExternal (
+        Cell<T,Descriptor>& cell, T rhoBar, Array<T,Descriptor<T>::d> const& j,
+        T thetaBar, BlockStatistics& statistics )
+{
+    T uSqr = anechoicCollision(cell, rhoBar, j);
+    if (cell.takesStatistics()) {
+        gatherStatistics(statistics, rhoBar, uSqr);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+T AnechoicCumulantDynamics<T,Descriptor>::computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
+                                                             T jSqr, T thetaBar) const
+{
+    T invRho = Descriptor<T>::invRho(rhoBar);
+    return dynamicsTemplates<T,Descriptor>::bgk_ma2_equilibrium(iPop, rhoBar, invRho, j, jSqr);
+}
+
+template<typename T, template<typename U> class Descriptor>
+T AnechoicCumulantDynamics<T,Descriptor>::anechoicCollision (
+        Cell<T,Descriptor>& cell, T rhoBar, Array<T,Descriptor<T>::d> const& j )
+{
+    T uSqr = cumulantTemplates<T,Descriptor>::cumulantCollision(cell, rhoBar, j, this->getOmega(), omegaBulk);
+    T sigma = this->getSigma();
+    if (sigma != T()) {
+        T invRho = Descriptor<T>::invRho(rhoBar);
+        T jSqr = VectorTemplate<T,Descriptor>::normSqr(j);
+        Array<T,Descriptor<T>::q> fEq;
+        dynamicsTemplates<T,Descriptor>::bgk_ma2_equilibria(rhoBar, invRho, j, jSqr, fEq);
+        for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+            cell[iPop] -= sigma*(fEq[iPop]-targetEquilibrium[iPop]);
+        }
+    }
+    return uSqr;
+}
+
+template<typename T, template<typename U> class Descriptor>
+T AnechoicCumulantDynamics<T,Descriptor>::getParameter(plint whichParameter) const {
+    if (whichParameter == dynamicParams::anechoicSigma) {
+        return this->getSigma();
+    }
+    if (whichParameter == dynamicParams::omega_bulk) {
+        return omegaBulk;
+    }
+    return IsoThermalBulkDynamics<T,Descriptor>::getParameter(whichParameter);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicCumulantDynamics<T,Descriptor>::setParameter(plint whichParameter, T value) {
+    if (whichParameter == dynamicParams::anechoicSigma) {
+        this->setSigma(value);
+    }
+    else if (whichParameter == dynamicParams::omega_bulk) {
+        omegaBulk = value;
+    }
+    else {
+        IsoThermalBulkDynamics<T,Descriptor>::setParameter(whichParameter, value);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicCumulantDynamics<T,Descriptor>::updateTargets() {
+    Array<T,Descriptor<T>::d> j_target = this->getJ_target();
+    T rhoBar_target = this->getRhoBar_target();
+    T jSqr_target = VectorTemplate<T,Descriptor>::normSqr(j_target);
+    dynamicsTemplates<T,Descriptor>::bgk_ma2_equilibria (
+            rhoBar_target, Descriptor<T>::invRho(rhoBar_target), j_target, jSqr_target,
+            targetEquilibrium );
+}
+
+}  // namespace plb
+
+#endif  // CUMULANT_DYNAMICS_HH
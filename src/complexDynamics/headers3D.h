@@ -34,6 +34,7 @@
 #include "complexDynamics/advectionDiffusionUnits.h"
 #include "complexDynamics/entropicDynamics.h"
 #include "complexDynamics/mrtDynamics.h"
+#include "complexDynamics/cumulantDynamics.h"
 #include "complexDynamics/trtDynamics.h"
 #include "complexDynamics/variableOmegaDynamics.h"
 #include "complexDynamics/smagorinskyDynamics.h"
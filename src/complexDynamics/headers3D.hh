@@ -33,6 +33,7 @@
 #include "complexDynamics/advectionDiffusionProcessor3D.hh"
 #include "complexDynamics/entropicDynamics.hh"
 #include "complexDynamics/mrtDynamics.hh"
+#include "complexDynamics/cumulantDynamics.hh"
 #include "complexDynamics/trtDynamics.hh"
 #include "complexDynamics/variableOmegaDynamics.hh"
 #include "complexDynamics/smagorinskyDynamics.hh"
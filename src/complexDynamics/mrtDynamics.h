@@ -81,6 +81,10 @@ public:
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics& statistics_);
     
+    /// Collision and streaming of a line of cells, without virtual call per cell
+    virtual void collideAndStreamBulk( Cell<T,Descriptor>*** grid, plint iX, plint iY,
+                                       plint iZ0, plint iZ1, BlockStatistics& statistics );
+    
     /// Implementation of the collision step, with imposed macroscopic variables
     virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
                                  Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat);
@@ -94,16 +98,25 @@ private:
 
 /// Implementation of the Anechoic MRT collision step
 template<typename T, template<typename U> class Descriptor>
-class AnechoicMRTdynamics : public IsoThermalBulkDynamics<T,Descriptor> {
+class AnechoicMRTdynamics : public IsoThermalBulkDynamics<T,Descriptor>,
+                            public AnechoicLayerParameters<T,Descriptor>
+{
 public:
     /* *************** Construction / Destruction ************************ */
     AnechoicMRTdynamics(T omega_);
+    AnechoicMRTdynamics(HierarchicUnserializer& unserializer);
     
     /// Clone the object on its dynamic type.
     virtual AnechoicMRTdynamics<T,Descriptor>* clone() const;
     
     /// Return a unique ID for this class.
     virtual int getId() const;
+
+    /// Serialize the dynamics object.
+    virtual void serialize(HierarchicSerializer& serializer) const;
+
+    /// Un-Serialize the dynamics object.
+    virtual void unserialize(HierarchicUnserializer& unserializer);
     
     /* *************** Collision and Equilibrium ************************* */
     
@@ -118,22 +131,17 @@ public:
     /// Compute equilibrium distribution function
     virtual T computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
                                  T jSqr, T thetaBar=T()) const;
-    virtual void setDelta(T delta);
-    virtual T getDelta();
-    virtual void setRhoBar_target(T rhoBar_target);
-    virtual T getRhoBar_target();
-    virtual void setJ_target(Array<T,Descriptor<T>::d> j_target);
-    virtual Array<T,Descriptor<T>::d> getJ_target();
-    virtual void setBuffer_size(T buffer_size);
-    virtual T getBuffer_size();
+    /// Get local value of any generic parameter (anechoicSigma or omega)
+    virtual T getParameter(plint whichParameter) const;
+    /// Set local value of any generic parameter (anechoicSigma or omega)
+    virtual void setParameter(plint whichParameter, T value);
+protected:
+    /// Refresh the cached target moments
+    virtual void updateTargets();
 private:
     static int id;
 private:
-    T delta;
-    T omega;
-    T rhoBar_target;
-    Array<T,Descriptor<T>::d> j_target;
-    T buffer_size;
+    Array<T,Descriptor<T>::q> targetMoments;
 };
 
 /// Implementation of incompressible MRT dynamics.
@@ -77,6 +77,14 @@ void MRTdynamics<T,Descriptor>::collide (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void MRTdynamics<T,Descriptor>::collideAndStreamBulk (
+        Cell<T,Descriptor>*** grid, plint iX, plint iY,
+        plint iZ0, plint iZ1, BlockStatistics& statistics )
+{
+    collideAndStreamBulkStatically(*this, grid, iX, iY, iZ0, iZ1, statistics);
+}
+
 template<typename T, template<typename U> class Descriptor>
 void MRTdynamics<T,Descriptor>::collideExternal (
         Cell<T,Descriptor>& cell, T rhoBar, Array<T,Descriptor<T>::d> const& j,
@@ -103,14 +111,24 @@ T MRTdynamics<T,Descriptor>::computeEquilibrium(plint iPop, T rhoBar, Array<T,De
 
 template<typename T, template<typename U> class Descriptor>
 int AnechoicMRTdynamics<T,Descriptor>::id =
-    meta::registerOneParamDynamics<T,Descriptor,AnechoicMRTdynamics<T,Descriptor> >("AnechoicMRT");
+    // Not a OneParamDynamics: the parameters of the layer must survive a regeneration.
+    meta::registerGeneralDynamics<T,Descriptor,AnechoicMRTdynamics<T,Descriptor> >("AnechoicMRT");
 
 /** \param omega_ relaxation parameter, related to the dynamic viscosity
  */
 template<typename T, template<typename U> class Descriptor>
 AnechoicMRTdynamics<T,Descriptor>::AnechoicMRTdynamics(T omega_ )
     : IsoThermalBulkDynamics<T,Descriptor>(omega_)
-{ }
+{
+    updateTargets();
+}
+
+template<typename T, template<typename U> class Descriptor>
+AnechoicMRTdynamics<T,Descriptor>::AnechoicMRTdynamics(HierarchicUnserializer& unserializer)
+    : IsoThermalBulkDynamics<T,Descriptor>((T)1)
+{
+    unserialize(unserializer);
+}
 
 template<typename T, template<typename U> class Descriptor>
 AnechoicMRTdynamics<T,Descriptor>* AnechoicMRTdynamics<T,Descriptor>::clone() const {
@@ -122,14 +140,27 @@ int AnechoicMRTdynamics<T,Descriptor>::getId() const {
     return id;
 }
 
+template<typename T, template<typename U> class Descriptor>
+void AnechoicMRTdynamics<T,Descriptor>::serialize(HierarchicSerializer& serializer) const
+{
+    IsoThermalBulkDynamics<T,Descriptor>::serialize(serializer);
+    this->serializeLayer(serializer);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void AnechoicMRTdynamics<T,Descriptor>::unserialize(HierarchicUnserializer& unserializer)
+{
+    IsoThermalBulkDynamics<T,Descriptor>::unserialize(unserializer);
+    // Also refreshes the target moments.
+    this->unserializeLayer(unserializer);
+}
+
 template<typename T, template<typename U> class Descriptor>
 void AnechoicMRTdynamics<T,Descriptor>::collide (
         Cell<T,Descriptor>& cell, BlockStatistics& statistics )
 {
     typedef mrtTemplates<T,Descriptor> mrtTemp;
-    T jSqr = mrtTemp::anechoicMRTCollision(cell, this->getOmega(),
-        this->getDelta(), this->getRhoBar_target(), this->getJ_target(),
-        this->getBuffer_size());
+    T jSqr = mrtTemp::anechoicMRTCollision(cell, this->getOmega(), this->getSigma(), targetMoments);
 
     if (cell.takesStatistics()) {
         T rhoBar = momentTemplates<T,Descriptor>::get_rhoBar(cell);
@@ -159,48 +190,32 @@ T AnechoicMRTdynamics<T,Descriptor>::computeEquilibrium(plint iPop, T rhoBar, Ar
     return dynamicsTemplates<T,Descriptor>::bgk_ma2_equilibrium(iPop, rhoBar, invRho, j, jSqr);
 }
 
-// Delta distance because anechoic condition have a buffer
 template<typename T, template<typename U> class Descriptor>
-void AnechoicMRTdynamics<T,Descriptor>::setDelta(T delta){
-    this->delta = delta;
-}
-
-template<typename T, template<typename U> class Descriptor>
-T AnechoicMRTdynamics<T,Descriptor>::getDelta(){
-    return this->delta;
-}
-
-// RhoBar_target to develop outflow
-template<typename T, template<typename U> class Descriptor>
-void AnechoicMRTdynamics<T,Descriptor>::setRhoBar_target(T rhoBar_target){
-    this->rhoBar_target = rhoBar_target;
-}
-
-template<typename T, template<typename U> class Descriptor>
-T AnechoicMRTdynamics<T,Descriptor>::getRhoBar_target(){
-    return this->rhoBar_target;
-}
-
-// J_target is velocity to anechoic
-template<typename T, template<typename U> class Descriptor>
-void AnechoicMRTdynamics<T,Descriptor>::setJ_target(Array<T,Descriptor<T>::d> j_target){
-    this->j_target = j_target;
-}
-
-template<typename T, template<typename U> class Descriptor>
-Array<T,Descriptor<T>::d> AnechoicMRTdynamics<T,Descriptor>::getJ_target(){
-    return this->j_target;
+T AnechoicMRTdynamics<T,Descriptor>::getParameter(plint whichParameter) const {
+    if (whichParameter == dynamicParams::anechoicSigma) {
+        return this->getSigma();
+    }
+    return IsoThermalBulkDynamics<T,Descriptor>::getParameter(whichParameter);
 }
 
-// size anechoic buffer
 template<typename T, template<typename U> class Descriptor>
-void AnechoicMRTdynamics<T,Descriptor>::setBuffer_size(T buffer_size){
-    this->buffer_size = buffer_size;
+void AnechoicMRTdynamics<T,Descriptor>::setParameter(plint whichParameter, T value) {
+    if (whichParameter == dynamicParams::anechoicSigma) {
+        this->setSigma(value);
+    }
+    else {
+        IsoThermalBulkDynamics<T,Descriptor>::setParameter(whichParameter, value);
+    }
 }
 
+// The target moments depend only on the parameters of the layer, so they
+// are evaluated here once per cell instead of at every collision.
 template<typename T, template<typename U> class Descriptor>
-T AnechoicMRTdynamics<T,Descriptor>::getBuffer_size(){
-    return this->buffer_size;
+void AnechoicMRTdynamics<T,Descriptor>::updateTargets() {
+    Array<T,Descriptor<T>::d> j_target = this->getJ_target();
+    T jSqr_target = VectorTemplate<T,Descriptor>::normSqr(j_target);
+    mrtTemplates<T,Descriptor>::computeEquilibriumMoments (
+            targetMoments, this->getRhoBar_target(), j_target, jSqr_target );
 }
 
 /* *************** Class IncMRTdynamics *********************************************** */
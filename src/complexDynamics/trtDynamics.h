@@ -50,6 +50,10 @@ public:
     virtual void collide(Cell<T,Descriptor>& cell,
                          BlockStatistics& statistics_);
     
+    /// Collision and streaming of a line of cells, without virtual call per cell
+    virtual void collideAndStreamBulk( Cell<T,Descriptor>*** grid, plint iX, plint iY,
+                                       plint iZ0, plint iZ1, BlockStatistics& statistics );
+    
     /// Implementation of the collision step, with imposed macroscopic variables
     virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
                                  Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat);
@@ -98,6 +98,14 @@ void TRTdynamics<T,Descriptor>::collide (
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void TRTdynamics<T,Descriptor>::collideAndStreamBulk (
+        Cell<T,Descriptor>*** grid, plint iX, plint iY,
+        plint iZ0, plint iZ1, BlockStatistics& statistics )
+{
+    collideAndStreamBulkStatically(*this, grid, iX, iY, iZ0, iZ1, statistics);
+}
+
 template<typename T, template<typename U> class Descriptor>
 void TRTdynamics<T,Descriptor>::collideExternal (
         Cell<T,Descriptor>& cell, T rhoBar, Array<T,Descriptor<T>::d> const& j,
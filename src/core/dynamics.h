@@ -53,6 +53,7 @@ namespace dynamicParams {
     // Use 1000 and higher for custom user-defined constants
     const plint smagorinskyConstant = 1010;
     const plint dynamicOmega = 1011;
+    const plint anechoicSigma = 1012; // Absorption coefficient of the anechoic dynamics
 }
 
 template<typename T, template<typename U> class Descriptor> class Cell;
@@ -106,6 +107,17 @@ struct Dynamics {
     virtual void collideExternal(Cell<T,Descriptor>& cell, T rhoBar,
                          Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& stat);
 
+    /// Collide and stream the cells [iZ0,iZ1] of the line (iX,iY) of a 3D grid,
+    ///   which all point to this dynamics.
+    /** Each cell is streamed with swapAndStream3D() right after its collision.
+     *  The default implementation calls collide() on each cell. Dynamics with a
+     *  frequently used collision override it with collideAndStreamBulkStatically(),
+     *  which resolves the call to collide() at compile time, so that it can be
+     *  inlined into the loop.
+     */
+    virtual void collideAndStreamBulk( Cell<T,Descriptor>*** grid, plint iX, plint iY,
+                                       plint iZ0, plint iZ1, BlockStatistics& statistics );
+
     /// Compute equilibrium distribution function
     virtual T computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
                                  T jSqr, T thetaBar=T()) const =0;
@@ -810,6 +822,16 @@ template<typename T, template<typename U> class Descriptor>
 Dynamics<T,Descriptor>* cloneAndInsertAtTopDynamics(Dynamics<T,Descriptor> const& dynamics,
                                                     CompositeDynamics<T,Descriptor>* newTop);
 
+/// Implementation of Dynamics::collideAndStreamBulk() with the collide() method of
+///   DynamicsT, called without virtual dispatch.
+/** If the dynamic type of the object is not DynamicsT, but a class derived from
+ *  it, the default implementation, with a virtual call per cell, is used.
+ */
+template<class DynamicsT, typename T, template<typename U> class Descriptor>
+void collideAndStreamBulkStatically( DynamicsT& dynamics, Cell<T,Descriptor>*** grid,
+                                     plint iX, plint iY, plint iZ0, plint iZ1,
+                                     BlockStatistics& statistics );
+
 /// Clone dynamics object, but remove all components which represent boundary (isBoundary()
 ///   method). Exception is the bottom-most dynamics object which is never removed.
 template<typename T, template<typename U> class Descriptor>
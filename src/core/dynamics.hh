@@ -35,10 +35,12 @@
 #include "core/hierarchicSerializer.h"
 #include "latticeBoltzmann/dynamicsTemplates.h"
 #include "latticeBoltzmann/momentTemplates.h"
+#include "latticeBoltzmann/latticeTemplates.h"
 #include "core/latticeStatistics.h"
 #include "multiGrid/multiGridUtil.h"
 #include <algorithm>
 #include <limits>
+#include <typeinfo>
 
 namespace plb {
 
@@ -127,6 +129,17 @@ void Dynamics<T,Descriptor>::unserialize(HierarchicUnserializer& unserializer)
     this->setOmega(unserializer.readValue<T>());
 }
 
+template<typename T, template<typename U> class Descriptor>
+void Dynamics<T,Descriptor>::collideAndStreamBulk (
+        Cell<T,Descriptor>*** grid, plint iX, plint iY,
+        plint iZ0, plint iZ1, BlockStatistics& statistics )
+{
+    for (plint iZ=iZ0; iZ<=iZ1; ++iZ) {
+        collide(grid[iX][iY][iZ], statistics);
+        gridTemplates3D<T,Descriptor>::swapAndStream3D(grid, iX, iY, iZ);
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void Dynamics<T,Descriptor>::collideExternal (
         Cell<T,Descriptor>& cell, T rhoBar,
@@ -1145,6 +1158,22 @@ Dynamics<T,Descriptor>* cloneAndReplaceBottomDynamics(Dynamics<T,Descriptor> con
     return clonedDynamics;
 }
 
+template<class DynamicsT, typename T, template<typename U> class Descriptor>
+void collideAndStreamBulkStatically( DynamicsT& dynamics, Cell<T,Descriptor>*** grid,
+                                     plint iX, plint iY, plint iZ0, plint iZ1,
+                                     BlockStatistics& statistics )
+{
+    if (typeid(dynamics)==typeid(DynamicsT)) {
+        for (plint iZ=iZ0; iZ<=iZ1; ++iZ) {
+            dynamics.DynamicsT::collide(grid[iX][iY][iZ], statistics);
+            gridTemplates3D<T,Descriptor>::swapAndStream3D(grid, iX, iY, iZ);
+        }
+    }
+    else {
+        dynamics.Dynamics<T,Descriptor>::collideAndStreamBulk(grid, iX, iY, iZ0, iZ1, statistics);
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 Dynamics<T,Descriptor>* cloneAndInsertAtTopDynamics(Dynamics<T,Descriptor> const& dynamics,
                                                     CompositeDynamics<T,Descriptor>* newTop)
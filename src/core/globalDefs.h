@@ -162,6 +162,41 @@ namespace IndexOrdering {
     enum OrderingT {forward, backward, memorySaving};
 }
 
+/// Streaming algorithm of the collide-and-stream cycle of a block lattice.
+/** Signification of constants:
+ *      - swap: Populations are exchanged with the neighbors right after the
+ *              collision of each cell. After every cycle, they are stored in
+ *              natural order.
+ *      - aa:   AA pattern. Even cycles collide the cells in place and store
+ *              the populations in the opposite slots; odd cycles gather them
+ *              from the neighbors, collide, and scatter them back. Every cell
+ *              is accessed once per cycle, and no neighbor is touched in even
+ *              cycles. The populations are in natural order after odd cycles
+ *              only, and data processors are not supported. On a
+ *              multi-block, the envelopes are updated after odd cycles only,
+ *              which halves the communication. With the array of Cell
+ *              objects, swap streaming is in place as well, and the cycles
+ *              of both patterns run at about the same speed on one process.
+ **/
+namespace streaming {
+    enum PatternT {swap, aa};
+}
+
+/// Storage of the populations in the atomic blocks of a multi-block lattice.
+/** Signification of constants:
+ *      - cells: Array of Cell objects (BlockLattice3D).
+ *      - soa:   One array per population, collided by vectorizable kernels
+ *               (SoABlockLattice3D).
+ *      - soaFloat: As soa, with the populations stored in single precision.
+ *               The arithmetic is done with the type of the lattice. This
+ *               halves the memory and the traffic of the populations, for
+ *               flows whose deviation from the rest state is small, e.g.
+ *               acoustics.
+ **/
+namespace storage {
+    enum LayoutT {cells, soa, soaFloat};
+}
+
 /// Sub-domain of an atomic-block, on which for example a data processor is executed.
 /** Signification of constants:
  *      - bulk: Refers to bulk-nodes, without envelope.
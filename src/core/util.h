@@ -368,6 +368,44 @@ inline void linearRepartition(plint x0, plint x1, plint nBlocks,
     }
 }
 
+/// Cut the entries of a vector of weights into nBlocks contiguous ranges of
+///   approximately equal weight. Every range contains at least one entry.
+inline void weightedLinearRepartition(std::vector<double> const& weights, plint nBlocks,
+                                      std::vector<std::pair<plint,plint> >& ranges)
+{
+    PLB_PRECONDITION(nBlocks>0);
+    plint totalSize = (plint)weights.size();
+    PLB_PRECONDITION( nBlocks<=totalSize );
+    double remainingWeight = 0.;
+    for (plint i=0; i<totalSize; ++i) {
+        remainingWeight += weights[i];
+    }
+    ranges.resize(nBlocks);
+    plint currentPos=0;
+    for (plint iRange=0; iRange<nBlocks; ++iRange) {
+        plint lastPos = currentPos;
+        double weight = weights[currentPos];
+        if (iRange==nBlocks-1) {
+            lastPos = totalSize-1;
+            weight = remainingWeight;
+        }
+        else {
+            // Leave at least one entry to each of the following ranges, and
+            //   take the next entry as long as it brings the weight of the
+            //   range closer to the average of the remaining ranges.
+            double target = remainingWeight/(double)(nBlocks-iRange);
+            plint maxPos = totalSize-(nBlocks-iRange);
+            while (lastPos<maxPos && weight+0.5*weights[lastPos+1] <= target) {
+                ++lastPos;
+                weight += weights[lastPos];
+            }
+        }
+        ranges[iRange] = std::pair<plint,plint>(currentPos, lastPos);
+        remainingWeight -= weight;
+        currentPos = lastPos+1;
+    }
+}
+
 /// Extend the size of an int-vector, and initialize new values to -1.
 inline void extendVectorSize(std::vector<int>& vect, pluint fullSize) {
     pluint currentSize = vect.size();
@@ -0,0 +1,194 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Helper functions for the cumulant collision on three-dimensional lattices
+ * with 27 velocities. The populations are transformed into central moments,
+ * relaxed there, and transformed back, one line of three populations at a
+ * time (the "chimera" transform of Geier et al., 2015). All functions work
+ * on a tile of W cells, stored with the cell index as the fastest one, so
+ * that the same code serves a single Cell (W=1) and the vectorized kernels
+ * of structure-of-arrays lattices.
+ */
+#ifndef CUMULANT_TEMPLATES_H
+#define CUMULANT_TEMPLATES_H
+
+#include "core/globalDefs.h"
+#include "core/cell.h"
+#include "core/plbDebug.h"
+
+namespace plb {
+
+/// All helper functions are inside this structure
+/** The 27 populations are handled in the canonical order
+ *  (cx+1)*9 + (cy+1)*3 + (cz+1). After the forward transform, position
+ *  ox*9 + oy*3 + oz holds the central moment of order (ox,oy,oz).
+ *
+ *  The deviatoric second-order moments are relaxed with omega, their trace
+ *  with omegaBulk; with omegaBulk=omega, shear and bulk viscosity are those
+ *  of BGK, while omegaBulk=1 damps the bulk mode (and sound) strongly but
+ *  extends the stable range of omega further towards 2. All cumulants of higher
+ *  order are relaxed to zero (rate one), the value Geier et al. recommend
+ *  for stability: the post-collision central moments of order three to six
+ *  are then those of a Gaussian whose covariance is given by the relaxed
+ *  second-order moments. The Galilean-invariance corrections of the
+ *  original model, relevant at high Mach numbers only, are left out.
+ */
+template<typename T, template<typename U> class Descriptor>
+struct cumulantTemplates {
+
+    /// Canonical position of the population iPop
+    static plint canonicalIndex(plint iPop) {
+        return (Descriptor<T>::c[iPop][0]+1)*9 + (Descriptor<T>::c[iPop][1]+1)*3
+                + (Descriptor<T>::c[iPop][2]+1);
+    }
+
+    /// Collision of n<=W cells, with full populations in canonical order
+    template<plint W>
+    static void collide( T f[27][W], T const rho[W], T const u[3][W],
+                         T omega, T omegaBulk, plint n )
+    {
+        chimeraForward<1,W>(f, u[2], n);
+        chimeraForward<3,W>(f, u[1], n);
+        chimeraForward<9,W>(f, u[0], n);
+        relaxCentralMoments<W>(f, rho, omega, omegaBulk, n);
+        chimeraBackward<9,W>(f, u[0], n);
+        chimeraBackward<3,W>(f, u[1], n);
+        chimeraBackward<1,W>(f, u[2], n);
+    }
+
+    /// Cumulant collision step (imposed rhoBar, j); returns uSqr
+    static T cumulantCollision( Cell<T,Descriptor>& cell, T rhoBar,
+                                Array<T,Descriptor<T>::d> const& j, T omega, T omegaBulk )
+    {
+        PLB_PRECONDITION( Descriptor<T>::d==3 && Descriptor<T>::q==27 );
+        T f[27][1], rho[1], u[3][1];
+        for (plint iPop=0; iPop<27; ++iPop) {
+            f[canonicalIndex(iPop)][0] = cell[iPop] + Descriptor<T>::t[iPop];
+        }
+        rho[0] = Descriptor<T>::fullRho(rhoBar);
+        T invRho = Descriptor<T>::invRho(rhoBar);
+        for (int iD=0; iD<3; ++iD) {
+            u[iD][0] = j[iD]*invRho;
+        }
+        collide<1>(f, rho, u, omega, omegaBulk, 1);
+        for (plint iPop=0; iPop<27; ++iPop) {
+            cell[iPop] = f[canonicalIndex(iPop)][0] - Descriptor<T>::t[iPop];
+        }
+        return u[0][0]*u[0][0] + u[1][0]*u[1][0] + u[2][0]*u[2][0];
+    }
+
+private:
+    /// Raw moments of order 0,1,2 along the lines of stride S, then central ones
+    template<plint S, plint W>
+    static void chimeraForward(T f[27][W], T const* u, plint n)
+    {
+        // The 9 lines along the axis of stride S start at i*outer + j*inner.
+        static const plint outer = S==9 ? 3 : 9;
+        static const plint inner = S==1 ? 3 : 1;
+        for (plint iLine=0; iLine<9; ++iLine) {
+            plint base = (iLine/3)*outer + (iLine%3)*inner;
+            T* fm = f[base];
+            T* f0 = f[base+S];
+            T* fp = f[base+2*S];
+            for (plint k=0; k<n; ++k) {
+                T m0 = fm[k]+f0[k]+fp[k];
+                T m1 = fp[k]-fm[k];
+                T m2 = fp[k]+fm[k];
+                fm[k] = m0;
+                f0[k] = m1 - u[k]*m0;
+                fp[k] = m2 - (T)2*u[k]*m1 + u[k]*u[k]*m0;
+            }
+        }
+    }
+
+    /// Inverse of chimeraForward
+    template<plint S, plint W>
+    static void chimeraBackward(T f[27][W], T const* u, plint n)
+    {
+        // The 9 lines along the axis of stride S start at i*outer + j*inner.
+        static const plint outer = S==9 ? 3 : 9;
+        static const plint inner = S==1 ? 3 : 1;
+        for (plint iLine=0; iLine<9; ++iLine) {
+            plint base = (iLine/3)*outer + (iLine%3)*inner;
+            T* fm = f[base];
+            T* f0 = f[base+S];
+            T* fp = f[base+2*S];
+            for (plint k=0; k<n; ++k) {
+                T m0 = fm[k];
+                T m1 = f0[k] + u[k]*m0;
+                T m2 = fp[k] + (T)2*u[k]*f0[k] + u[k]*u[k]*m0;
+                fm[k] = (T)0.5*(m2-m1);
+                f0[k] = m0-m2;
+                fp[k] = (T)0.5*(m2+m1);
+            }
+        }
+    }
+
+    /// Relaxation of the central moments K[ox*9+oy*3+oz]
+    template<plint W>
+    static void relaxCentralMoments(T K[27][W], T const rho[W], T omega, T omegaBulk, plint n)
+    {
+        const T oneMinusOmega = (T)1-omega;
+        for (plint k=0; k<n; ++k) {
+            // Second order: deviatoric part and trace (equilibrium rho*cs2 per direction).
+            T trace = K[18][k]+K[6][k]+K[2][k];
+            T dxy = oneMinusOmega*(K[18][k]-K[6][k]);
+            T dxz = oneMinusOmega*(K[18][k]-K[2][k]);
+            trace += omegaBulk*(rho[k]-trace);
+            T invRho = (T)1/rho[k];
+            T sxx = (trace+dxy+dxz)/(T)3;
+            T syy = sxx-dxy;
+            T szz = sxx-dxz;
+            T sxy = oneMinusOmega*K[12][k];
+            T sxz = oneMinusOmega*K[10][k];
+            T syz = oneMinusOmega*K[4][k];
+            K[18][k] = sxx;
+            K[6][k]  = syy;
+            K[2][k]  = szz;
+            K[12][k] = sxy;
+            K[10][k] = sxz;
+            K[4][k]  = syz;
+            // Conserved momentum: first-order central moments vanish.
+            K[9][k] = K[3][k] = K[1][k] = T();
+            // Third and fifth order: zero cumulants, zero central moments.
+            K[21][k] = K[15][k] = K[19][k] = K[11][k] = K[7][k] = K[5][k] = K[13][k] = T();
+            K[25][k] = K[23][k] = K[17][k] = T();
+            // Fourth order: products of second-order moments.
+            K[24][k] = (sxx*syy + (T)2*sxy*sxy)*invRho;
+            K[20][k] = (sxx*szz + (T)2*sxz*sxz)*invRho;
+            K[8][k]  = (syy*szz + (T)2*syz*syz)*invRho;
+            K[22][k] = (sxx*syz + (T)2*sxy*sxz)*invRho;
+            K[16][k] = (syy*sxz + (T)2*sxy*syz)*invRho;
+            K[14][k] = (szz*sxy + (T)2*sxz*syz)*invRho;
+            // Sixth order.
+            K[26][k] = ( sxx*syy*szz + (T)2*(sxx*syz*syz + syy*sxz*sxz + szz*sxy*sxy)
+                         + (T)8*sxy*syz*sxz ) * invRho*invRho;
+        }
+    }
+};
+
+}  // namespace plb
+
+#endif  // CUMULANT_TEMPLATES_H
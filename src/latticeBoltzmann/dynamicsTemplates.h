@@ -40,6 +40,162 @@ namespace plb {
 
 template<typename T, class Descriptor> struct dynamicsTemplatesImpl;
 
+/// Equilibria and collisions unrolled at compile time over the populations.
+/** The populations are visited through a template recursion on iPop, so
+ *  that every lattice velocity and weight is a constant for the compiler:
+ *  the vanishing components of c_i drop out of c_i.j, and the equilibria
+ *  are consumed as soon as they are computed, without temporary arrays.
+ *  This gives descriptors without hand-written specializations the speed
+ *  of the specialized ones, and lets the specializations avoid temporaries.
+ *  The arithmetic of the second-order equilibrium is the one of
+ *  dynamicsTemplatesImpl::bgk_ma2_equilibrium.
+ */
+template<typename T, class Descriptor, plint iPop=0, bool end=(iPop==Descriptor::q)>
+struct unrolledDynamicsTemplates {
+
+typedef unrolledDynamicsTemplates<T,Descriptor,iPop+1> Next;
+
+/// c_i.j, without the vanishing components of c_i
+static T c_j(Array<T,Descriptor::d> const& j) {
+    // Starting from -0 instead of +0 lets the compiler drop the first sum.
+    T result = -T();
+    for (int iD=0; iD<Descriptor::d; ++iD) {
+        if (Descriptor::c[iPop][iD]==1) {
+            result += j[iD];
+        }
+        else if (Descriptor::c[iPop][iD]==-1) {
+            result -= j[iD];
+        }
+    }
+    return result;
+}
+
+static T bgk_ma2_equilibrium(T rhoBar, T invRho, Array<T,Descriptor::d> const& j, T jSqr) {
+    T cj = c_j(j);
+    return Descriptor::t[iPop] * (
+           rhoBar + Descriptor::invCs2 * cj +
+           Descriptor::invCs2/(T)2 * invRho * (
+               Descriptor::invCs2 * cj*cj - jSqr )
+       );
+}
+
+static void bgk_ma2_equilibria( T rhoBar, T invRho, Array<T,Descriptor::d> const& j,
+                                T jSqr, Array<T,Descriptor::q>& eqPop )
+{
+    eqPop[iPop] = bgk_ma2_equilibrium(rhoBar, invRho, j, jSqr);
+    Next::bgk_ma2_equilibria(rhoBar, invRho, j, jSqr, eqPop);
+}
+
+static void bgk_ma2_collision( Array<T,Descriptor::q>& f, T rhoBar, T invRho,
+                               Array<T,Descriptor::d> const& j, T jSqr, T omega )
+{
+    f[iPop] *= (T)1-omega;
+    f[iPop] += omega * bgk_ma2_equilibrium(rhoBar, invRho, j, jSqr);
+    Next::bgk_ma2_collision(f, rhoBar, invRho, j, jSqr, omega);
+}
+
+/// BGK collision with the absorption term -sigma*(fEq - fEq_target).
+/** As in dynamicsTemplatesImpl::anechoic_ma2_collision, the target
+ *  equilibrium uses the inverse density of the cell.
+ */
+static void anechoic_ma2_collision( Array<T,Descriptor::q>& f, T rhoBar, T invRho,
+                                    Array<T,Descriptor::d> const& j, T jSqr, T omega, T sigma,
+                                    T rhoBar_target, Array<T,Descriptor::d> const& j_target, T jSqr_target )
+{
+    T fEq = bgk_ma2_equilibrium(rhoBar, invRho, j, jSqr);
+    T f_target = bgk_ma2_equilibrium(rhoBar_target, invRho, j_target, jSqr_target);
+    f[iPop] *= (T)1-omega;
+    f[iPop] += omega * fEq - sigma * (fEq - f_target);
+    Next::anechoic_ma2_collision(f, rhoBar, invRho, j, jSqr, omega, sigma,
+                                 rhoBar_target, j_target, jSqr_target);
+}
+
+/// Factors of the complete (tensor-product) equilibrium.
+/** On lattices whose velocities are all of {-1,0,1}^d (D2Q9, D3Q27), the
+ *  complete second-order equilibrium is rho*prod_iD phi(u_iD, c_iD), with
+ *  phi(u,-1)=(1-3u(1-u))/6, phi(u,0)=(2-3u^2)/3 and phi(u,1)=(1+3u(1+u))/6.
+ *  rhoPhi receives the 3^(d-1) products of rho with the factors of all
+ *  axes but the last one, and phiLast the factors of the last axis.
+ */
+static void completeEquilibriumFactors(T rho, Array<T,Descriptor::d> const& u,
+                                       T rhoPhi[], T phiLast[3])
+{
+    plint n = 1;
+    rhoPhi[0] = rho;
+    for (int iD=0; iD<Descriptor::d; ++iD) {
+        T threeU = (T)3*u[iD];
+        T threeUSqr = threeU*u[iD];
+        T phi[3];
+        phi[0] = ((T)1+threeUSqr-threeU)*((T)1/(T)6);
+        phi[1] = ((T)2-threeUSqr)*((T)1/(T)3);
+        phi[2] = ((T)1+threeUSqr+threeU)*((T)1/(T)6);
+        if (iD==Descriptor::d-1) {
+            phiLast[0] = phi[0];
+            phiLast[1] = phi[1];
+            phiLast[2] = phi[2];
+        }
+        else {
+            for (plint i=n-1; i>=0; --i) {
+                rhoPhi[3*i+2] = rhoPhi[i]*phi[2];
+                rhoPhi[3*i+1] = rhoPhi[i]*phi[1];
+                rhoPhi[3*i]   = rhoPhi[i]*phi[0];
+            }
+            n *= 3;
+        }
+    }
+}
+
+/// Product of the factors of completeEquilibriumFactors for population iPop
+static T complete_product(T const rhoPhi[], T const phiLast[3]) {
+    plint index = 0;
+    for (int iD=0; iD<Descriptor::d-1; ++iD) {
+        index = 3*index + Descriptor::c[iPop][iD]+1;
+    }
+    return rhoPhi[index]*phiLast[Descriptor::c[iPop][Descriptor::d-1]+1];
+}
+
+/// Anechoic collision on the complete equilibrium, see anechoic_ma2_collision.
+/** As f = (1-omega)*f + (omega-sigma)*fEq + sigma*f_target, the factors
+ *  are expected to include the weights of the two equilibria: the ones of
+ *  fEq are computed with the density (omega-sigma)*rho, and the ones of
+ *  f_target with sigma*rho_target.
+ */
+static void anechoic_complete_ma2_collision( Array<T,Descriptor::q>& f, T omega,
+                                             T const rhoPhi[], T const phiLast[3],
+                                             T const rhoPhi_target[], T const phiLast_target[3] )
+{
+    f[iPop] *= (T)1-omega;
+    f[iPop] += complete_product(rhoPhi, phiLast) + complete_product(rhoPhi_target, phiLast_target)
+                   - omega*Descriptor::SkordosFactor()*Descriptor::t[iPop];
+    Next::anechoic_complete_ma2_collision(f, omega, rhoPhi, phiLast, rhoPhi_target, phiLast_target);
+}
+
+};  // struct unrolledDynamicsTemplates
+
+/// End of the recursion over the populations
+template<typename T, class Descriptor, plint iPop>
+struct unrolledDynamicsTemplates<T,Descriptor,iPop,true> {
+
+static void bgk_ma2_equilibria( T rhoBar, T invRho, Array<T,Descriptor::d> const& j,
+                                T jSqr, Array<T,Descriptor::q>& eqPop )
+{ }
+
+static void bgk_ma2_collision( Array<T,Descriptor::q>& f, T rhoBar, T invRho,
+                               Array<T,Descriptor::d> const& j, T jSqr, T omega )
+{ }
+
+static void anechoic_ma2_collision( Array<T,Descriptor::q>& f, T rhoBar, T invRho,
+                                    Array<T,Descriptor::d> const& j, T jSqr, T omega, T sigma,
+                                    T rhoBar_target, Array<T,Descriptor::d> const& j_target, T jSqr_target )
+{ }
+
+static void anechoic_complete_ma2_collision( Array<T,Descriptor::q>& f, T omega,
+                                             T const rhoPhi[], T const phiLast[3],
+                                             T const rhoPhi_target[], T const phiLast_target[3] )
+{ }
+
+};  // struct unrolledDynamicsTemplates, end of recursion
+
 /// This structure forwards the calls to the appropriate helper class
 template<typename T, template<typename U> class Descriptor>
 struct dynamicsTemplates {
@@ -81,11 +237,12 @@ static T bgk_ma2_collision(Cell<T,Descriptor>& cell, T rhoBar, Array<T,Descripto
         ::bgk_ma2_collision(cell.getRawPopulations(), rhoBar, j, omega);
 }
 
+/// BGK collision with an absorption term of coefficient sigma towards the target state
 static T anechoic_ma2_collision(Cell<T,Descriptor>& cell, T rhoBar, 
-    Array<T,Descriptor<T>::d> const& j, T omega, T delta, T rhoBar_target, Array<T,Descriptor<T>::d> j_target)
+    Array<T,Descriptor<T>::d> const& j, T omega, T sigma, T rhoBar_target, Array<T,Descriptor<T>::d> const& j_target)
 {
     return dynamicsTemplatesImpl<T,typename Descriptor<T>::BaseDescriptor>
-        ::anechoic_ma2_collision(cell.getRawPopulations(), rhoBar, j, omega, delta, rhoBar_target, j_target);
+        ::anechoic_ma2_collision(cell.getRawPopulations(), rhoBar, j, omega, sigma, rhoBar_target, j_target);
 }
 
 static T complete_bgk_ma2_collision(Cell<T,Descriptor>& cell, T rhoBar, T invRho, Array<T,Descriptor<T>::d> const& j, T omega)
@@ -233,9 +390,7 @@ static void bgk_ma2_equilibria( T rhoBar, T invRho, Array<T,Descriptor::d>
         const& j,
                                 T jSqr, Array<T,Descriptor::q>& eqPop )
 {
-    for (int iPop=0; iPop<Descriptor::q; ++iPop) {
-        eqPop[iPop] = bgk_ma2_equilibrium(iPop, rhoBar, invRho, j, jSqr);
-    }
+    unrolledDynamicsTemplates<T,Descriptor>::bgk_ma2_equilibria(rhoBar, invRho, j, jSqr, eqPop);
 }
 
 static void complete_bgk_ma2_equilibria( T rhoBar, T invRho, Array<T,Descriptor::d> const& j, 
@@ -255,23 +410,17 @@ static void complete_bgk_ma2_regularize(Array<T,Descriptor::q> &f, T rhoBar, T i
 static T bgk_ma2_collision(Array<T,Descriptor::q>& f, T rhoBar, Array<T,Descriptor::d> const& j, T omega) {
     T invRho = Descriptor::invRho(rhoBar);
     const T jSqr = VectorTemplateImpl<T,Descriptor::d>::normSqr(j);
-    for (plint iPop=0; iPop < Descriptor::q; ++iPop) {
-        f[iPop] *= (T)1-omega;
-        f[iPop] += omega * dynamicsTemplatesImpl<T,Descriptor>::bgk_ma2_equilibrium (
-                                iPop, rhoBar, invRho, j, jSqr );
-    }
+    unrolledDynamicsTemplates<T,Descriptor>::bgk_ma2_collision(f, rhoBar, invRho, j, jSqr, omega);
     return jSqr*invRho*invRho;
 }
 
 static T anechoic_ma2_collision(Array<T,Descriptor::q>& f, T rhoBar, Array<T,Descriptor::d> const& j, T omega, 
-    T delta, T rhoBar_target, Array<T,Descriptor::d> j_target) {
+    T sigma, T rhoBar_target, Array<T,Descriptor::d> const& j_target) {
     T invRho = Descriptor::invRho(rhoBar);
     const T jSqr = VectorTemplateImpl<T,Descriptor::d>::normSqr(j);
-    for (plint iPop=0; iPop < Descriptor::q; ++iPop) {
-        f[iPop] *= (T)1-omega;
-        f[iPop] += omega * dynamicsTemplatesImpl<T,Descriptor>::bgk_ma2_equilibrium (
-                                iPop, rhoBar, invRho, j, jSqr );
-    }
+    const T jSqr_target = VectorTemplateImpl<T,Descriptor::d>::normSqr(j_target);
+    unrolledDynamicsTemplates<T,Descriptor>::anechoic_ma2_collision (
+            f, rhoBar, invRho, j, jSqr, omega, sigma, rhoBar_target, j_target, jSqr_target );
     return jSqr*invRho*invRho;
 }
 
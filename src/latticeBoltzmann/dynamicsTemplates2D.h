@@ -637,12 +637,10 @@ static T bgk_ma2_collision_base(Array<T,D::q>& f, T rhoBar, Array<T,2> const& j,
     return invRho*invRho*jSqr;
 }
 
+/// BGK collision with an absorption term -sigma*(fEq - fEq_target) driving
+///   the cell towards the target density and momentum.
 static T anechoic_ma2_collision_base(Array<T,D::q>& f, T rhoBar, 
-    Array<T,2> const& j, T omega, T invRho, T delta, T rhoBar_target ,Array<T,2> j_target) {
-    // Parameters of Anechoic Condition
-    T total_distance = 30;
-    T sigma_m = 0.3;
-    T sigma_target = sigma_m*((delta/total_distance)*(delta/total_distance));
+    Array<T,2> const& j, T omega, T invRho, T sigma, T rhoBar_target ,Array<T,2> const& j_target) {
     T feq, f_target;
 
     // Constants of BGK D2Q9
@@ -692,7 +690,7 @@ static T anechoic_ma2_collision_base(Array<T,D::q>& f, T rhoBar,
     f[0] *= one_m_omega; f[0] += t0_omega*(C1+C3) + omega*j[0]*ux*uy2;
     feq = D::t[0]*(C1+C3) + j[0]*ux*uy2;
     f_target = D::t[0]*(C1_target + C3_target) + j_target[0]*ux_target*uy2_target;
-    f[0] += -sigma_target*(feq - f_target);
+    f[0] += -sigma*(feq - f_target);
 //     f[0] *= one_m_omega; f[0] += t0_omega * (C1+C3+j[0]*ux*uy2);
 
     // i=1 and i=5
@@ -705,13 +703,13 @@ static T anechoic_ma2_collision_base(Array<T,D::q>& f, T rhoBar,
     feq = D::t[1]*(C1+C2+C3) + 0.25*j[0]*uy*(ux*uy+ux-uy);
     f_target = D::t[1]*(C1_target + C2_target + C3_target) + 0.25*j_target[0]*
     uy_target*(ux_target*uy_target+ux_target-uy_target);
-    f[1] += -sigma_target*(feq - f_target);
+    f[1] += -sigma*(feq - f_target);
     //--
     f[5] *= one_m_omega; f[5] += t1_omega * (C1-C2+C3) + omega*(T)0.25*j[0]*uy*(ux*uy-ux+uy);
     feq = D::t[1]*(C1-C2+C3) + 0.25*j[0]*uy*(ux*uy-ux+uy);
     f_target = D::t[1]*(C1_target - C2_target  +C3_target) + 0.25*j_target[0]*
     uy_target*(ux_target*uy_target - ux_target +uy_target);
-    f[5] += -sigma_target*(feq - f_target);
+    f[5] += -sigma*(feq - f_target);
 
 //     f[1] *= one_m_omega; f[1] += t1_omega * (C1+C2+C3+(T)0.25*j[0]*uy*(ux*uy+ux-uy));
 //     f[5] *= one_m_omega; f[5] += t1_omega * (C1-C2+C3+(T)0.25*j[0]*uy*(ux*uy-ux+uy));
@@ -724,12 +722,12 @@ static T anechoic_ma2_collision_base(Array<T,D::q>& f, T rhoBar,
     f[2] *= one_m_omega; f[2] += t2_omega * (C1+C2+C3) - omega*(T)0.5*j[0]*uy2*(ux-(T)1);
     feq = D::t[2]*(C1+C2+C3) - 0.5*j[0]*uy2*(ux-(T)1);
     f_target = D::t[2]*(C1_target+C2_target+C3_target) - 0.5*j_target[0]*uy2_target*(ux_target-(T)1);
-    f[2] += -sigma_target*(feq - f_target);
+    f[2] += -sigma*(feq - f_target);
     //--
     f[6] *= one_m_omega; f[6] += t2_omega * (C1-C2+C3) - omega*(T)0.5*j[0]*uy2*(ux+(T)1);
     feq = D::t[2]*(C1-C2+C3) - 0.5*j[0]*uy2*(ux+(T)1);
     f_target = D::t[2]*(C1_target-C2_target+C3_target) - 0.5*j_target[0]*uy2_target*(ux_target+(T)1);
-    f[6] += -sigma_target*(feq - f_target);
+    f[6] += -sigma*(feq - f_target);
 //     f[2] *= one_m_omega; f[2] += t2_omega * (C1+C2+C3 - (T)0.5*j[0]*uy2*(ux-(T)1));
 //     f[6] *= one_m_omega; f[6] += t2_omega * (C1-C2+C3 - (T)0.5*j[0]*uy2*(ux+(T)1));
 
@@ -742,13 +740,13 @@ static T anechoic_ma2_collision_base(Array<T,D::q>& f, T rhoBar,
     feq = D::t[1]*(C1+C2+C3) + 0.25*j[0]*uy*(ux*uy-ux-uy);
     f_target = D::t[1]*(C1_target+C2_target+C3_target) + 
     0.25*j_target[0]*uy_target*(ux_target*uy_target-ux_target-uy_target);
-    f[3] += -sigma_target*(feq - f_target);
+    f[3] += -sigma*(feq - f_target);
     //--
     f[7] *= one_m_omega; f[7] += t1_omega * (C1-C2+C3) + omega*(T)0.25*j[0]*uy*(ux*uy+ux+uy);
     feq = D::t[1]*(C1-C2+C3) + 0.25*j[0]*uy*(ux*uy+ux+uy);
     f_target = D::t[1]*(C1_target-C2_target+C3_target) + 
     0.25*j_target[0]*uy_target*(ux_target*uy_target+ux_target+uy_target);
-    f[7] += -sigma_target*(feq - f_target);
+    f[7] += -sigma*(feq - f_target);
 //     f[3] *= one_m_omega; f[3] += t1_omega * (C1+C2+C3 + (T)0.25*j[0]*uy*(ux*uy-ux-uy));
 //     f[7] *= one_m_omega; f[7] += t1_omega * (C1-C2+C3 + (T)0.25*j[0]*uy*(ux*uy+ux+uy));
 
@@ -760,12 +758,12 @@ static T anechoic_ma2_collision_base(Array<T,D::q>& f, T rhoBar,
     f[4] *= one_m_omega; f[4] += t2_omega * (C1+C2+C3) - omega*(T)0.5*j[1]*ux2*(uy-(T)1);
     feq = D::t[2]*(C1+C2+C3) - 0.5*j[1]*ux2*(uy-(T)1);
     f_target = D::t[2]*(C1_target+C2_target+C3_target) - 0.5*j_target[1]*ux2_target*(uy_target-(T)1);
-    f[4] += -sigma_target*(feq - f_target);
+    f[4] += -sigma*(feq - f_target);
     //--
     f[8] *= one_m_omega; f[8] += t2_omega * (C1-C2+C3) - omega*(T)0.5*j[1]*ux2*(uy+(T)1);
     feq = D::t[2]*(C1-C2+C3) - 0.5*j[1]*ux2*(uy+(T)1);
     f_target = D::t[2]*(C1_target-C2_target+C3_target) - 0.5*j_target[1]*ux2_target*(uy_target+(T)1);
-    f[8] += -sigma_target*(feq - f_target);
+    f[8] += -sigma*(feq - f_target);
 //     f[4] *= one_m_omega; f[4] += t2_omega * (C1+C2+C3 - (T)0.5*j[1]*ux2*(uy-(T)1));
 //     f[8] *= one_m_omega; f[8] += t2_omega * (C1-C2+C3 - (T)0.5*j[1]*ux2*(uy+(T)1));
 
@@ -863,8 +861,8 @@ static T bgk_ma2_collision(Array<T,D::q>& f, T rhoBar, Array<T,2> const& j, T om
 }
 
 static T anechoic_ma2_collision(Array<T,D::q>& f, T rhoBar, 
-    Array<T,2> const& j, T omega, T delta, T rhoBar_target, Array<T,2> j_target) {
-    return anechoic_ma2_collision_base(f, rhoBar, j, omega, D::invRho(rhoBar), delta, 
+    Array<T,2> const& j, T omega, T sigma, T rhoBar_target, Array<T,2> const& j_target) {
+    return anechoic_ma2_collision_base(f, rhoBar, j, omega, D::invRho(rhoBar), sigma, 
     rhoBar_target, j_target);
 }
 
@@ -396,6 +396,43 @@ std::vector<plint> const& subIndexOutgoingInternalCorner3D() {
     return subIndexOutgoingInternalCorner3DSingleton.indices;
 }
 
+/// finds the indexes pointing along an orientation of a 3D lattice: on each
+///   axis with a non-zero normal, the velocity has the sign of the normal.
+///   The indexes of the 27 orientations are computed once from Descriptor::c.
+template <typename Descriptor>
+class SubIndexOriented3D {
+private:
+    SubIndexOriented3D()
+    {
+        for (int xNormal=-1; xNormal<=1; ++xNormal) {
+            for (int yNormal=-1; yNormal<=1; ++yNormal) {
+                for (int zNormal=-1; zNormal<=1; ++zNormal) {
+                    std::vector<plint>& oriented = indices[(xNormal+1)*9+(yNormal+1)*3+zNormal+1];
+                    for (plint iVel=0; iVel<Descriptor::q; ++iVel) {
+                        if ( Descriptor::c[iVel][0]*xNormal >= xNormal*xNormal &&
+                             Descriptor::c[iVel][1]*yNormal >= yNormal*yNormal &&
+                             Descriptor::c[iVel][2]*zNormal >= zNormal*zNormal )
+                        {
+                            oriented.push_back(iVel);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<plint> indices[27];
+
+    template <typename Descriptor_>
+    friend std::vector<plint> const& subIndexOriented3D(int xNormal, int yNormal, int zNormal);
+};
+
+template <typename Descriptor>
+std::vector<plint> const& subIndexOriented3D(int xNormal, int yNormal, int zNormal) {
+    static SubIndexOriented3D<Descriptor> subIndexOriented3DSingleton;
+    return subIndexOriented3DSingleton.indices[(xNormal+1)*9+(yNormal+1)*3+zNormal+1];
+}
+
 }  // namespace indexTemplates
 
 }  // namespace plb
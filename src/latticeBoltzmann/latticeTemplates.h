@@ -32,6 +32,7 @@
 #define LATTICE_TEMPLATES_H
 
 #include "core/globalDefs.h"
+#include "core/plbDebug.h"
 #include "core/cell.h"
 #include "core/util.h"
 
@@ -79,4 +80,28 @@ static void swapAndStream3D(Cell<T,Descriptor> ***grid,
 #include "latticeBoltzmann/latticeTemplates2D.h"
 #include "latticeBoltzmann/latticeTemplates3D.h"
 
+namespace plb {
+
+/// Streaming step on a 3D grid, which compiles for all descriptors
+/** For code which is instantiated with 2D descriptors as well, but executed on
+ *  3D lattices only, like Dynamics::collideAndStreamBulk().
+ */
+template<typename T, template<typename U> class Descriptor, int d=Descriptor<T>::d>
+struct gridTemplates3D {
+    static void swapAndStream3D(Cell<T,Descriptor> ***grid, plint iX, plint iY, plint iZ)
+    {
+        PLB_ASSERT( false );
+    }
+};
+
+template<typename T, template<typename U> class Descriptor>
+struct gridTemplates3D<T,Descriptor,3> {
+    static void swapAndStream3D(Cell<T,Descriptor> ***grid, plint iX, plint iY, plint iZ)
+    {
+        latticeTemplates<T,Descriptor>::swapAndStream3D(grid, iX, iY, iZ);
+    }
+};
+
+}  // namespace plb
+
 #endif
@@ -75,13 +75,13 @@ struct mrtTemplates {
         mrtCollision( cell.getRawPopulations(), omega);
     }
 
-    // Anechoic MRT collision step
-    static T anechoicMRTCollision( Cell<T,Descriptor>& cell, T omega, T delta, T rhoBar_target, 
-        Array<T,Descriptor<T>::d> j_target, T buffer_size)
+    /// Anechoic MRT collision step with precomputed absorption coefficient
+    ///   and target equilibrium moments
+    static T anechoicMRTCollision( Cell<T,Descriptor>& cell, T omega, T sigma,
+                                   Array<T,Descriptor<T>::q> const& targetMoments )
     {
         return mrtTemplatesImpl<T,typename Descriptor<T>::SecondBaseDescriptor>::
-        anechoicMRTCollision( cell.getRawPopulations(), omega, delta, 
-            rhoBar_target, j_target, buffer_size);
+        anechoicMRTCollision( cell.getRawPopulations(), omega, sigma, targetMoments );
     }
     
     /// MRT collision step (imposed rhoBar, j)
@@ -154,43 +154,35 @@ template<typename T> struct mrtTemplatesImpl<T, descriptors::MRTD2Q9DescriptorBa
         return jSqr;
     }
 
-    static T anechoicMRTCollision( Array<T,Descriptor::q>& f, const T &omega, T delta, T rhoBar_target, Array<T,2> j_target, T buffer_size)
+    /// Anechoic MRT collision step, with the absorption coefficient and the
+    ///   target moments precomputed once per cell. The equilibrium moments
+    ///   are evaluated on the fly and folded into the relaxation.
+    static T anechoicMRTCollision( Array<T,Descriptor::q>& f, const T &omega,
+                                   T sigma, Array<T,Descriptor::q> const& mt )
     {
-        Array<T,9> m, meq, mt;
-        //pcout << "MRT HERE!!! Legal!!!" << std::endl;
-        // Compute m
+        Array<T,9> m;
         computeMoments(m,f);
         T rhoBar = m[0];
         Array<T,2> j(m[MRTDescriptor::momentumIndexes[0]],m[MRTDescriptor::momentumIndexes[1]]);
         T jSqr = VectorTemplateImpl<T,2>::normSqr(j);
-        
-        // Compute meq
-        computeEquilibriumMoments(meq,rhoBar,j,jSqr);
-        // Compute mt
-        T jSqr_target = VectorTemplateImpl<T,2>::normSqr(j_target);
-        computeEquilibriumMoments(mt, rhoBar_target, j_target, jSqr_target);
+        T invRho = Descriptor::invRho(rhoBar);
 
-        // Parameters of Anechoic Condition
-        T total_distance = buffer_size;
-        T sigma_m = 0.3;
-        // Targets values to anechoic dynamics
-        T sigma_target = sigma_m*((delta/total_distance)*(delta/total_distance));
+        // m <- m - (1-sigma)*meq + sigma*mt, with meq expanded in place.
+        T one_m_sigma = (T)1 - sigma;
+        T jSqr_invRho = jSqr*invRho;
+        m[0] += sigma*mt[0] - one_m_sigma*rhoBar;
+        m[1] += sigma*mt[1] - one_m_sigma*((T)3*jSqr_invRho-(T)2*rhoBar);
+        m[2] += sigma*mt[2] - one_m_sigma*(-(T)3*jSqr_invRho+rhoBar);
+        m[3] += sigma*mt[3] - one_m_sigma*j[0];
+        m[4] += sigma*mt[4] + one_m_sigma*j[0];
+        m[5] += sigma*mt[5] - one_m_sigma*j[1];
+        m[6] += sigma*mt[6] + one_m_sigma*j[1];
+        m[7] += sigma*mt[7] - one_m_sigma*(j[0]*j[0]-j[1]*j[1])*invRho;
+        m[8] += sigma*mt[8] - one_m_sigma*j[1]*j[0]*invRho;
 
-        // Collide in moments
-        m[0] = m[0] + sigma_target*mt[0] - meq[0]*(1 - sigma_target);
-        m[1] = m[1] + sigma_target*mt[1] - meq[1]*(1 - sigma_target);
-        m[2] = m[2] + sigma_target*mt[2] - meq[2]*(1 - sigma_target);
-        m[3] = m[3] + sigma_target*mt[3] - meq[3]*(1 - sigma_target);
-        m[4] = m[4] + sigma_target*mt[4] - meq[4]*(1 - sigma_target);
-        m[5] = m[5] + sigma_target*mt[5] - meq[5]*(1 - sigma_target);
-        m[6] = m[6] + sigma_target*mt[6] - meq[6]*(1 - sigma_target);
-        m[7] = m[7] + sigma_target*mt[7] - meq[7]*(1 - sigma_target);
-        m[8] = m[8] + sigma_target*mt[8] - meq[8]*(1 - sigma_target);
-        
         computef_InvM_Smoments(f, m, omega);
 
         return jSqr;
-        
     }
     
     /// MRT collision step imposed rhoBar and j
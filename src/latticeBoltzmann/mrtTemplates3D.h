@@ -113,33 +113,71 @@ template<typename T> struct mrtTemplatesImpl<T, descriptors::MRTD3Q19DescriptorB
         momentsEq[18] = T();
     }
     
+    /// Sums and differences of the populations of opposite directions
+    /** For iPop=1..9, p[iPop] = f[iPop]+f[iPop+9] and d[iPop] = f[iPop+9]-f[iPop].
+     *  The even moments only depend on p, the odd ones only on d.
+     */
+    static void computePairs(Array<T,10>& p, Array<T,10>& d, const Array<T,Descriptor::q>& f)
+    {
+        p[0] = f[0];
+        d[0] = T();
+        for (plint iPop=1; iPop<10; ++iPop) {
+            p[iPop] = f[iPop]+f[iPop+9];
+            d[iPop] = f[iPop+9]-f[iPop];
+        }
+    }
+
+    /// Computation of all moments from the pair sums and differences
+    static void computeMoments(Array<T,Descriptor::q>& moments,
+                               const Array<T,10>& p, const Array<T,10>& d)
+    {
+        T p123 = p[1]+p[2]+p[3];
+        T p4567 = p[4]+p[5]+p[6]+p[7];
+        T p89 = p[8]+p[9];
+        T p4_9 = p4567+p89;
+        moments[0] = p[0]+p123+p4_9;
+        moments[1] = -(T)30*p[0]-(T)11*p123+(T)8*p4_9;
+        moments[2] = (T)12*p[0]-(T)4*p123+p4_9;
+
+        T d4567 = d[4]+d[5]+d[6]+d[7];
+        T d4589 = d[4]-d[5]+d[8]+d[9];
+        T d6789 = d[6]-d[7]+d[8]-d[9];
+        moments[3] = d[1]+d4567;
+        moments[4] = -(T)4*d[1]+d4567;
+        moments[5] = d[2]+d4589;
+        moments[6] = -(T)4*d[2]+d4589;
+        moments[7] = d[3]+d6789;
+        moments[8] = -(T)4*d[3]+d6789;
+
+        T p4567_89 = p4567-(T)2*p89;
+        T p23 = p[2]+p[3];
+        T p2m3 = p[2]-p[3];
+        T p45m67 = p[4]+p[5]-p[6]-p[7];
+        moments[9] = (T)2*p[1]-p23+p4567_89;
+        moments[10] = -(T)4*p[1]+(T)2*p23+p4567_89;
+        moments[11] = p2m3+p45m67;
+        moments[12] = -(T)2*p2m3+p45m67;
+        moments[13] = p[4]-p[5];
+        moments[14] = p[8]-p[9];
+        moments[15] = p[6]-p[7];
+
+        moments[16] = d[4]+d[5]-d[6]-d[7];
+        moments[17] = -d[4]+d[5]+d[8]+d[9];
+        moments[18] = d[6]-d[7]-d[8]+d[9];
+    }
+
     /// Computation of all moments (specialized for d3q19)
     static void computeMoments(Array<T,Descriptor::q>& moments, const Array<T,Descriptor::q>& f)
     {
-        moments[0] = f[0]+f[1]+f[2]+f[3]+f[4]+f[5]+f[6]+f[7]+f[8]+f[9]+f[10]+f[11]+f[12]+f[13]+f[14]+f[15]+f[16]+f[17]+f[18];
-        moments[1] =
-            -(T)30*f[0]-(T)11*(f[1]+f[2]+f[3]+f[10]+f[11]+f[12])
-            +(T)8*(f[4]+f[5]+f[6]+f[7]+f[8]+f[9]+f[13]+f[14]+f[15]+f[16]+f[17]+f[18]);
-        moments[2] = 12*f[0]-4*f[1]-4*f[2]-4*f[3]+f[4]+f[5]+f[6]+f[7]+f[8]+f[9]-4*f[10]-4*f[11]-4*f[12]+f[13]+f[14]+f[15]+f[16]+f[17]+f[18];
-        moments[3] = -f[1]-f[4]-f[5]-f[6]-f[7]+f[10]+f[13]+f[14]+f[15]+f[16];
-        moments[4] = 4*f[1]-f[4]-f[5]-f[6]-f[7]-4*f[10]+f[13]+f[14]+f[15]+f[16];
-        moments[5] = -f[2]-f[4]+f[5]-f[8]-f[9]+f[11]+f[13]-f[14]+f[17]+f[18];
-        moments[6] = 4*f[2]-f[4]+f[5]-f[8]-f[9]-4*f[11]+f[13]-f[14]+f[17]+f[18];
-        moments[7] = -f[3]-f[6]+f[7]-f[8]+f[9]+f[12]+f[15]-f[16]+f[17]-f[18];
-        moments[8] = 4*f[3]-f[6]+f[7]-f[8]+f[9]-4*f[12]+f[15]-f[16]+f[17]-f[18];
-        moments[9] = 2*f[1]-f[2]-f[3]+f[4]+f[5]+f[6]+f[7]-2*f[8]-2*f[9]+2*f[10]-f[11]-f[12]+f[13]+f[14]+f[15]+f[16]-2*f[17]-2*f[18];
-        moments[10] = -4*f[1]+2*f[2]+2*f[3]+f[4]+f[5]+f[6]+f[7]-2*f[8]-2*f[9]-4*f[10]+2*f[11]+2*f[12]+f[13]+f[14]+f[15]+f[16]-2*f[17]-2*f[18];
-        moments[11] = f[2]-f[3]+f[4]+f[5]-f[6]-f[7]+f[11]-f[12]+f[13]+f[14]-f[15]-f[16];
-        moments[12] = -2*f[2]+2*f[3]+f[4]+f[5]-f[6]-f[7]-2*f[11]+2*f[12]+f[13]+f[14]-f[15]-f[16];
-        moments[13] = f[4]-f[5]+f[13]-f[14];
-        moments[14] = f[8]-f[9]+f[17]-f[18];
-        moments[15] = f[6]-f[7]+f[15]-f[16];
-        moments[16] = -f[4]-f[5]+f[6]+f[7]+f[13]+f[14]-f[15]-f[16];
-        moments[17] = f[4]-f[5]-f[8]-f[9]-f[13]+f[14]+f[17]+f[18];
-        moments[18] = -f[6]+f[7]+f[8]-f[9]+f[15]-f[16]-f[17]+f[18];
-        
+        Array<T,10> p, d;
+        computePairs(p, d, f);
+        computeMoments(moments, p, d);
     }
     
+    /// Relaxation of the moments and back-transform: f -= M^{-1}*S*moments
+    /** Each pair of opposite populations gets a common even part and an
+     *  odd part of opposite sign.
+     */
     static void computef_InvM_Smoments(Array<T,19>& f, const Array<T,19> &moments, const T &omega) 
     {
         T mom0 = moments[0] * MRTDescriptor::S[0];
@@ -166,50 +204,73 @@ template<typename T> struct mrtTemplatesImpl<T, descriptors::MRTD3Q19DescriptorB
         
         f[0] -= mom0tmp-5/(T)399*mom1+1/(T)21*mom2;
         
+        // Rest-to-face pairs (1,10), (2,11), (3,12).
         T mom1tmp = (T)11/(T)2394*mom1;
         T mom2tmp = mom2/(T)63;
+        T face = mom0tmp-mom1tmp-mom2tmp;
         T mom3_m4 = (T)0.1*(mom3-mom4);
-        T mom9_m10 = (mom9-mom10)/(T)18;
-        f[1] -= mom0tmp-mom1tmp-mom2tmp-mom3_m4+mom9_m10;
-        f[10] -= mom0tmp-mom1tmp-mom2tmp+mom3_m4+mom9_m10;
-        
         T mom5_m6 = (T)0.1*(mom5-mom6);
         T mom7_m8 = (T)0.1*(mom7-mom8);
-        mom9_m10 *= (T)0.5;
+        T mom9_m10 = (mom9-mom10)/(T)18;
         T mom11_m12 = (mom11-mom12)/(T)12;
-        f[2] -= mom0tmp-mom1tmp-mom2tmp-mom5_m6-mom9_m10+mom11_m12;
-        f[3] -= mom0tmp-mom1tmp-mom2tmp-mom7_m8-mom9_m10-mom11_m12;
-        f[11] -= mom0tmp-mom1tmp-mom2tmp+mom5_m6-mom9_m10+mom11_m12;
-        f[12] -= mom0tmp-mom1tmp-mom2tmp+mom7_m8-mom9_m10-mom11_m12;
-        
+        T even = face+mom9_m10;
+        f[1] -= even-mom3_m4;
+        f[10] -= even+mom3_m4;
+        mom9_m10 *= (T)0.5;
+        even = face-mom9_m10+mom11_m12;
+        f[2] -= even-mom5_m6;
+        f[11] -= even+mom5_m6;
+        even = face-mom9_m10-mom11_m12;
+        f[3] -= even-mom7_m8;
+        f[12] -= even+mom7_m8;
+        
+        // Edge pairs (4,13), (5,14), (6,15), (7,16), (8,17), (9,18).
         mom1tmp = (T)4/(T)1197*mom1;
         mom2tmp *= (T)0.25;
+        T edge = mom0tmp+mom1tmp+mom2tmp;
+        T mom3_p4 = (T)0.1*mom3+(T)0.025*mom4;
         T mom5_p6 = (T)0.1*mom5+(T)0.025*mom6;
         T mom7_p8 = (T)0.1*mom7+(T)0.025*mom8;
         T mom9_p10 = (mom9+mom10*(T)0.5)/(T)18;
+        T mom11_p12 = (mom11+(T)0.5*mom12)/(T)12;
+        mom13 *= (T)0.25;
         mom14 *= (T)0.25;
+        mom15 *= (T)0.25;
+        mom16 *= (T)0.125;
         mom17 *= (T)0.125;
         mom18 *= (T)0.125;
-        f[8] -= mom0tmp+mom1tmp+mom2tmp-mom5_p6-mom7_p8-mom9_p10+mom14-mom17+mom18;
-        f[9] -= mom0tmp+mom1tmp+mom2tmp-mom5_p6+mom7_p8-mom9_p10-mom14-mom17-mom18;
-        f[17] -= mom0tmp+mom1tmp+mom2tmp+mom5_p6+mom7_p8-mom9_p10+mom14+mom17-mom18;
-        f[18] -= mom0tmp+mom1tmp+mom2tmp+mom5_p6-mom7_p8-mom9_p10-mom14+mom17+mom18;
-        
-        T mom3_p4 = (T)0.1*mom3+(T)0.025*mom4;
+        T odd;
+
+        T edgeYZ = edge-mom9_p10;
+        even = edgeYZ+mom14;
+        odd = mom5_p6+mom7_p8+mom17-mom18;
+        f[8] -= even-odd;
+        f[17] -= even+odd;
+        even = edgeYZ-mom14;
+        odd = mom5_p6-mom7_p8+mom17+mom18;
+        f[9] -= even-odd;
+        f[18] -= even+odd;
+
         mom9_p10 *= (T)0.5;
-        T mom11_p12 = (mom11+(T)0.5*mom12)/(T)12;
-        mom13 *= (T)0.25;
-        mom16 *= (T)0.125;
-        f[4] -= mom0tmp+mom1tmp+mom2tmp-mom3_p4-mom5_p6+mom9_p10+mom11_p12+mom13-mom16+mom17;
-        f[5] -= mom0tmp+mom1tmp+mom2tmp-mom3_p4+mom5_p6+mom9_p10+mom11_p12-mom13-mom16-mom17;
-        f[13] -= mom0tmp+mom1tmp+mom2tmp+mom3_p4+mom5_p6+mom9_p10+mom11_p12+mom13+mom16-mom17;
-        f[14] -= mom0tmp+mom1tmp+mom2tmp+mom3_p4-mom5_p6+mom9_p10+mom11_p12-mom13+mom16+mom17;
-        
-        mom15 *= (T)0.25;
-        f[15] -= mom0tmp+mom1tmp+mom2tmp+mom3_p4+mom7_p8+mom9_p10-mom11_p12+mom15-mom16+mom18;
-        f[16] -= mom0tmp+mom1tmp+mom2tmp+mom3_p4-mom7_p8+mom9_p10-mom11_p12-mom15-mom16-mom18;
-        f[6] -= mom0tmp+mom1tmp+mom2tmp-mom3_p4-mom7_p8+mom9_p10-mom11_p12+mom15+mom16-mom18;
-        f[7] -= mom0tmp+mom1tmp+mom2tmp-mom3_p4+mom7_p8+mom9_p10-mom11_p12-mom15+mom16+mom18;
+        T edgeXY = edge+mom9_p10+mom11_p12;
+        even = edgeXY+mom13;
+        odd = mom3_p4+mom5_p6+mom16-mom17;
+        f[4] -= even-odd;
+        f[13] -= even+odd;
+        even = edgeXY-mom13;
+        odd = mom3_p4-mom5_p6+mom16+mom17;
+        f[5] -= even-odd;
+        f[14] -= even+odd;
+
+        T edgeXZ = edge+mom9_p10-mom11_p12;
+        even = edgeXZ+mom15;
+        odd = mom3_p4+mom7_p8-mom16+mom18;
+        f[6] -= even-odd;
+        f[15] -= even+odd;
+        even = edgeXZ-mom15;
+        odd = mom3_p4-mom7_p8-mom16-mom18;
+        f[7] -= even-odd;
+        f[16] -= even+odd;
     }
     
     static void computeMneqInPlace(Array<T,19> &moments, const Array<T,19> &momentsEq) {
@@ -235,72 +296,89 @@ template<typename T> struct mrtTemplatesImpl<T, descriptors::MRTD3Q19DescriptorB
     }
     
     /// MRT collision step
+    /** The non-equilibrium moments are computed directly, without an array
+     *  of equilibrium moments; those of the conserved moments (rhoBar and j)
+     *  vanish by construction.
+     */
     static T mrtCollision( Array<T,Descriptor::q>& f, const T &omega )
     {
-        Array<T,19> moments, momentsEq;
-        // Compute m
-        computeMoments(moments,f);
-        T rhoBar = moments[0];
-        Array<T,3> j(moments[MRTDescriptor::momentumIndexes[0]],moments[MRTDescriptor::momentumIndexes[1]],moments[MRTDescriptor::momentumIndexes[2]]);
+        Array<T,19> m;
+        computeMoments(m,f);
+        T rhoBar = m[0];
+        Array<T,3> j(m[MRTDescriptor::momentumIndexes[0]],m[MRTDescriptor::momentumIndexes[1]],m[MRTDescriptor::momentumIndexes[2]]);
         T jSqr = VectorTemplateImpl<T,3>::normSqr(j);
-        
-        // Compute meq
-        computeEquilibriumMoments(momentsEq,rhoBar,j,jSqr);
-        computeMneqInPlace(moments,momentsEq); // moments become mNeq
-        computef_InvM_Smoments(f, moments, omega);
-        
+        T invRho = Descriptor::invRho(rhoBar);
+        T jxjx = j[0]*j[0]*invRho;
+        T jyjy = j[1]*j[1]*invRho;
+        T jzjz = j[2]*j[2]*invRho;
+        T jSqr_invRho = jSqr*invRho;
+
+        // m <- m - meq
+        m[0]  = T();
+        m[1] -= (T)19*jSqr_invRho-(T)11*rhoBar;
+        m[2] -= -(T)5.5*jSqr_invRho+(T)3*rhoBar;
+        m[3]  = T();
+        m[4] += ((T)2/(T)3)*j[0];
+        m[5]  = T();
+        m[6] += ((T)2/(T)3)*j[1];
+        m[7]  = T();
+        m[8] += ((T)2/(T)3)*j[2];
+        m[9] -= (T)2*jxjx-jyjy-jzjz;
+        m[10] -= -jxjx+(T)0.5*jyjy+(T)0.5*jzjz;
+        m[11] -= jyjy-jzjz;
+        m[12] -= -(T)0.5*jyjy+(T)0.5*jzjz;
+        m[13] -= j[1]*j[0]*invRho;
+        m[14] -= j[2]*j[1]*invRho;
+        m[15] -= j[2]*j[0]*invRho;
+
+        computef_InvM_Smoments(f, m, omega);
+
         return jSqr;
-        
     }
 
-    /// MRT collision step
-    static T anechoicMRTCollision( Array<T,Descriptor::q>& f, const T &omega, T delta, T rhoBar_target, Array<T,3> j_target, T buffer_size)
+    /// Anechoic MRT collision step, with the absorption coefficient and the
+    ///   target moments precomputed once per cell. The equilibrium moments
+    ///   are evaluated on the fly and folded into the relaxation, so that no
+    ///   temporary equilibrium array is needed.
+    static T anechoicMRTCollision( Array<T,Descriptor::q>& f, const T &omega,
+                                   T sigma, Array<T,Descriptor::q> const& mt )
     {
-        Array<T,19> m, meq, mt;
-        //pcout << "MRT HERE!!! Legal!!!" << std::endl;
-        // Compute m
+        Array<T,19> m;
         computeMoments(m,f);
         T rhoBar = m[0];
         Array<T,3> j(m[MRTDescriptor::momentumIndexes[0]],m[MRTDescriptor::momentumIndexes[1]],m[MRTDescriptor::momentumIndexes[2]]);
         T jSqr = VectorTemplateImpl<T,3>::normSqr(j);
-        
-        // Compute meq
-        computeEquilibriumMoments(meq,rhoBar,j,jSqr);
-        // Compute mt
-        T jSqr_target = VectorTemplateImpl<T,3>::normSqr(j_target);
-        computeEquilibriumMoments(mt, rhoBar_target, j_target, jSqr_target);
-
-        // Parameters of Anechoic Condition
-        T total_distance = buffer_size;
-        T sigma_m = 0.3;
-        // Targets values to anechoic dynamics
-        T sigma_target = sigma_m*((delta/total_distance)*(delta/total_distance));
-
-        // Collide in moments
-        m[0] = m[0] + sigma_target*mt[0] - meq[0]*(1 - sigma_target);
-        m[1] = m[1] + sigma_target*mt[1] - meq[1]*(1 - sigma_target);
-        m[2] = m[2] + sigma_target*mt[2] - meq[2]*(1 - sigma_target);
-        m[3] = m[3] + sigma_target*mt[3] - meq[3]*(1 - sigma_target);
-        m[4] = m[4] + sigma_target*mt[4] - meq[4]*(1 - sigma_target);
-        m[5] = m[5] + sigma_target*mt[5] - meq[5]*(1 - sigma_target);
-        m[6] = m[6] + sigma_target*mt[6] - meq[6]*(1 - sigma_target);
-        m[7] = m[7] + sigma_target*mt[7] - meq[7]*(1 - sigma_target);
-        m[8] = m[8] + sigma_target*mt[8] - meq[8]*(1 - sigma_target);
-        m[9] = m[9] + sigma_target*mt[9] - meq[9]*(1 - sigma_target);
-        m[10] = m[10] + sigma_target*mt[10] - meq[10]*(1 - sigma_target);
-        m[11] = m[11] + sigma_target*mt[11] - meq[11]*(1 - sigma_target);
-        m[12] = m[12] + sigma_target*mt[12] - meq[12]*(1 - sigma_target);
-        m[13] = m[13] + sigma_target*mt[13] - meq[13]*(1 - sigma_target);
-        m[14] = m[14] + sigma_target*mt[14] - meq[14]*(1 - sigma_target);
-        m[15] = m[15] + sigma_target*mt[15] - meq[15]*(1 - sigma_target);
-        m[16] = m[16] + sigma_target*mt[16] - meq[16]*(1 - sigma_target);
-        m[17] = m[17] + sigma_target*mt[17] - meq[17]*(1 - sigma_target);
-        m[18] = m[18] + sigma_target*mt[18] - meq[18]*(1 - sigma_target);
+        T invRho = Descriptor::invRho(rhoBar);
+
+        // m <- m - (1-sigma)*meq + sigma*mt, with meq expanded in place.
+        T one_m_sigma = (T)1 - sigma;
+        T jxjx = j[0]*j[0]*invRho;
+        T jyjy = j[1]*j[1]*invRho;
+        T jzjz = j[2]*j[2]*invRho;
+        T jSqr_invRho = jSqr*invRho;
+        m[0]  += sigma*mt[0]  - one_m_sigma*rhoBar;
+        m[1]  += sigma*mt[1]  - one_m_sigma*((T)19*jSqr_invRho-(T)11*rhoBar);
+        m[2]  += sigma*mt[2]  - one_m_sigma*(-(T)5.5*jSqr_invRho+(T)3*rhoBar);
+        m[3]  += sigma*mt[3]  - one_m_sigma*j[0];
+        m[4]  += sigma*mt[4]  + one_m_sigma*((T)2/(T)3)*j[0];
+        m[5]  += sigma*mt[5]  - one_m_sigma*j[1];
+        m[6]  += sigma*mt[6]  + one_m_sigma*((T)2/(T)3)*j[1];
+        m[7]  += sigma*mt[7]  - one_m_sigma*j[2];
+        m[8]  += sigma*mt[8]  + one_m_sigma*((T)2/(T)3)*j[2];
+        m[9]  += sigma*mt[9]  - one_m_sigma*((T)2*jxjx-jyjy-jzjz);
+        m[10] += sigma*mt[10] - one_m_sigma*(-jxjx+(T)0.5*jyjy+(T)0.5*jzjz);
+        m[11] += sigma*mt[11] - one_m_sigma*(jyjy-jzjz);
+        m[12] += sigma*mt[12] - one_m_sigma*(-(T)0.5*jyjy+(T)0.5*jzjz);
+        m[13] += sigma*mt[13] - one_m_sigma*j[1]*j[0]*invRho;
+        m[14] += sigma*mt[14] - one_m_sigma*j[2]*j[1]*invRho;
+        m[15] += sigma*mt[15] - one_m_sigma*j[2]*j[0]*invRho;
+        m[16] += sigma*mt[16];
+        m[17] += sigma*mt[17];
+        m[18] += sigma*mt[18];
 
         computef_InvM_Smoments(f, m, omega);
 
         return jSqr;
-        
     }
     
     /// MRT collision step
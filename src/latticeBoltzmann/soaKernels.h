@@ -0,0 +1,350 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Collision kernels for lattices which store their populations as a
+ * structure of arrays (one contiguous array per direction). A kernel
+ * collides a run of n consecutive cells: the cell k of the run reads its
+ * populations from in[iPop][k] and writes the post-collision populations
+ * to out[iPop][k]. If the statistics are non-null, the kernel gathers the
+ * average rhoBar and the average and maximum uSqr of the run, as the dynamics
+ * does for cells which take statistics. The loops over the run are written
+ * so that the compiler vectorizes them. The populations may be stored with a
+ * type S other than the type T of the arithmetic: they are converted on load
+ * and store. SoAkernelSelector tells which dynamics have a kernel.
+ */
+#ifndef SOA_KERNELS_H
+#define SOA_KERNELS_H
+
+#include "core/globalDefs.h"
+#include "core/array.h"
+#include "core/dynamics.h"
+#include "core/blockStatistics.h"
+#include "core/latticeStatistics.h"
+#include "basicDynamics/isoThermalDynamics.h"
+#include "complexDynamics/mrtDynamics.h"
+#include "complexDynamics/cumulantDynamics.h"
+#include "latticeBoltzmann/nearestNeighborLattices3D.h"
+#include "latticeBoltzmann/mrtLattices.h"
+#include "latticeBoltzmann/mrtTemplates.h"
+#include "latticeBoltzmann/cumulantTemplates.h"
+#include <algorithm>
+#include <typeinfo>
+
+namespace plb {
+
+/// BGK collision with second-order equilibrium, same physics as BGKdynamics.
+/** The run is cut into tiles of a fixed number of cells, which are copied
+ *  into local arrays: the compiler then knows that the arrays of the
+ *  lattice are not aliased, and all loops over the tile are contiguous
+ *  and without branches.
+ */
+template<typename T, template<typename U> class Descriptor>
+struct BGKsoaKernel {
+    BGKsoaKernel(T omega_)
+        : omega(omega_)
+    { }
+    template<typename S>
+    void operator()(S const* const* in, S* const* out, plint n, BlockStatistics* statistics) const
+    {
+        static const int q = Descriptor<T>::q;
+        static const int d = Descriptor<T>::d;
+        static const plint tileSize = 32;
+        const T invCs2 = Descriptor<T>::invCs2;
+        T f[q][tileSize];
+        T rhoBar[tileSize], jSqrTerm[tileSize], cjTerm[tileSize], uSqr[tileSize];
+        T j[d][tileSize];
+        for (plint k0=0; k0<n; k0+=tileSize) {
+            plint w = std::min(tileSize, n-k0);
+            for (int iPop=0; iPop<q; ++iPop) {
+                S const* fIn = in[iPop]+k0;
+                for (plint k=0; k<w; ++k) {
+                    f[iPop][k] = fIn[k];
+                }
+            }
+            // Moments of the tile.
+            for (plint k=0; k<w; ++k) {
+                rhoBar[k] = T();
+            }
+            for (int iD=0; iD<d; ++iD) {
+                for (plint k=0; k<w; ++k) {
+                    j[iD][k] = T();
+                }
+            }
+            for (int iPop=0; iPop<q; ++iPop) {
+                for (plint k=0; k<w; ++k) {
+                    rhoBar[k] += f[iPop][k];
+                }
+                for (int iD=0; iD<d; ++iD) {
+                    const int c = Descriptor<T>::c[iPop][iD];
+                    if (c==1) {
+                        for (plint k=0; k<w; ++k) {
+                            j[iD][k] += f[iPop][k];
+                        }
+                    }
+                    else if (c==-1) {
+                        for (plint k=0; k<w; ++k) {
+                            j[iD][k] -= f[iPop][k];
+                        }
+                    }
+                }
+            }
+            // fEq = t*(rhoBar - invCs2/2*invRho*jSqr) + t*invCs2*(c.j)
+            //         + t*invCs2^2/2*invRho*(c.j)^2
+            for (plint k=0; k<w; ++k) {
+                T invRho = Descriptor<T>::invRho(rhoBar[k]);
+                T jSqr = T();
+                for (int iD=0; iD<d; ++iD) {
+                    jSqr += j[iD][k]*j[iD][k];
+                }
+                jSqrTerm[k] = rhoBar[k] - invCs2/(T)2*invRho*jSqr;
+                cjTerm[k] = invCs2*invCs2/(T)2*invRho;
+                uSqr[k] = jSqr*invRho*invRho;
+            }
+            // Relaxation towards equilibrium, direction by direction.
+            for (int iPop=0; iPop<q; ++iPop) {
+                S* fOut = out[iPop]+k0;
+                const T t = Descriptor<T>::t[iPop];
+                T c[d];
+                for (int iD=0; iD<d; ++iD) {
+                    c[iD] = (T)Descriptor<T>::c[iPop][iD];
+                }
+                for (plint k=0; k<w; ++k) {
+                    T c_j = T();
+                    for (int iD=0; iD<d; ++iD) {
+                        c_j += c[iD]*j[iD][k];
+                    }
+                    T fEq = t * ( jSqrTerm[k] + invCs2*c_j + cjTerm[k]*c_j*c_j );
+                    fOut[k] = (S)( ((T)1-omega)*f[iPop][k] + omega*fEq );
+                }
+            }
+            if (statistics) {
+                for (plint k=0; k<w; ++k) {
+                    gatherStatistics(*statistics, rhoBar[k], uSqr[k]);
+                }
+            }
+        }
+    }
+    T omega;
+};
+
+/// MRT collision, same physics as MRTdynamics.
+/** The collision of every cell is the one of mrtTemplates, with its
+ *  specializations; the kernel saves the virtual call and the cell copy.
+ */
+template<typename T, template<typename U> class Descriptor>
+struct MRTsoaKernel {
+    MRTsoaKernel(T omega_)
+        : omega(omega_)
+    { }
+    template<typename S>
+    void operator()(S const* const* in, S* const* out, plint n, BlockStatistics* statistics) const
+    {
+        static const int q = Descriptor<T>::q;
+        Array<T,q> f;
+        for (plint k=0; k<n; ++k) {
+            for (int iPop=0; iPop<q; ++iPop) {
+                f[iPop] = in[iPop][k];
+            }
+            T jSqr = mrtTemplatesImpl<T,typename Descriptor<T>::SecondBaseDescriptor>::mrtCollision(f, omega);
+            for (int iPop=0; iPop<q; ++iPop) {
+                out[iPop][k] = (S)f[iPop];
+            }
+            if (statistics) {
+                // As in MRTdynamics, rhoBar is taken after the collision.
+                T rhoBar = T();
+                for (int iPop=0; iPop<q; ++iPop) {
+                    rhoBar += f[iPop];
+                }
+                T invRho = Descriptor<T>::invRho(rhoBar);
+                gatherStatistics(*statistics, rhoBar, jSqr*invRho*invRho);
+            }
+        }
+    }
+    T omega;
+};
+
+/// Cumulant collision, same physics as CumulantDynamics (D3Q27 only).
+/** The run is cut into tiles, which are loaded into local arrays in the
+ *  canonical order of cumulantTemplates; the transforms then loop over the
+ *  cells of the tile in the innermost loop.
+ */
+template<typename T, template<typename U> class Descriptor>
+struct CumulantSoaKernel {
+    CumulantSoaKernel(T omega_)
+        : omega(omega_), omegaBulk(omega_)
+    { }
+    CumulantSoaKernel(T omega_, T omegaBulk_)
+        : omega(omega_), omegaBulk(omegaBulk_)
+    { }
+    template<typename S>
+    void operator()(S const* const* in, S* const* out, plint n, BlockStatistics* statistics) const
+    {
+        static const int q = Descriptor<T>::q;
+        static const plint tileSize = 16;
+        PLB_PRECONDITION( q==27 );
+        T f[27][tileSize];
+        T rhoBar[tileSize], rho[tileSize], u[3][tileSize];
+        plint canonical[q];
+        for (int iPop=0; iPop<q; ++iPop) {
+            canonical[iPop] = cumulantTemplates<T,Descriptor>::canonicalIndex(iPop);
+        }
+        for (plint k0=0; k0<n; k0+=tileSize) {
+            plint w = std::min(tileSize, n-k0);
+            for (plint k=0; k<w; ++k) {
+                rhoBar[k] = T();
+                u[0][k] = u[1][k] = u[2][k] = T();
+            }
+            for (int iPop=0; iPop<q; ++iPop) {
+                S const* fIn = in[iPop]+k0;
+                T* fLocal = f[canonical[iPop]];
+                const T t = Descriptor<T>::t[iPop];
+                for (plint k=0; k<w; ++k) {
+                    T fBar = fIn[k];
+                    fLocal[k] = fBar+t;
+                    rhoBar[k] += fBar;
+                }
+                for (int iD=0; iD<3; ++iD) {
+                    const int c = Descriptor<T>::c[iPop][iD];
+                    if (c==1) {
+                        for (plint k=0; k<w; ++k) {
+                            u[iD][k] += fIn[k];
+                        }
+                    }
+                    else if (c==-1) {
+                        for (plint k=0; k<w; ++k) {
+                            u[iD][k] -= fIn[k];
+                        }
+                    }
+                }
+            }
+            for (plint k=0; k<w; ++k) {
+                rho[k] = Descriptor<T>::fullRho(rhoBar[k]);
+                T invRho = Descriptor<T>::invRho(rhoBar[k]);
+                u[0][k] *= invRho;
+                u[1][k] *= invRho;
+                u[2][k] *= invRho;
+            }
+            if (statistics) {
+                // The collision conserves rho and u.
+                for (plint k=0; k<w; ++k) {
+                    gatherStatistics( *statistics, rhoBar[k],
+                                      u[0][k]*u[0][k] + u[1][k]*u[1][k] + u[2][k]*u[2][k] );
+                }
+            }
+            cumulantTemplates<T,Descriptor>::template collide<tileSize>(f, rho, u, omega, omegaBulk, w);
+            for (int iPop=0; iPop<q; ++iPop) {
+                S* fOut = out[iPop]+k0;
+                T const* fLocal = f[canonical[iPop]];
+                const T t = Descriptor<T>::t[iPop];
+                for (plint k=0; k<w; ++k) {
+                    fOut[k] = (S)(fLocal[k]-t);
+                }
+            }
+        }
+    }
+    T omega, omegaBulk;
+};
+
+/// Choice of the kernel which implements the collision of a dynamics object
+/** A kernel exists for BGKdynamics on all descriptors, for MRTdynamics on
+ *  MRTD3Q19Descriptor, and for CumulantDynamics on D3Q27Descriptor. Cells
+ *  whose dynamics have the same kernel can be collided in one run.
+ */
+template<typename T, template<typename U> class Descriptor>
+struct SoAkernelSelector {
+    /// Tell if a kernel implements the collision of the dynamics
+    static bool hasKernel(Dynamics<T,Descriptor> const& dynamics) {
+        return typeid(dynamics) == typeid(BGKdynamics<T,Descriptor>);
+    }
+    /// Tell if two dynamics with a kernel have the same collision
+    static bool sameKernel(Dynamics<T,Descriptor> const& dynamics1, Dynamics<T,Descriptor> const& dynamics2) {
+        return typeid(dynamics1) == typeid(dynamics2) && dynamics1.getOmega() == dynamics2.getOmega();
+    }
+    /// Collide a run of cells with the kernel of the dynamics
+    template<typename S>
+    static void collide( Dynamics<T,Descriptor> const& dynamics, S const* const* in, S* const* out,
+                         plint n, BlockStatistics* statistics )
+    {
+        BGKsoaKernel<T,Descriptor>(dynamics.getOmega())(in, out, n, statistics);
+    }
+};
+
+template<typename T>
+struct SoAkernelSelector<T,descriptors::MRTD3Q19Descriptor> {
+    static bool hasKernel(Dynamics<T,descriptors::MRTD3Q19Descriptor> const& dynamics) {
+        return typeid(dynamics) == typeid(MRTdynamics<T,descriptors::MRTD3Q19Descriptor>) ||
+               typeid(dynamics) == typeid(BGKdynamics<T,descriptors::MRTD3Q19Descriptor>);
+    }
+    static bool sameKernel( Dynamics<T,descriptors::MRTD3Q19Descriptor> const& dynamics1,
+                            Dynamics<T,descriptors::MRTD3Q19Descriptor> const& dynamics2 )
+    {
+        return typeid(dynamics1) == typeid(dynamics2) && dynamics1.getOmega() == dynamics2.getOmega();
+    }
+    template<typename S>
+    static void collide( Dynamics<T,descriptors::MRTD3Q19Descriptor> const& dynamics,
+                         S const* const* in, S* const* out, plint n, BlockStatistics* statistics )
+    {
+        if (typeid(dynamics) == typeid(MRTdynamics<T,descriptors::MRTD3Q19Descriptor>)) {
+            MRTsoaKernel<T,descriptors::MRTD3Q19Descriptor>(dynamics.getOmega())(in, out, n, statistics);
+        }
+        else {
+            BGKsoaKernel<T,descriptors::MRTD3Q19Descriptor>(dynamics.getOmega())(in, out, n, statistics);
+        }
+    }
+};
+
+template<typename T>
+struct SoAkernelSelector<T,descriptors::D3Q27Descriptor> {
+    static bool hasKernel(Dynamics<T,descriptors::D3Q27Descriptor> const& dynamics) {
+        return typeid(dynamics) == typeid(CumulantDynamics<T,descriptors::D3Q27Descriptor>) ||
+               typeid(dynamics) == typeid(BGKdynamics<T,descriptors::D3Q27Descriptor>);
+    }
+    static bool sameKernel( Dynamics<T,descriptors::D3Q27Descriptor> const& dynamics1,
+                            Dynamics<T,descriptors::D3Q27Descriptor> const& dynamics2 )
+    {
+        return typeid(dynamics1) == typeid(dynamics2) &&
+               dynamics1.getOmega() == dynamics2.getOmega() &&
+               ( typeid(dynamics1) != typeid(CumulantDynamics<T,descriptors::D3Q27Descriptor>) ||
+                 dynamics1.getParameter(dynamicParams::omega_bulk) ==
+                     dynamics2.getParameter(dynamicParams::omega_bulk) );
+    }
+    template<typename S>
+    static void collide( Dynamics<T,descriptors::D3Q27Descriptor> const& dynamics,
+                         S const* const* in, S* const* out, plint n, BlockStatistics* statistics )
+    {
+        if (typeid(dynamics) == typeid(CumulantDynamics<T,descriptors::D3Q27Descriptor>)) {
+            CumulantSoaKernel<T,descriptors::D3Q27Descriptor> (
+                    dynamics.getOmega(), dynamics.getParameter(dynamicParams::omega_bulk) )
+                (in, out, n, statistics);
+        }
+        else {
+            BGKsoaKernel<T,descriptors::D3Q27Descriptor>(dynamics.getOmega())(in, out, n, statistics);
+        }
+    }
+};
+
+}  // namespace plb
+
+#endif  // SOA_KERNELS_H
@@ -45,6 +45,26 @@ struct BlockCommunicator3D {
      *  is being transmitted.
      **/
     virtual void duplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const =0;
+    /// Split-phase version of duplicateOverlaps(): post the communication.
+    /** Between startDuplicateOverlaps() and finishDuplicateOverlaps(), the
+     *  sent bulk cells may be modified, but the envelopes must not be
+     *  accessed. The default implementation communicates everything in
+     *  finishDuplicateOverlaps().
+     **/
+    virtual void startDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const
+    { }
+    /// Split-phase version of duplicateOverlaps(): complete the communication.
+    virtual void finishDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const
+    {
+        duplicateOverlaps(multiBlock, whichData);
+    }
+    /// Fill the envelopes only with the static data which points away from
+    ///   the bulk of their block (see BlockDataTransfer3D::sendOriented()).
+    /** The default implementation copies the whole static data. **/
+    virtual void duplicateOrientedOverlaps(MultiBlock3D& multiBlock) const
+    {
+        duplicateOverlaps(multiBlock, modif::staticVariables);
+    }
     /// Transmit data between two multi-blocks, according to a user-defined pattern.
     /** The variable whichData specifies which type of content (static/dynamic/full dynamics object)
      *  is being transmitted.
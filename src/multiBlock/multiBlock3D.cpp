@@ -32,6 +32,7 @@
 #include "multiBlock/multiBlockOperations3D.h"
 #include "multiBlock/multiBlockSerializer3D.h"
 #include "multiBlock/defaultMultiBlockPolicy3D.h"
+#include "parallelism/smpManager.h"
 #include <cmath>
 #include <algorithm>
 
@@ -387,6 +388,18 @@ void MultiBlock3D::duplicateOverlaps(modif::ModifT whichData) {
     this->getBlockCommunicator().duplicateOverlaps(*this, whichData);
 }
 
+void MultiBlock3D::startDuplicateOverlaps(modif::ModifT whichData) {
+    this->getBlockCommunicator().startDuplicateOverlaps(*this, whichData);
+}
+
+void MultiBlock3D::finishDuplicateOverlaps(modif::ModifT whichData) {
+    this->getBlockCommunicator().finishDuplicateOverlaps(*this, whichData);
+}
+
+void MultiBlock3D::duplicateOrientedOverlaps() {
+    this->getBlockCommunicator().duplicateOrientedOverlaps(*this);
+}
+
 void MultiBlock3D::signalPeriodicity() {
     getBlockCommunicator().signalPeriodicity();
 }
@@ -492,15 +505,33 @@ void MultiBlock3D::executeInternalProcessors() {
 
 void MultiBlock3D::executeInternalProcessors(plint level, bool communicate) {
     std::vector<plint> const& blocks = getLocalInfo().getBlocks();
-    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
-        plint blockId = blocks[iBlock];
-        getComponent(blockId).executeInternalProcessors(level);
+    // The internal processors of a block normally only access this block
+    //   and the blocks of the same id in the other multi-blocks: the blocks
+    //   are independent. If a processor shares data between the blocks, they
+    //   are processed one after the other.
+    bool blockLocal = true;
+    for (pluint iBlock=0; iBlock<blocks.size() && blockLocal; ++iBlock) {
+        blockLocal = getComponent(blocks[iBlock]).hasBlockLocalProcessors(level);
+    }
+    BlockSchedule schedule(blocks, getMultiBlockManagement().getThreadAttribution(), blockLocal);
+#ifdef PLB_SMP_PARALLEL
+    #pragma omp parallel num_threads(schedule.getNumThreads())
+#endif
+    {
+        plint iBlock;
+        while (schedule.next(iBlock)) {
+            getComponent(blocks[iBlock]).executeInternalProcessors(level);
+        }
     }
     if (communicate) {
         duplicateOverlapsInModifiedMultiBlocks(level);
     }
 }
 
+bool MultiBlock3D::hasAutomaticProcessors() const {
+    return maxProcessorLevel>=0;
+}
+
 void MultiBlock3D::subscribeProcessor (
         plint level,
         std::vector<MultiBlock3D*> modifiedBlocks,
@@ -138,7 +138,13 @@ public:
     /// Execute all internal dataProcessors at positive or zero level.
     void executeInternalProcessors();
     /// Execute all internal dataProcessors at a given level.
+    /** With PLB_SMP_PARALLEL, the local blocks are processed by several
+     *  threads, unless a processor of this level is not block-local (see
+     *  DataProcessor3D::isBlockLocal()).
+     */
     void executeInternalProcessors(plint level, bool communicate=true);
+    /// Tell if internal dataProcessors are executed at every cycle (level >= 0).
+    bool hasAutomaticProcessors() const;
     /// After adding an internal processor to the atomic-blocks, subscribe it
     /// in the multi-block to guarantee it will be executed.
     void subscribeProcessor(plint level,
@@ -195,6 +201,12 @@ public:
                 MultiBlock3D const& fromBlock, Box3D const& fromDomain,
                 Box3D const& toDomain, modif::ModifT whichData=modif::dataStructure ) =0;
     void duplicateOverlaps(modif::ModifT whichData);
+    /// Post the communication of duplicateOverlaps(), without waiting for it.
+    void startDuplicateOverlaps(modif::ModifT whichData);
+    /// Complete the communication posted by startDuplicateOverlaps().
+    void finishDuplicateOverlaps(modif::ModifT whichData);
+    /// Fill the envelopes with the static data which points away from the bulks.
+    void duplicateOrientedOverlaps();
     void signalPeriodicity();
     virtual DataSerializer* getBlockSerializer (
             Box3D const& domain, IndexOrdering::OrderingT ordering ) const;
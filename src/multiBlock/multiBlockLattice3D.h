@@ -107,6 +107,72 @@ public:
     virtual void collideAndStream();
     virtual void incrementTime();
     virtual void resetTime(pluint value);
+    /// Choose the streaming algorithm of collideAndStream() on all atomic blocks
+    /** The AA pattern requires an envelope at least twice as wide as the
+     *  vicinity of the descriptor, and a lattice without data processors:
+     *  the internal processors would run on the reverted layout of the even
+     *  cycles. No processor may be added to the lattice afterwards. The
+     *  envelopes are then updated after odd cycles only. See
+     *  BlockLattice3D::setStreamingPattern().
+     */
+    void setStreamingPattern(streaming::PatternT pattern);
+    streaming::PatternT getStreamingPattern() const;
+    /// Tell if the populations are stored in natural order
+    /** With the AA pattern, this is the case after odd cycles only: the
+     *  populations must be accessed, e.g. by data processors applied to the
+     *  lattice or by output, on even time steps.
+     */
+    bool hasNaturalLayout() const;
+    /// Choose how the atomic blocks store their populations
+    /** The atomic blocks are replaced by copies with the new storage, with
+     *  their cells and dynamics. This must therefore be done before data
+     *  processors are added, and with swap streaming. With structure-of-arrays
+     *  storage, soa or soaFloat (see SoABlockLattice3D), the AA pattern is not
+     *  available, and collideAndStream() ignores the options of communication
+     *  overlap and of oriented communication.
+     */
+    void setPopulationStorage(storage::LayoutT layout);
+    storage::LayoutT getPopulationStorage() const;
+    /// Execute numSteps collide-and-stream cycles with temporal blocking
+    /** Every atomic block is advanced by up to getTemporalBlockingDepth()
+     *  cycles in a row, on a domain which shrinks by the vicinity at each
+     *  cycle, before the envelopes are communicated. Blocks which fit into
+     *  cache are therefore reused over several time steps. This is only
+     *  done with swap streaming, no co-processors, and no internal processor
+     *  of level >= 0 (pure bulk lattice), and without oriented communication;
+     *  otherwise the cycles are executed one by one with collideAndStream().
+     *  Statistics are evaluated once per group of cycles.
+     */
+    void blockedCollideAndStream(plint numSteps);
+    /// Number of cycles which can be executed between two envelope updates,
+    ///   equal to the envelope width divided by the vicinity (rounded down).
+    /** To get a given depth, the envelope width is chosen as depth times
+     *  the vicinity of the descriptor; the rest of a wider envelope is unused.
+     */
+    plint getTemporalBlockingDepth() const;
+    /// Overlap the envelope communication with the collision of the interior
+    /** With this option, collideAndStream() first processes the cells next to
+     *  the envelope, posts the communication, and processes the interior of the
+     *  blocks while the messages are in flight. The result is unchanged. Like
+     *  blockedCollideAndStream(), this is only done with swap streaming, no
+     *  co-processors, and no internal processor of level >= 0.
+     */
+    void toggleCommunicationOverlap(bool overlap);
+    bool hasCommunicationOverlap() const;
+    /// Only communicate the populations which stream into the neighbors
+    /** With this option, collideAndStream() collides the blocks, copies into
+     *  each envelope only the post-collision populations which stream into
+     *  the bulk (five out of 19 across a face for D3Q19), and streams. The
+     *  result is unchanged, but the envelopes are not a copy of
+     *  the neighbors after the iteration: duplicateOverlaps() must be called
+     *  before a non-local operation on the lattice. This is only done with
+     *  swap streaming, no co-processors, and no internal processor of
+     *  level >= 0, and it takes precedence over the communication overlap.
+     *  The option cannot be turned on if the blocks do not cover the whole
+     *  bounding box (sparse multi-block). Turning it off restores the envelopes.
+     */
+    void toggleOrientedCommunication(bool oriented);
+    bool hasOrientedCommunication() const;
     virtual BlockLattice3D<T,Descriptor>& getComponent(plint blockId);
     virtual BlockLattice3D<T,Descriptor> const& getComponent(plint blockId) const;
     virtual plint sizeOfCell() const;
@@ -128,9 +194,20 @@ private:
     void allocateAndInitialize();
     void eliminateStatisticsInEnvelope();
     Box3D extendPeriodic(Box3D const& box, plint envelopeWidth) const;
+    /// Collide-and-stream all blocks and update the envelopes, with the
+    ///   communication overlapped by the interior of the blocks.
+    void overlappedCollideAndStream();
+    /// Collide all blocks, communicate the populations which stream out
+    ///   of the envelopes, and stream.
+    void orientedCollideAndStream();
 private:
     Dynamics<T,Descriptor>* backgroundDynamics;
     MultiCellAccess3D<T,Descriptor>* multiCellAccess;
+    streaming::PatternT streamingPattern;
+    bool aaOddStep;
+    storage::LayoutT populationStorage;
+    bool communicationOverlap;
+    bool orientedCommunication;
     BlockMap blockLattices;
 public:
     static const int staticId;
@@ -30,6 +30,7 @@
 
 #include "multiBlock/multiBlockLattice3D.h"
 #include "atomicBlock/blockLattice3D.h"
+#include "atomicBlock/soaBlockLattice3D.h"
 #include "multiBlock/defaultMultiBlockPolicy3D.h"
 #include "multiBlock/nonLocalTransfer3D.h"
 #include "multiBlock/multiBlockGenerator3D.h"
@@ -40,6 +41,7 @@
 #include "core/dynamicsIdentifiers.h"
 #include "dataProcessors/metaStuffWrapper3D.h"
 #include "coProcessors/coProcessor3D.h"
+#include "parallelism/smpManager.h"
 #include <algorithm>
 #include <limits>
 #include <cmath>
@@ -65,7 +67,12 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
         Dynamics<T,Descriptor>* backgroundDynamics_ )
     : MultiBlock3D(multiBlockManagement_, blockCommunicator_, combinedStatistics_ ),
       backgroundDynamics(backgroundDynamics_),
-      multiCellAccess(multiCellAccess_)
+      multiCellAccess(multiCellAccess_),
+      streamingPattern(streaming::swap),
+      aaOddStep(false),
+      populationStorage(storage::cells),
+      communicationOverlap(false),
+      orientedCommunication(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -78,7 +85,12 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
         Dynamics<T,Descriptor>* backgroundDynamics_ )
     : MultiBlock3D(nx,ny,nz,Descriptor<T>::vicinity),
       backgroundDynamics(backgroundDynamics_),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      streamingPattern(streaming::swap),
+      aaOddStep(false),
+      populationStorage(storage::cells),
+      communicationOverlap(false),
+      orientedCommunication(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -101,12 +113,17 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlockLattice3D<T,Des
     : BlockLatticeBase3D<T,Descriptor>(rhs),
       MultiBlock3D(rhs),
       backgroundDynamics(rhs.backgroundDynamics->clone()),
-      multiCellAccess(rhs.multiCellAccess->clone())
+      multiCellAccess(rhs.multiCellAccess->clone()),
+      streamingPattern(rhs.streamingPattern),
+      aaOddStep(rhs.aaOddStep),
+      populationStorage(rhs.populationStorage),
+      communicationOverlap(rhs.communicationOverlap),
+      orientedCommunication(rhs.orientedCommunication)
 {
     for ( typename  BlockMap::const_iterator it = rhs.blockLattices.begin();
           it != rhs.blockLattices.end(); ++it )
     {
-        blockLattices[it->first] = new BlockLattice3D<T,Descriptor>(*it->second);
+        blockLattices[it->first] = it->second->clone();
     }
 }
 
@@ -115,7 +132,12 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlock3D const& rhs)
       // Use MultiBlock's sub-domain constructor to avoid that the data-processors are copied
     : MultiBlock3D(rhs, rhs.getBoundingBox(), false),
       backgroundDynamics(new NoDynamics<T,Descriptor>),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      streamingPattern(streaming::swap),
+      aaOddStep(false),
+      populationStorage(storage::cells),
+      communicationOverlap(false),
+      orientedCommunication(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -125,7 +147,12 @@ template<typename T, template<typename U> class Descriptor>
 MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlock3D const& rhs, Box3D subDomain, bool crop)
     : MultiBlock3D(rhs, subDomain, crop),
       backgroundDynamics(new NoDynamics<T,Descriptor>),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      streamingPattern(streaming::swap),
+      aaOddStep(false),
+      populationStorage(storage::cells),
+      communicationOverlap(false),
+      orientedCommunication(false)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -137,6 +164,11 @@ void MultiBlockLattice3D<T,Descriptor>::swap(MultiBlockLattice3D<T,Descriptor>&
     MultiBlock3D::swap(rhs);
     std::swap(backgroundDynamics, rhs.backgroundDynamics);
     std::swap(multiCellAccess, rhs.multiCellAccess);
+    std::swap(streamingPattern, rhs.streamingPattern);
+    std::swap(aaOddStep, rhs.aaOddStep);
+    std::swap(populationStorage, rhs.populationStorage);
+    std::swap(communicationOverlap, rhs.communicationOverlap);
+    std::swap(orientedCommunication, rhs.orientedCommunication);
     blockLattices.swap(rhs.blockLattices);
 }
 
@@ -167,6 +199,7 @@ MultiBlockLattice3D<T,Descriptor>*
                 this->getCombinedStatistics().clone(),
                 multiCellAccess->clone(),
                 getBackgroundDynamics().clone() );
+    newLattice->setPopulationStorage(populationStorage);
     copy(*this, this->getBoundingBox(), *newLattice, newLattice->getBoundingBox(), modif::dataStructure);
     return newLattice;
 }
@@ -305,6 +338,7 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
 
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
+    PLB_PRECONDITION( streamingPattern==streaming::swap || this->getStoredProcessors().empty() );
     global::profiler().start("cycle");
     ThreadAttribution const& threadAttribution=this->getMultiBlockManagement().getThreadAttribution();
     if (threadAttribution.hasCoProcessors()) {
@@ -325,20 +359,42 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
                 it->second -> collideAndStream( bulk.toLocal(domain) );
             }
         }
+        this->executeInternalProcessors();
+    }
+    else if ( orientedCommunication && streamingPattern==streaming::swap &&
+              populationStorage==storage::cells && !this->hasAutomaticProcessors() )
+    {
+        orientedCollideAndStream();
+    }
+    else if ( communicationOverlap && streamingPattern==streaming::swap &&
+              populationStorage==storage::cells && !this->hasAutomaticProcessors() )
+    {
+        overlappedCollideAndStream();
     }
     else  {
-        for ( typename BlockMap::iterator it = blockLattices.begin();
-              it != blockLattices.end(); ++it)
+        std::vector<plint> const& blocks = this->getLocalInfo().getBlocks();
+        BlockSchedule schedule(blocks, threadAttribution);
+#ifdef PLB_SMP_PARALLEL
+        #pragma omp parallel num_threads(schedule.getNumThreads())
+#endif
         {
-            SmartBulk3D bulk(this->getMultiBlockManagement(), it->first);
-            // CollideAndStream must be applied to full domain,
-            //   including currently active envelopes.
-            Box3D domain = extendPeriodic(bulk.computeNonPeriodicEnvelope(),
-                                          this->getMultiBlockManagement().getEnvelopeWidth());
-            it->second -> collideAndStream( bulk.toLocal(domain) );
+            plint iBlock;
+            while (schedule.next(iBlock)) {
+                SmartBulk3D bulk(this->getMultiBlockManagement(), blocks[iBlock]);
+                // CollideAndStream must be applied to full domain,
+                //   including currently active envelopes.
+                Box3D domain = extendPeriodic(bulk.computeNonPeriodicEnvelope(),
+                                              this->getMultiBlockManagement().getEnvelopeWidth());
+                getComponent(blocks[iBlock]).collideAndStream( bulk.toLocal(domain) );
+            }
+        }
+        // With the AA pattern, an even cycle collides every cell in place, those
+        //   of the envelopes included, which therefore stay up to date. Without
+        //   processors, there is then nothing to execute.
+        if (streamingPattern==streaming::swap || aaOddStep) {
+            this->executeInternalProcessors();
         }
     }
-    this->executeInternalProcessors();
     this->evaluateStatistics();
     this->incrementTime();
     if (global::profiler().cyclingIsAutomatic()) {
@@ -347,6 +403,100 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
     global::profiler().stop("cycle");
 }
 
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::overlappedCollideAndStream() {
+    static const plint vicinity = Descriptor<T>::vicinity;
+    plint envelopeWidth = this->getMultiBlockManagement().getEnvelopeWidth();
+    std::vector<plint> const& blocks = this->getLocalInfo().getBlocks();
+    ThreadAttribution const& threadAttribution = this->getMultiBlockManagement().getThreadAttribution();
+    std::vector<Box3D> domains(blocks.size()), interiors(blocks.size());
+    // 1. The cells sent to the neighbors depend only on the cells which are less
+    //    than envelopeWidth+vicinity away from the envelope.
+    BlockSchedule shellSchedule(blocks, threadAttribution);
+#ifdef PLB_SMP_PARALLEL
+    #pragma omp parallel num_threads(shellSchedule.getNumThreads())
+#endif
+    {
+        plint iBlock;
+        while (shellSchedule.next(iBlock)) {
+            SmartBulk3D bulk(this->getMultiBlockManagement(), blocks[iBlock]);
+            Box3D domain = bulk.toLocal( extendPeriodic(bulk.computeNonPeriodicEnvelope(),
+                                                        envelopeWidth) );
+            Box3D interior = bulk.toLocal( bulk.getBulk().enlarge(-(envelopeWidth+vicinity)) );
+            if (interior.x0>interior.x1 || interior.y0>interior.y1 || interior.z0>interior.z1) {
+                getComponent(blocks[iBlock]).collideAndStream(domain);
+            }
+            else {
+                getComponent(blocks[iBlock]).collideAndStreamShell(domain, interior);
+            }
+            domains[iBlock] = domain;
+            interiors[iBlock] = interior;
+        }
+    }
+    // 2. Post the communication of the envelopes.
+    global::profiler().start("envelope-update");
+    this->startDuplicateOverlaps(this->getInternalTypeOfModification());
+    global::profiler().stop("envelope-update");
+    // 3. Process the interior while the messages are in flight.
+    BlockSchedule interiorSchedule(blocks, threadAttribution);
+#ifdef PLB_SMP_PARALLEL
+    #pragma omp parallel num_threads(interiorSchedule.getNumThreads())
+#endif
+    {
+        plint iBlock;
+        while (interiorSchedule.next(iBlock)) {
+            Box3D const& interior = interiors[iBlock];
+            if (interior.x0<=interior.x1 && interior.y0<=interior.y1 && interior.z0<=interior.z1) {
+                getComponent(blocks[iBlock]).collideAndStreamInterior(domains[iBlock], interior);
+            }
+        }
+    }
+    // 4. Complete the envelopes.
+    global::profiler().start("envelope-update");
+    this->finishDuplicateOverlaps(this->getInternalTypeOfModification());
+    global::profiler().stop("envelope-update");
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::orientedCollideAndStream() {
+    plint envelopeWidth = this->getMultiBlockManagement().getEnvelopeWidth();
+    std::vector<plint> const& blocks = this->getLocalInfo().getBlocks();
+    ThreadAttribution const& threadAttribution = this->getMultiBlockManagement().getThreadAttribution();
+    std::vector<Box3D> domains(blocks.size());
+    // 1. Collide on the same domain as collideAndStream(). The communication
+    //    overwrites the populations of the envelopes which are streamed into the bulk.
+    BlockSchedule collideSchedule(blocks, threadAttribution);
+#ifdef PLB_SMP_PARALLEL
+    #pragma omp parallel num_threads(collideSchedule.getNumThreads())
+#endif
+    {
+        plint iBlock;
+        while (collideSchedule.next(iBlock)) {
+            SmartBulk3D bulk(this->getMultiBlockManagement(), blocks[iBlock]);
+            domains[iBlock] = bulk.toLocal( extendPeriodic(bulk.computeNonPeriodicEnvelope(),
+                                                           envelopeWidth) );
+            getComponent(blocks[iBlock]).collide(domains[iBlock]);
+        }
+    }
+    // 2. After the collision, the populations are stored in reverted order.
+    //    The populations of an envelope which point away from the bulk are
+    //    therefore the ones which stream into the bulk.
+    global::profiler().start("envelope-update");
+    this->duplicateOrientedOverlaps();
+    global::profiler().stop("envelope-update");
+    // 3. Stream.
+    BlockSchedule streamSchedule(blocks, threadAttribution);
+#ifdef PLB_SMP_PARALLEL
+    #pragma omp parallel num_threads(streamSchedule.getNumThreads())
+#endif
+    {
+        plint iBlock;
+        while (streamSchedule.next(iBlock)) {
+            getComponent(blocks[iBlock]).stream(domains[iBlock]);
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::incrementTime() {
     for ( typename BlockMap::iterator it = blockLattices.begin();
@@ -355,6 +505,9 @@ void MultiBlockLattice3D<T,Descriptor>::incrementTime() {
         it->second -> incrementTime();
     }
     this->getTimeCounter().incrementTime();
+    if (streamingPattern==streaming::aa) {
+        aaOddStep = !aaOddStep;
+    }
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -368,6 +521,159 @@ void MultiBlockLattice3D<T,Descriptor>::resetTime(pluint value)
     this->getTimeCounter().resetTime(value);
 }
 
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::setStreamingPattern(streaming::PatternT pattern)
+{
+    PLB_PRECONDITION( hasNaturalLayout() );
+    PLB_PRECONDITION( pattern==streaming::swap ||
+                      ( this->getMultiBlockManagement().getEnvelopeWidth() >= 2*Descriptor<T>::vicinity &&
+                        populationStorage==storage::cells && this->getStoredProcessors().empty() ) );
+    for ( typename BlockMap::iterator it = blockLattices.begin();
+          it != blockLattices.end(); ++it)
+    {
+        it->second -> setStreamingPattern(pattern);
+    }
+    streamingPattern = pattern;
+    aaOddStep = false;
+}
+
+template<typename T, template<typename U> class Descriptor>
+streaming::PatternT MultiBlockLattice3D<T,Descriptor>::getStreamingPattern() const
+{
+    return streamingPattern;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool MultiBlockLattice3D<T,Descriptor>::hasNaturalLayout() const
+{
+    return !aaOddStep;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::setPopulationStorage(storage::LayoutT layout)
+{
+    PLB_PRECONDITION( this->getStoredProcessors().empty() && streamingPattern==streaming::swap );
+    for ( typename BlockMap::iterator it = blockLattices.begin();
+          it != blockLattices.end(); ++it)
+    {
+        BlockLattice3D<T,Descriptor>* block = it->second;
+        switch(layout) {
+            case storage::cells:
+                it->second = new BlockLattice3D<T,Descriptor>(*block); break;
+            case storage::soa:
+                it->second = new SoABlockLattice3D<T,Descriptor,T>(*block); break;
+            case storage::soaFloat:
+                it->second = new SoABlockLattice3D<T,Descriptor,float>(*block); break;
+            default: PLB_ASSERT(false);
+        }
+        delete block;
+    }
+    populationStorage = layout;
+}
+
+template<typename T, template<typename U> class Descriptor>
+storage::LayoutT MultiBlockLattice3D<T,Descriptor>::getPopulationStorage() const
+{
+    return populationStorage;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::blockedCollideAndStream(plint numSteps)
+{
+    plint depth = getTemporalBlockingDepth();
+    if ( depth<=1 || streamingPattern!=streaming::swap || this->hasAutomaticProcessors() ||
+         this->getMultiBlockManagement().getThreadAttribution().hasCoProcessors() ||
+         orientedCommunication )
+    {
+        for (plint iStep=0; iStep<numSteps; ++iStep) {
+            collideAndStream();
+        }
+        return;
+    }
+    static const plint vicinity = Descriptor<T>::vicinity;
+    plint envelopeWidth = this->getMultiBlockManagement().getEnvelopeWidth();
+    while (numSteps>0) {
+        plint numCycles = std::min(depth, numSteps);
+        // Each cycle invalidates a layer of width vicinity: the envelope must
+        //   absorb all of them for the bulk to be valid at the end.
+        PLB_ASSERT( numCycles*vicinity <= envelopeWidth );
+        global::profiler().start("cycle");
+        std::vector<plint> const& blocks = this->getLocalInfo().getBlocks();
+        BlockSchedule schedule(blocks, this->getMultiBlockManagement().getThreadAttribution());
+#ifdef PLB_SMP_PARALLEL
+        #pragma omp parallel num_threads(schedule.getNumThreads())
+#endif
+        {
+            plint iBlock;
+            while (schedule.next(iBlock)) {
+                SmartBulk3D bulk(this->getMultiBlockManagement(), blocks[iBlock]);
+                BlockLattice3D<T,Descriptor>& block = getComponent(blocks[iBlock]);
+                Box3D envelope = extendPeriodic(bulk.computeNonPeriodicEnvelope(), envelopeWidth);
+                for (plint iCycle=0; iCycle<numCycles; ++iCycle) {
+                    // Every cycle corrupts a layer of width vicinity at the border
+                    //   of its domain: the next cycle is restricted to the cells
+                    //   which are still valid. After the last one, the bulk is valid.
+                    Box3D domain;
+                    intersect( envelope, bulk.getBulk().enlarge(envelopeWidth-iCycle*vicinity),
+                               domain );
+                    block.collideAndStream( bulk.toLocal(domain) );
+                    block.incrementTime();
+                }
+            }
+        }
+        this->executeInternalProcessors();
+        this->evaluateStatistics();
+        for (plint iCycle=0; iCycle<numCycles; ++iCycle) {
+            this->getTimeCounter().incrementTime();
+        }
+        if (global::profiler().cyclingIsAutomatic()) {
+            global::profiler().cycle();
+        }
+        global::profiler().stop("cycle");
+        numSteps -= numCycles;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint MultiBlockLattice3D<T,Descriptor>::getTemporalBlockingDepth() const
+{
+    // The largest depth for which depth*vicinity <= envelopeWidth.
+    return this->getMultiBlockManagement().getEnvelopeWidth() / Descriptor<T>::vicinity;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::toggleCommunicationOverlap(bool overlap)
+{
+    communicationOverlap = overlap;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool MultiBlockLattice3D<T,Descriptor>::hasCommunicationOverlap() const
+{
+    return communicationOverlap;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::toggleOrientedCommunication(bool oriented)
+{
+    if (orientedCommunication && !oriented) {
+        this->duplicateOverlaps(modif::staticVariables);
+    }
+    // Envelope cells without neighbor, next to the holes of a sparse
+    //   multi-block, exchange populations with the communicated envelope
+    //   cells and would see the populations which are not sent.
+    SparseBlockStructure3D const& sparseBlock =
+        this->getMultiBlockManagement().getSparseBlockStructure();
+    orientedCommunication = oriented &&
+        sparseBlock.getNumBulkCells() == sparseBlock.getBoundingBox().nCells();
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool MultiBlockLattice3D<T,Descriptor>::hasOrientedCommunication() const
+{
+    return orientedCommunication;
+}
+
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::allocateAndInitialize()
 {
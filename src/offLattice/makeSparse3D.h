@@ -51,6 +51,77 @@ template<typename T>
 MultiBlockManagement3D computeSparseManagement (
         MultiScalarField3D<T>& field, plint newEnvelopeWidth );
 
+
+/// Relative cost of the update of a cell of a voxelized domain, per kind of cell.
+/** The costs are relative to the one of a bulk fluid cell. They depend on
+ *  the dynamics and boundary conditions of the run, and are best measured
+ *  on the target machine.
+ */
+struct CellCostModel3D {
+    CellCostModel3D()
+        : fluid(1.), boundary(2.), buffer(1.5), noDynamics(0.),
+          bufferDomain(), bufferWidth(0)
+    { }
+    /// Cells of the flow type.
+    double fluid;
+    /// Cells next to the wall, on both sides, which are handled by the
+    ///   off-lattice boundary condition.
+    double boundary;
+    /// Cells of the flow type in the anechoic buffer.
+    double buffer;
+    /// Cells on the other side of the wall. Blocks with a vanishing total
+    ///   cost are eliminated: with the default of zero, these are the blocks
+    ///   without flow or boundary cells. A positive cost keeps them.
+    double noDynamics;
+    /// The anechoic buffer is the layer of width bufferWidth along the
+    ///   faces of bufferDomain. There is no buffer if bufferWidth is zero.
+    Box3D bufferDomain;
+    plint bufferWidth;
+};
+
+/// Assign to every cell of a voxel matrix the cost of its update.
+/** Undetermined cells have zero cost. **/
+template<typename T>
+class VoxelCostFunctional3D : public BoxProcessingFunctional3D_SS<int,T>
+{
+public:
+    VoxelCostFunctional3D(int flowType_, CellCostModel3D const& model_);
+    virtual void process(Box3D domain, ScalarField3D<int>& voxels, ScalarField3D<T>& cost);
+    virtual VoxelCostFunctional3D<T>* clone() const;
+    virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const;
+    virtual BlockDomain::DomainT appliesTo() const;
+private:
+    bool isInBuffer(plint iX, plint iY, plint iZ) const;
+private:
+    int flowType;
+    CellCostModel3D model;
+};
+
+template<typename T>
+void computeVoxelCost( MultiScalarField3D<int>& voxels, MultiScalarField3D<T>& cost,
+                       int flowType, CellCostModel3D const& model );
+
+/// Sum the cost of the cells of every block into a container block.
+template<typename T>
+class ComputeBlockCostFunctional3D : public BoxProcessingFunctional3D
+{
+public:
+    virtual void processGenericBlocks(Box3D domain, std::vector<AtomicBlock3D*> fields);
+    virtual ComputeBlockCostFunctional3D<T>* clone() const;
+    virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const;
+    virtual BlockDomain::DomainT appliesTo() const;
+};
+
+/// Same as computeSparseManagement, but with a distribution of the blocks
+///   which balances the cost of their cells instead of their number.
+/** The field holds the cost of every cell; the blocks in which all cells
+ *  have zero cost are eliminated. The blocks keep their order, and each
+ *  process receives a contiguous range of them.
+ */
+template<typename T>
+MultiBlockManagement3D computeWeightedSparseManagement (
+        MultiScalarField3D<T>& costField, plint newEnvelopeWidth );
+
 }  // namespace plb
 
 #endif  // MAKE_SPARSE_3D_H
@@ -28,9 +28,11 @@
 #include "core/globalDefs.h"
 #include "offLattice/makeSparse3D.h"
 #include "parallelism/mpiManager.h"
+#include "parallelism/smpManager.h"
 #include "atomicBlock/reductiveDataProcessingFunctional3D.h"
 #include "atomicBlock/atomicContainerBlock3D.h"
 #include "offLattice/domainClustering3D.h"
+#include "offLattice/voxelizer.h"
 
 
 namespace plb {
@@ -42,6 +44,13 @@ struct FlagData3D : public ContainerBlockData {
     }
 };
 
+struct CostData3D : public ContainerBlockData {
+    double cost;
+    virtual CostData3D* clone() const {
+        return new CostData3D(*this);
+    }
+};
+
 /* ******** ComputeSparsityFunctional3D ************************************ */
 
 template<typename T>
@@ -185,6 +194,215 @@ MultiBlockManagement3D computeSparseManagement (
     return newManagement;
 }
 
+
+/* ******** VoxelCostFunctional3D ************************************ */
+
+template<typename T>
+VoxelCostFunctional3D<T>::VoxelCostFunctional3D (
+        int flowType_, CellCostModel3D const& model_ )
+    : flowType(flowType_),
+      model(model_)
+{ }
+
+template<typename T>
+bool VoxelCostFunctional3D<T>::isInBuffer(plint iX, plint iY, plint iZ) const
+{
+    Box3D const& box = model.bufferDomain;
+    plint width = model.bufferWidth;
+    if (width==0 || !contained(iX,iY,iZ, box)) {
+        return false;
+    }
+    return iX<box.x0+width || iX>box.x1-width ||
+           iY<box.y0+width || iY>box.y1-width ||
+           iZ<box.z0+width || iZ>box.z1-width;
+}
+
+template<typename T>
+void VoxelCostFunctional3D<T>::process (
+        Box3D domain, ScalarField3D<int>& voxels, ScalarField3D<T>& cost )
+{
+    Dot3D location = voxels.getLocation();
+    Dot3D offset = computeRelativeDisplacement(voxels, cost);
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                int flag = voxels.get(iX,iY,iZ);
+                double cellCost = 0.;
+                if (flag==voxelFlag::innerBorder || flag==voxelFlag::outerBorder) {
+                    cellCost = model.boundary;
+                }
+                else if (flag==flowType) {
+                    cellCost = isInBuffer(iX+location.x, iY+location.y, iZ+location.z) ?
+                                   model.buffer : model.fluid;
+                }
+                else if (flag!=voxelFlag::undetermined) {
+                    cellCost = model.noDynamics;
+                }
+                cost.get(iX+offset.x,iY+offset.y,iZ+offset.z) = (T)cellCost;
+            }
+        }
+    }
+}
+
+template<typename T>
+VoxelCostFunctional3D<T>* VoxelCostFunctional3D<T>::clone() const {
+    return new VoxelCostFunctional3D<T>(*this);
+}
+
+template<typename T>
+void VoxelCostFunctional3D<T>::getTypeOfModification(std::vector<modif::ModifT>& modified) const {
+    modified[0] = modif::nothing;          // Voxel matrix.
+    modified[1] = modif::staticVariables;  // Cost field.
+}
+
+template<typename T>
+BlockDomain::DomainT VoxelCostFunctional3D<T>::appliesTo() const {
+    return BlockDomain::bulk;
+}
+
+template<typename T>
+void computeVoxelCost( MultiScalarField3D<int>& voxels, MultiScalarField3D<T>& cost,
+                       int flowType, CellCostModel3D const& model )
+{
+    applyProcessingFunctional (
+            new VoxelCostFunctional3D<T>(flowType, model),
+            voxels.getBoundingBox(), voxels, cost );
+}
+
+
+/* ******** ComputeBlockCostFunctional3D ************************************ */
+
+template<typename T>
+void ComputeBlockCostFunctional3D<T>::processGenericBlocks (
+        Box3D domain, std::vector<AtomicBlock3D*> blocks )
+{
+    PLB_PRECONDITION( blocks.size()==2 );
+    ScalarField3D<T>* field = dynamic_cast<ScalarField3D<T>*>(blocks[0]);
+    AtomicContainerBlock3D* container = dynamic_cast<AtomicContainerBlock3D*>(blocks[1]);
+    PLB_ASSERT( field );
+    PLB_ASSERT( container );
+    double cost = 0.;
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                cost += (double)field->get(iX,iY,iZ);
+            }
+        }
+    }
+    CostData3D* costData = new CostData3D;
+    costData->cost = cost;
+    container->setData(costData);
+}
+
+template<typename T>
+ComputeBlockCostFunctional3D<T>* ComputeBlockCostFunctional3D<T>::clone() const {
+    return new ComputeBlockCostFunctional3D<T>(*this);
+}
+
+template<typename T>
+void ComputeBlockCostFunctional3D<T>::getTypeOfModification(std::vector<modif::ModifT>& modified) const {
+    modified[0] = modif::nothing; // Scalar Field.
+    modified[1] = modif::staticVariables;  // Container Block with cost data.
+}
+
+template<typename T>
+BlockDomain::DomainT ComputeBlockCostFunctional3D<T>::appliesTo() const {
+    return BlockDomain::bulk;
+}
+
+
+/* ******** computeWeightedSparseManagement ************************************ */
+
+template<typename T>
+MultiBlockManagement3D computeWeightedSparseManagement (
+        MultiScalarField3D<T>& costField, plint newEnvelopeWidth )
+{
+    MultiContainerBlock3D multiCostBlock(costField);
+    std::vector<MultiBlock3D*> args;
+    args.push_back(&costField);
+    args.push_back(&multiCostBlock);
+    applyProcessingFunctional (
+            new ComputeBlockCostFunctional3D<T>, costField.getBoundingBox(), args );
+
+    MultiBlockManagement3D const& management = multiCostBlock.getMultiBlockManagement();
+    ThreadAttribution const& threadAttribution = management.getThreadAttribution();
+    SparseBlockStructure3D const& sparseBlock = management.getSparseBlockStructure();
+
+    std::map<plint,Box3D> const& domains = sparseBlock.getBulks();
+    std::vector<plint> domainIds(domains.size());
+    std::vector<double> blockCost(domains.size());
+
+    std::map<plint,Box3D>::const_iterator it = domains.begin();
+    plint pos = 0;
+    for (; it != domains.end(); ++it) {
+        plint id = it->first;
+        domainIds[pos] = id;
+        if (threadAttribution.isLocal(id)) {
+            AtomicContainerBlock3D const& costBlock = multiCostBlock.getComponent(id);
+            CostData3D const* data =
+                dynamic_cast<CostData3D const*> (costBlock.getData());
+            PLB_ASSERT( data );
+            blockCost[pos] = data->cost;
+        }
+        else {
+            blockCost[pos] = 0.;
+        }
+        ++pos;
+    }
+
+#ifdef PLB_MPI_PARALLEL
+    std::vector<double> tmp(blockCost.size());
+    global::mpi().reduceVect(blockCost, tmp, MPI_SUM);
+    global::mpi().bCast(&tmp[0], tmp.size());
+    tmp.swap(blockCost);
+#endif
+
+    SparseBlockStructure3D newSparseBlock(costField.getBoundingBox());
+    std::vector<double> newBlockCost;
+    plint newId = 0;
+    for (pluint iBlock=0; iBlock<blockCost.size(); ++iBlock) {
+        if (blockCost[iBlock] > 0.) {
+            plint id = domainIds[iBlock];
+            Box3D bulk, uniqueBulk;
+            sparseBlock.getBulk(id, bulk);
+            sparseBlock.getUniqueBulk(id, uniqueBulk);
+            newSparseBlock.addBlock(bulk, uniqueBulk, newId++);
+            newBlockCost.push_back(blockCost[iBlock]);
+        }
+    }
+    // If this assertion fails, that means that the domain covered
+    // by the sparse block-structure is empty.
+    PLB_ASSERT( newId>0 );
+
+    ExplicitThreadAttribution* newAttribution = new ExplicitThreadAttribution;
+    std::vector<std::pair<plint,plint> > ranges;
+    plint numRanges = std::min(newId, (plint)global::mpi().getSize());
+    util::weightedLinearRepartition(newBlockCost, numRanges, ranges);
+
+    // Within each process, the blocks are cut in the same way into ranges of
+    //   equal cost for the threads which execute the block loops.
+    for (pluint iProc=0; iProc<ranges.size(); ++iProc) {
+        std::vector<double> procBlockCost (
+                newBlockCost.begin()+ranges[iProc].first,
+                newBlockCost.begin()+ranges[iProc].second+1 );
+        std::vector<std::pair<plint,plint> > threadRanges;
+        plint numThreads = std::min( (plint)global::smp().getNumThreads(),
+                                     (plint)procBlockCost.size() );
+        util::weightedLinearRepartition(procBlockCost, numThreads, threadRanges);
+        for (pluint iThread=0; iThread<threadRanges.size(); ++iThread) {
+            for (plint iBlock=threadRanges[iThread].first; iBlock<=threadRanges[iThread].second; ++iBlock) {
+                newAttribution -> addBlock(ranges[iProc].first+iBlock, iProc, iThread);
+            }
+        }
+    }
+
+    MultiBlockManagement3D newManagement (
+            newSparseBlock, newAttribution,
+            newEnvelopeWidth,
+            management.getRefinementLevel() );
+    return newManagement;
+}
+
 }  // namespace plb
 
 #endif  // MAKE_SPARSE_3D_HH
@@ -36,6 +36,7 @@
 #include "multiBlock/multiDataField3D.h"
 #include "atomicBlock/atomicContainerBlock3D.h"
 #include "multiBlock/multiContainerBlock3D.h"
+#include "offLattice/makeSparse3D.h"
 #include <stack>
 
 namespace plb {
@@ -378,6 +379,10 @@ public:
     template<class ParticleFieldT>
     void adjustVoxelization(MultiParticleField3D<ParticleFieldT>& particles, bool dynamicMesh);
     void reparallelize(MultiBlockRedistribute3D const& redistribute);
+    /// Cut the voxel matrix into blocks of size blockSize, eliminate the
+    ///   blocks of zero cost, and distribute the other ones on the processes
+    ///   according to the cost of their cells.
+    void balanceLoad(CellCostModel3D const& costModel, plint blockSize);
     TriangleBoundary3D<T> const& getBoundary() const { return boundary; }
     int getFlowType() const { return flowType; }
 private:
@@ -1185,6 +1185,29 @@ void VoxelizedDomain3D<T>::reparallelize(MultiBlockRedistribute3D const& redistr
     createTriangleHash();
 }
 
+template<typename T>
+void VoxelizedDomain3D<T>::balanceLoad(CellCostModel3D const& costModel, plint blockSize) {
+    std::auto_ptr<MultiScalarField3D<int> > voxels =
+        plb::reparallelize(*voxelMatrix, blockSize,blockSize,blockSize);
+    MultiScalarField3D<double> cost((MultiBlock3D const&)*voxels);
+    computeVoxelCost(*voxels, cost, flowType, costModel);
+    MultiBlockManagement3D newManagement =
+        computeWeightedSparseManagement (
+                cost, voxelMatrix->getMultiBlockManagement().getEnvelopeWidth() );
+    MultiScalarField3D<int>* newVoxelMatrix =
+        new MultiScalarField3D<int>(
+                newManagement,
+                voxelMatrix->getBlockCommunicator().clone(),
+                voxelMatrix->getCombinedStatistics().clone(),
+                defaultMultiBlockPolicy3D().getMultiScalarAccess<int>(),
+                voxelFlag::undetermined );
+    copyNonLocal(*voxelMatrix, *newVoxelMatrix, voxelMatrix->getBoundingBox());
+    std::swap(voxelMatrix, newVoxelMatrix);
+    delete newVoxelMatrix;
+    delete triangleHash;
+    createTriangleHash();
+}
+
 template<typename T>
 MultiBlockManagement3D const&
     VoxelizedDomain3D<T>::getMultiBlockManagement() const
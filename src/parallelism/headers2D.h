@@ -27,6 +27,7 @@
  * Groups all the include files for 2D parallelism.
  */
 #include "parallelism/mpiManager.h"
+#include "parallelism/smpManager.h"
 #include "parallelism/parallelDynamics.h"
 #include "parallelism/parallelBlockCommunicator2D.h"
 #include "parallelism/parallelMultiBlockLattice2D.h"
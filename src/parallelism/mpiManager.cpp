@@ -32,6 +32,7 @@
 #include "core/plbDebug.h"
 #include "core/plbComplex.h"
 #include "core/plbComplex.hh"
+#include "parallelism/smpManager.h"
 #include <algorithm>
 #include <iostream>
 
@@ -41,10 +42,14 @@ namespace global {
 
 MpiManager::MpiManager()
     : ok(false),
-      responsibleForMpiMachine(false)
+      responsibleForMpiMachine(false),
+      nodeCommunicator(MPI_COMM_NULL)
 { }
 
 MpiManager::~MpiManager() {
+    // The node communicator is created by every init(), also when the MPI
+    //   machine is handled by another instance.
+    freeNodeCommunicator();
     if (responsibleForMpiMachine) {
         MPI_Finalize();
         ok = false;
@@ -56,7 +61,13 @@ void MpiManager::init(int *argc, char ***argv, bool verbous) {
     if (verbous) {
         std::cerr << "Constructing an MPI thread" << std::endl;
     }
+#ifdef PLB_SMP_PARALLEL
+    // Block loops are threaded, but only the main thread calls MPI.
+    int provided;
+    int ok1 = MPI_Init_thread(argc, argv, MPI_THREAD_FUNNELED, &provided);
+#else
     int ok1 = MPI_Init(argc, argv);
+#endif
     // If I'm the one who calls MPI_Init, then I need to be
     // the one who calls MPI_Finalize.
     responsibleForMpiMachine = true;
@@ -64,6 +75,16 @@ void MpiManager::init(int *argc, char ***argv, bool verbous) {
     int ok2 = MPI_Comm_rank(getGlobalCommunicator(),&taskId);
     int ok3 = MPI_Comm_size(getGlobalCommunicator(),&numTasks);
     ok = (ok1==0 && ok2==0 && ok3==0);
+#ifdef PLB_SMP_PARALLEL
+    if (provided < MPI_THREAD_FUNNELED) {
+        if (taskId==0) {
+            std::cerr << "Warning: the MPI library does not support MPI_THREAD_FUNNELED; "
+                      << "the block loops use a single thread." << std::endl;
+        }
+        global::smp().restrictToSingleThread();
+    }
+#endif
+    initNodeCommunicator();
 }
 
 void MpiManager::init(MPI_Comm globalCommunicator_) {
@@ -71,12 +92,53 @@ void MpiManager::init(MPI_Comm globalCommunicator_) {
     int ok1 = MPI_Comm_rank(getGlobalCommunicator(),&taskId);
     int ok2 = MPI_Comm_size(getGlobalCommunicator(),&numTasks);
     ok = (ok1==0 && ok2==0);
+    initNodeCommunicator();
+}
+
+void MpiManager::initNodeCommunicator() {
+    // A repeated initialization replaces the previous communicator.
+    freeNodeCommunicator();
+    nodeRanks.assign(numTasks, -1);
+    if (!ok) return;
+    nodeRanks[taskId] = 0;
+#if MPI_VERSION >= 3
+    MPI_Comm_split_type(getGlobalCommunicator(), MPI_COMM_TYPE_SHARED, taskId,
+                        MPI_INFO_NULL, &nodeCommunicator);
+    // Translate the ranks of the global communicator into node ranks.
+    std::vector<int> globalRanks(numTasks);
+    for (int iRank=0; iRank<numTasks; ++iRank) {
+        globalRanks[iRank] = iRank;
+    }
+    MPI_Group globalGroup, nodeGroup;
+    MPI_Comm_group(getGlobalCommunicator(), &globalGroup);
+    MPI_Comm_group(nodeCommunicator, &nodeGroup);
+    MPI_Group_translate_ranks(globalGroup, numTasks, &globalRanks[0], nodeGroup, &nodeRanks[0]);
+    MPI_Group_free(&globalGroup);
+    MPI_Group_free(&nodeGroup);
+    for (int iRank=0; iRank<numTasks; ++iRank) {
+        if (nodeRanks[iRank] == MPI_UNDEFINED) {
+            nodeRanks[iRank] = -1;
+        }
+    }
+#endif
 }
 
 void MpiManager::init() {
     init(MPI_COMM_WORLD);
 }
 
+void MpiManager::freeNodeCommunicator() {
+    if (nodeCommunicator == MPI_COMM_NULL) return;
+    // Nothing can be freed any more once MPI has been finalized by
+    //   another instance.
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+        MPI_Comm_free(&nodeCommunicator);
+    }
+    nodeCommunicator = MPI_COMM_NULL;
+}
+
 int MpiManager::getSize() const {
     return numTasks;
 }
@@ -828,6 +890,24 @@ void MpiManager::iRecv<char>(char *buf, int count, int source, MPI_Request* requ
     }
 }
 
+template <>
+void MpiManager::sendInit<char>
+    (char *buf, int count, int dest, MPI_Request* request, int tag)
+{
+    if (ok) {
+        MPI_Send_init(static_cast<void*>(buf), count, MPI_CHAR, dest, tag, getGlobalCommunicator(), request);
+    }
+}
+
+template <>
+void MpiManager::recvInit<char>
+    (char *buf, int count, int source, MPI_Request* request, int tag)
+{
+    if (ok) {
+        MPI_Recv_init(static_cast<void*>(buf), count, MPI_CHAR, source, tag, getGlobalCommunicator(), request);
+    }
+}
+
 template <>
 void MpiManager::iRecv<int>(int *buf, int count, int source, MPI_Request* request, int tag)
 {
@@ -2229,6 +2309,98 @@ void MpiManager::wait(MPI_Request* request, MPI_Status* status)
     MPI_Wait(request, status);
 }
 
+void MpiManager::start(MPI_Request* request)
+{
+    if (!ok) return;
+    MPI_Start(request);
+}
+
+void MpiManager::startAll(int count, MPI_Request* requests)
+{
+    if (!ok) return;
+    MPI_Startall(count, requests);
+}
+
+void MpiManager::waitAny(int count, MPI_Request* requests, int* index, MPI_Status* status)
+{
+    if (!ok) {
+        *index = MPI_UNDEFINED;
+        return;
+    }
+    MPI_Waitany(count, requests, index, status);
+}
+
+void MpiManager::waitAll(int count, MPI_Request* requests, MPI_Status* statuses)
+{
+    if (!ok) return;
+    MPI_Waitall(count, requests, statuses);
+}
+
+void MpiManager::freeRequest(MPI_Request* request)
+{
+    if (!ok) return;
+    MPI_Request_free(request);
+}
+
+int MpiManager::getNodeSize() const
+{
+    return (int)(nodeRanks.size() - std::count(nodeRanks.begin(), nodeRanks.end(), -1));
+}
+
+int MpiManager::getNodeRank(int rank) const
+{
+    return nodeRanks[rank];
+}
+
+char* MpiManager::allocateSharedWindow(plint numBytes, MPI_Win* window)
+{
+    char* base = 0;
+#if MPI_VERSION >= 3
+    if (!ok) return base;
+    MPI_Win_allocate_shared((MPI_Aint)numBytes, 1, MPI_INFO_NULL, nodeCommunicator,
+                            static_cast<void*>(&base), window);
+    // The window stays in a passive-target epoch during its whole life; the
+    //   accesses are ordered by messages and syncSharedWindow().
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, *window);
+#else
+    PLB_ASSERT( false );
+#endif
+    return base;
+}
+
+char* MpiManager::querySharedWindow(MPI_Win window, int nodeRank)
+{
+    char* base = 0;
+#if MPI_VERSION >= 3
+    if (!ok) return base;
+    MPI_Aint size;
+    int dispUnit;
+    MPI_Win_shared_query(window, nodeRank, &size, &dispUnit, static_cast<void*>(&base));
+#else
+    PLB_ASSERT( false );
+#endif
+    return base;
+}
+
+void MpiManager::syncSharedWindow(MPI_Win window)
+{
+#if MPI_VERSION >= 3
+    if (!ok) return;
+    MPI_Win_sync(window);
+#endif
+}
+
+void MpiManager::freeSharedWindow(MPI_Win* window)
+{
+#if MPI_VERSION >= 3
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!ok || finalized) return;
+    MPI_Win_unlock_all(*window);
+    MPI_Win_free(window);
+#endif
+}
+
 }  // namespace global
 
 }  // namespace plb
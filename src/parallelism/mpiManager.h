@@ -95,6 +95,14 @@ public:
     template <typename T>
     void iRecv( T *buf, int count, int source, MPI_Request* request, int tag = 0 );
 
+    /// Creates a persistent request for sending data at *buf
+    template <typename T>
+    void sendInit( T *buf, int count, int dest, MPI_Request* request, int tag = 0 );
+
+    /// Creates a persistent request for receiving data at *buf
+    template <typename T>
+    void recvInit( T *buf, int count, int source, MPI_Request* request, int tag = 0 );
+
     /// Send and receive data between two partners
     template <typename T>
     void sendRecv( T *sendBuf, T *recvBuf, int count, int dest,
@@ -145,6 +153,43 @@ public:
     /// Complete a non-blocking MPI operation
     void wait(MPI_Request* request, MPI_Status* status);
 
+    /// Start a persistent request
+    void start(MPI_Request* request);
+
+    /// Start a collection of persistent requests
+    void startAll(int count, MPI_Request* requests);
+
+    /// Complete any one of a collection of non-blocking MPI operations
+    void waitAny(int count, MPI_Request* requests, int* index, MPI_Status* status);
+
+    /// Complete a collection of non-blocking MPI operations
+    void waitAll(int count, MPI_Request* requests, MPI_Status* statuses);
+
+    /// Release a persistent request
+    void freeRequest(MPI_Request* request);
+
+    /// Returns the number of processes which share the memory of the current node
+    int getNodeSize() const;
+
+    /// Returns the rank of a process among the processes which share the
+    ///   memory of the current node, or -1 if it runs on another node
+    int getNodeRank(int rank) const;
+
+    /// Allocates a window of numBytes bytes in the memory shared by the
+    ///   processes of the node (collective over the processes of the node)
+    char* allocateSharedWindow(plint numBytes, MPI_Win* window);
+
+    /// Returns the address of the part of a shared window which belongs
+    ///   to a process of the node
+    char* querySharedWindow(MPI_Win window, int nodeRank);
+
+    /// Synchronizes the memory of a shared window before or after it is
+    ///   accessed by another process
+    void syncSharedWindow(MPI_Win window);
+
+    /// Frees a shared window (collective over the processes of the node)
+    void freeSharedWindow(MPI_Win* window);
+
 private:
     /// Implementation code for Scatter
     template <typename T>
@@ -155,6 +200,10 @@ private:
     template <typename T>
     void gatherv_impl(T* sendBuf, int sendCount, T* recvBuf, int* recvCounts,
                       int* displs, int root);
+    /// Find the processes which share the memory of the current node
+    void initNodeCommunicator();
+    /// Release the communicator of the node, if there is one
+    void freeNodeCommunicator();
 private:
     MpiManager();
     ~MpiManager();
@@ -163,6 +212,8 @@ private:
     bool ok;
     bool responsibleForMpiMachine;
     MPI_Comm globalCommunicator;
+    MPI_Comm nodeCommunicator;
+    std::vector<int> nodeRanks;
 
 friend MpiManager& mpi();
 };
@@ -184,6 +235,8 @@ public:
     int bossId() const { return 0; }
     /// Tells whether current processor is main processor
     bool isMainProcessor() const { return true; }
+    /// Returns the number of processes which share the memory of the current node
+    int getNodeSize() const { return 1; }
     /// Broadcast data from one processor to multiple processors
     template <typename T>
     void bCast(T* sendBuf, int sendCount, int root = 0) { }
@@ -33,6 +33,7 @@
 #include "core/plbDebug.h"
 #include "core/plbProfiler.h"
 #include <algorithm>
+#include <map>
 #ifdef PLB_MPI_PARALLEL
 #include <mpi.h>
 #endif
@@ -172,20 +173,329 @@ CommunicationPattern3D::CommunicationPattern3D (
     }
 }
 
+////////////////////// Class CommunicationPlan3D /////////////////////
+
+CommunicationPlan3D::CommunicationPlan3D (
+        CommunicationStructure3D const& communication,
+        MultiBlock3D const& multiBlock, bool oriented_ )
+    : oriented(oriented_),
+      hasSharedWindow(false)
+{
+    if (oriented) {
+        std::vector<Channel> localChannels;
+        createChannels(communication.sendRecvPackage, true, multiBlock, localChannels);
+        if (!localChannels.empty()) {
+            localChannel = localChannels[0];
+        }
+    }
+    else {
+        // Local copies of whole cells go directly from block to block.
+        localChannel.messages = communication.sendRecvPackage;
+    }
+    localChannel.data = localChannel.buffer.empty() ? 0 : &localChannel.buffer[0];
+    createChannels(communication.sendPackage, true, multiBlock, sendChannels);
+    createChannels(communication.recvPackage, false, multiBlock, recvChannels);
+    // A process alone on its node shares no memory: no window is allocated.
+    if (global::mpi().getNodeSize() > 1) {
+        createSharedWindow();
+    }
+
+    // The data of a shared channel is not sent: the message only signals
+    //   that it is ready.
+    sendRequests.resize(sendChannels.size());
+    for (pluint iChannel=0; iChannel<sendChannels.size(); ++iChannel) {
+        Channel& channel = sendChannels[iChannel];
+        global::mpi().sendInit(channel.data, (int)channel.buffer.size(),
+                               channel.processId, &sendRequests[iChannel]);
+    }
+    recvRequests.resize(recvChannels.size());
+    for (pluint iChannel=0; iChannel<recvChannels.size(); ++iChannel) {
+        Channel& channel = recvChannels[iChannel];
+        global::mpi().recvInit(channel.data, (int)channel.buffer.size(),
+                               channel.processId, &recvRequests[iChannel]);
+    }
+}
+
+CommunicationPlan3D::~CommunicationPlan3D() {
+    for (pluint iRequest=0; iRequest<sendRequests.size(); ++iRequest) {
+        global::mpi().freeRequest(&sendRequests[iRequest]);
+    }
+    for (pluint iRequest=0; iRequest<recvRequests.size(); ++iRequest) {
+        global::mpi().freeRequest(&recvRequests[iRequest]);
+    }
+    for (pluint iRequest=0; iRequest<readSendRequests.size(); ++iRequest) {
+        global::mpi().freeRequest(&readSendRequests[iRequest]);
+    }
+    for (pluint iRequest=0; iRequest<readRecvRequests.size(); ++iRequest) {
+        global::mpi().freeRequest(&readRecvRequests[iRequest]);
+    }
+    if (hasSharedWindow) {
+        global::mpi().freeSharedWindow(&sharedWindow);
+    }
+}
+
+void CommunicationPlan3D::createSharedWindow()
+{
+    // The signals that the data has been read use their own tag, to
+    //   be distinguished from the data sent in the other direction.
+    static const int readTag = 1;
+    // The offsets use a third tag, to be distinguished from the messages
+    //   of other communicators which may be under way with the default tag.
+    static const int offsetTag = 2;
+    // All processes of the node take part in the allocation, also the ones
+    //   without a shared channel.
+    plint windowSize = 0;
+    for (pluint iChannel=0; iChannel<sendChannels.size(); ++iChannel) {
+        if (global::mpi().getNodeRank(sendChannels[iChannel].processId) >= 0) {
+            windowSize += (plint)sendChannels[iChannel].buffer.size();
+        }
+    }
+    char* base = global::mpi().allocateSharedWindow(windowSize, &sharedWindow);
+    hasSharedWindow = true;
+
+    // The receivers are told where their data is located in the window.
+    std::vector<plint> windowOffsets;
+    std::vector<int> receivers;
+    plint windowOffset = 0;
+    for (pluint iChannel=0; iChannel<sendChannels.size(); ++iChannel) {
+        Channel& channel = sendChannels[iChannel];
+        if (global::mpi().getNodeRank(channel.processId) >= 0) {
+            channel.data = base+windowOffset;
+            channel.readSignal = (plint)readRecvRequests.size();
+            readRecvRequests.push_back(MPI_REQUEST_NULL);
+            windowOffsets.push_back(windowOffset);
+            receivers.push_back(channel.processId);
+            windowOffset += (plint)channel.buffer.size();
+            std::vector<char>().swap(channel.buffer);
+        }
+    }
+    std::vector<MPI_Request> offsetRequests(windowOffsets.size());
+    for (pluint iOffset=0; iOffset<windowOffsets.size(); ++iOffset) {
+        global::mpi().iSend( &windowOffsets[iOffset], 1, receivers[iOffset],
+                             &offsetRequests[iOffset], offsetTag );
+    }
+    for (pluint iChannel=0; iChannel<recvChannels.size(); ++iChannel) {
+        Channel& channel = recvChannels[iChannel];
+        int nodeRank = global::mpi().getNodeRank(channel.processId);
+        if (nodeRank >= 0) {
+            plint offset;
+            global::mpi().receive(&offset, 1, channel.processId, offsetTag);
+            channel.data = global::mpi().querySharedWindow(sharedWindow, nodeRank) + offset;
+            channel.readSignal = (plint)readSendRequests.size();
+            readSendRequests.push_back(MPI_REQUEST_NULL);
+            std::vector<char>().swap(channel.buffer);
+        }
+    }
+    for (pluint iOffset=0; iOffset<offsetRequests.size(); ++iOffset) {
+        MPI_Status status;
+        global::mpi().wait(&offsetRequests[iOffset], &status);
+    }
+
+    for (pluint iChannel=0; iChannel<sendChannels.size(); ++iChannel) {
+        Channel& channel = sendChannels[iChannel];
+        if (channel.readSignal >= 0) {
+            global::mpi().recvInit( channel.data, 0, channel.processId,
+                                    &readRecvRequests[channel.readSignal], readTag );
+        }
+    }
+    for (pluint iChannel=0; iChannel<recvChannels.size(); ++iChannel) {
+        Channel& channel = recvChannels[iChannel];
+        if (channel.readSignal >= 0) {
+            global::mpi().sendInit( channel.data, 0, channel.processId,
+                                    &readSendRequests[channel.readSignal], readTag );
+        }
+    }
+}
+
+void CommunicationPlan3D::createChannels (
+        CommunicationPackage3D const& package, bool sending,
+        MultiBlock3D const& multiBlock, std::vector<Channel>& channels )
+{
+    // The messages keep the order of the package inside a channel, which
+    //   is the same order on the sending and on the receiving side.
+    std::map<int,pluint> channelIds;
+    for (pluint iMessage=0; iMessage<package.size(); ++iMessage) {
+        CommunicationInfo3D const& info = package[iMessage];
+        Dot3D orientation;
+        plint sizeOfCell = multiBlock.sizeOfCell();
+        if (oriented) {
+            orientation = computeOrientation(info, multiBlock);
+            AtomicBlock3D const& localBlock = multiBlock.getComponent (
+                    sending ? info.fromBlockId : info.toBlockId );
+            sizeOfCell = localBlock.getDataTransfer().orientedCellSize(orientation);
+        }
+        plint messageSize = info.fromDomain.nCells()*sizeOfCell;
+        if (messageSize==0) continue;
+        int processId = sending ? info.toProcessId : info.fromProcessId;
+        std::map<int,pluint>::const_iterator it = channelIds.find(processId);
+        pluint iChannel;
+        if (it == channelIds.end()) {
+            iChannel = channels.size();
+            channelIds[processId] = iChannel;
+            channels.push_back(Channel());
+            channels.back().processId = processId;
+            channels.back().readSignal = -1;
+        }
+        else {
+            iChannel = it->second;
+        }
+        Channel& channel = channels[iChannel];
+        channel.messages.push_back(info);
+        channel.orientations.push_back(orientation);
+        channel.offsets.push_back((plint)channel.buffer.size());
+        channel.buffer.resize(channel.buffer.size()+messageSize);
+    }
+    for (pluint iChannel=0; iChannel<channels.size(); ++iChannel) {
+        Channel& channel = channels[iChannel];
+        channel.data = channel.buffer.empty() ? 0 : &channel.buffer[0];
+    }
+}
+
+Dot3D CommunicationPlan3D::computeOrientation (
+        CommunicationInfo3D const& info, MultiBlock3D const& multiBlock )
+{
+    MultiBlockManagement3D const& management = multiBlock.getMultiBlockManagement();
+    SmartBulk3D bulk(management, info.toBlockId);
+    Box3D localBulk(bulk.toLocal(bulk.getBulk()));
+    Box3D const& domain = info.toDomain;
+    return Dot3D (
+            domain.x0 > localBulk.x1 ? 1 : (domain.x1 < localBulk.x0 ? -1 : 0),
+            domain.y0 > localBulk.y1 ? 1 : (domain.y1 < localBulk.y0 ? -1 : 0),
+            domain.z0 > localBulk.z1 ? 1 : (domain.z1 < localBulk.z0 ? -1 : 0) );
+}
+
+void CommunicationPlan3D::send (
+        AtomicBlock3D const& fromBlock, Box3D domain, char* buffer, Dot3D orientation ) const
+{
+    if (oriented) {
+        fromBlock.getDataTransfer().sendOriented(domain, buffer, orientation);
+    }
+    else {
+        fromBlock.getDataTransfer().sendStatic(domain, buffer);
+    }
+}
+
+void CommunicationPlan3D::receive (
+        AtomicBlock3D& toBlock, Box3D domain, char const* buffer,
+        Dot3D orientation, Dot3D absoluteOffset ) const
+{
+    if (oriented) {
+        toBlock.getDataTransfer().receiveOriented(domain, buffer, orientation, absoluteOffset);
+    }
+    else {
+        toBlock.getDataTransfer().receiveStatic(domain, buffer, absoluteOffset);
+    }
+}
+
+void CommunicationPlan3D::start(MultiBlock3D const& originMultiBlock)
+{
+    global::profiler().start("mpiCommunication");
+    if (!recvRequests.empty()) {
+        global::mpi().startAll((int)recvRequests.size(), &recvRequests[0]);
+    }
+    if (!readRecvRequests.empty()) {
+        global::mpi().startAll((int)readRecvRequests.size(), &readRecvRequests[0]);
+        // The receivers are done with the previous data.
+        global::mpi().syncSharedWindow(sharedWindow);
+    }
+    // Each send is started as soon as its buffer is packed.
+    for (pluint iChannel=0; iChannel<sendChannels.size(); ++iChannel) {
+        Channel& channel = sendChannels[iChannel];
+        for (pluint iMessage=0; iMessage<channel.messages.size(); ++iMessage) {
+            CommunicationInfo3D const& info = channel.messages[iMessage];
+            send( originMultiBlock.getComponent(info.fromBlockId), info.fromDomain,
+                  channel.data+channel.offsets[iMessage], channel.orientations[iMessage] );
+        }
+        if (channel.readSignal >= 0) {
+            global::mpi().syncSharedWindow(sharedWindow);
+        }
+        else {
+            global::profiler().increment("mpiSendChar", (plint)channel.buffer.size());
+        }
+        global::mpi().start(&sendRequests[iChannel]);
+    }
+    global::profiler().stop("mpiCommunication");
+}
+
+void CommunicationPlan3D::finish (
+        MultiBlock3D const& originMultiBlock, MultiBlock3D& destinationMultiBlock )
+{
+    global::profiler().start("mpiCommunication");
+    // Local copies which require no communication.
+    for (pluint iMessage=0; iMessage<localChannel.messages.size(); ++iMessage) {
+        CommunicationInfo3D const& info = localChannel.messages[iMessage];
+        AtomicBlock3D const& fromBlock = originMultiBlock.getComponent(info.fromBlockId);
+        AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
+        if (oriented) {
+            char* buffer = localChannel.data+localChannel.offsets[iMessage];
+            send(fromBlock, info.fromDomain, buffer, localChannel.orientations[iMessage]);
+            receive( toBlock, info.toDomain, buffer,
+                     localChannel.orientations[iMessage], info.absoluteOffset );
+        }
+        else {
+            plint deltaX = info.fromDomain.x0 - info.toDomain.x0;
+            plint deltaY = info.fromDomain.y0 - info.toDomain.y0;
+            plint deltaZ = info.fromDomain.z0 - info.toDomain.z0;
+            toBlock.getDataTransfer().attribute (
+                    info.toDomain, deltaX, deltaY, deltaZ, fromBlock,
+                    modif::staticVariables, info.absoluteOffset );
+        }
+    }
+
+    // Unpack the channels in the order in which they arrive.
+    for (pluint iRecv=0; iRecv<recvChannels.size(); ++iRecv) {
+        int iChannel;
+        MPI_Status status;
+        global::mpi().waitAny((int)recvRequests.size(), &recvRequests[0], &iChannel, &status);
+        PLB_ASSERT(iChannel != MPI_UNDEFINED);
+        Channel const& channel = recvChannels[iChannel];
+        if (channel.readSignal >= 0) {
+            global::mpi().syncSharedWindow(sharedWindow);
+        }
+        for (pluint iMessage=0; iMessage<channel.messages.size(); ++iMessage) {
+            CommunicationInfo3D const& info = channel.messages[iMessage];
+            receive( destinationMultiBlock.getComponent(info.toBlockId), info.toDomain,
+                     channel.data+channel.offsets[iMessage],
+                     channel.orientations[iMessage], info.absoluteOffset );
+        }
+        if (channel.readSignal >= 0) {
+            global::mpi().start(&readSendRequests[channel.readSignal]);
+        }
+    }
+
+    if (!sendRequests.empty()) {
+        global::mpi().waitAll((int)sendRequests.size(), &sendRequests[0], MPI_STATUSES_IGNORE);
+    }
+    // The shared data may only be overwritten once it has been read.
+    if (!readRecvRequests.empty()) {
+        global::mpi().waitAll((int)readRecvRequests.size(), &readRecvRequests[0], MPI_STATUSES_IGNORE);
+    }
+    if (!readSendRequests.empty()) {
+        global::mpi().waitAll((int)readSendRequests.size(), &readSendRequests[0], MPI_STATUSES_IGNORE);
+    }
+    global::profiler().stop("mpiCommunication");
+}
+
 ////////////////////// Class ParallelBlockCommunicator3D /////////////////////
 
 ParallelBlockCommunicator3D::ParallelBlockCommunicator3D()
     : overlapsModified(true),
-      communication(0)
+      communication(0),
+      plan(0),
+      orientedPlan(0)
 { }
 
 ParallelBlockCommunicator3D::ParallelBlockCommunicator3D (
         ParallelBlockCommunicator3D const& rhs )
     : overlapsModified(true),
-      communication(0)
+      communication(0),
+      plan(0),
+      orientedPlan(0)
 { }
 
 ParallelBlockCommunicator3D::~ParallelBlockCommunicator3D() {
+    delete orientedPlan;
+    delete plan;
     delete communication;
 }
 
@@ -199,6 +509,8 @@ ParallelBlockCommunicator3D& ParallelBlockCommunicator3D::operator= (
 void ParallelBlockCommunicator3D::swap(ParallelBlockCommunicator3D& rhs) {
     std::swap(overlapsModified,rhs.overlapsModified);
     std::swap(communication,rhs.communication);
+    std::swap(plan,rhs.plan);
+    std::swap(orientedPlan,rhs.orientedPlan);
 }
 
 ParallelBlockCommunicator3D* ParallelBlockCommunicator3D::clone() const {
@@ -207,6 +519,60 @@ ParallelBlockCommunicator3D* ParallelBlockCommunicator3D::clone() const {
 
 void ParallelBlockCommunicator3D::duplicateOverlaps( MultiBlock3D& multiBlock,
                                                      modif::ModifT whichData ) const
+{
+    updateCommunication(multiBlock);
+    if (usesPlan(multiBlock, whichData)) {
+        updatePlan(multiBlock);
+        plan->start(multiBlock);
+        plan->finish(multiBlock, multiBlock);
+    }
+    else {
+        communicate(*communication, multiBlock, multiBlock, whichData);
+    }
+}
+
+void ParallelBlockCommunicator3D::startDuplicateOverlaps( MultiBlock3D& multiBlock,
+                                                          modif::ModifT whichData ) const
+{
+    updateCommunication(multiBlock);
+    if (usesPlan(multiBlock, whichData)) {
+        updatePlan(multiBlock);
+        plan->start(multiBlock);
+    }
+    else {
+        startCommunication(*communication, multiBlock, whichData);
+    }
+}
+
+void ParallelBlockCommunicator3D::finishDuplicateOverlaps( MultiBlock3D& multiBlock,
+                                                           modif::ModifT whichData ) const
+{
+    PLB_ASSERT(communication != 0);
+    if (usesPlan(multiBlock, whichData)) {
+        PLB_ASSERT(plan != 0);
+        plan->finish(multiBlock, multiBlock);
+    }
+    else {
+        finishCommunication(*communication, multiBlock, multiBlock, whichData);
+    }
+}
+
+void ParallelBlockCommunicator3D::duplicateOrientedOverlaps(MultiBlock3D& multiBlock) const
+{
+    updateCommunication(multiBlock);
+    if (!usesPlan(multiBlock, modif::staticVariables)) {
+        communicate(*communication, multiBlock, multiBlock, modif::staticVariables);
+        return;
+    }
+    // The oriented plan is only built for the multi-blocks which use it.
+    if (!orientedPlan) {
+        orientedPlan = new CommunicationPlan3D(*communication, multiBlock, true);
+    }
+    orientedPlan->start(multiBlock);
+    orientedPlan->finish(multiBlock, multiBlock);
+}
+
+void ParallelBlockCommunicator3D::updateCommunication(MultiBlock3D const& multiBlock) const
 {
     MultiBlockManagement3D const& multiBlockManagement = multiBlock.getMultiBlockManagement();
     PeriodicitySwitch3D const& periodicity             = multiBlock.periodicity();
@@ -222,14 +588,34 @@ void ParallelBlockCommunicator3D::duplicateOverlaps( MultiBlock3D& multiBlock,
                 overlaps.push_back(pOverlap.overlap);
             }
         }
+        delete orientedPlan;
+        orientedPlan = 0;
+        delete plan;
+        plan = 0;
         delete communication;
         communication = new CommunicationStructure3D (
                                 overlaps,
                                 multiBlockManagement, multiBlockManagement,
                                 multiBlock.sizeOfCell() );
     }
+}
 
-    communicate(*communication, multiBlock, multiBlock, whichData);
+void ParallelBlockCommunicator3D::updatePlan(MultiBlock3D const& multiBlock) const
+{
+    // The plan, and with it the shared window, is only built for the
+    //   multi-blocks which use it, at their first exchange. All processes
+    //   take part in the exchange, so they build it together.
+    if (!plan) {
+        plan = new CommunicationPlan3D(*communication, multiBlock, false);
+    }
+}
+
+bool ParallelBlockCommunicator3D::usesPlan (
+        MultiBlock3D const& multiBlock, modif::ModifT whichData ) const
+{
+    // Blocks without static data, like particle fields, still get the
+    //   empty messages of the generic path, which they may act upon.
+    return whichData == modif::staticVariables && multiBlock.sizeOfCell() > 0;
 }
 
 void ParallelBlockCommunicator3D::communicate (
@@ -252,6 +638,14 @@ void ParallelBlockCommunicator3D::communicate (
         CommunicationStructure3D& communication,
         MultiBlock3D const& originMultiBlock,
         MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const
+{
+    startCommunication(communication, originMultiBlock, whichData);
+    finishCommunication(communication, originMultiBlock, destinationMultiBlock, whichData);
+}
+
+void ParallelBlockCommunicator3D::startCommunication (
+        CommunicationStructure3D& communication,
+        MultiBlock3D const& originMultiBlock, modif::ModifT whichData ) const
 {
     global::profiler().start("mpiCommunication");
     bool staticMessage = whichData == modif::staticVariables;
@@ -267,7 +661,16 @@ void ParallelBlockCommunicator3D::communicate (
                 whichData );
         communication.sendComm.acceptMessage(info.toProcessId, staticMessage);
     }
+    global::profiler().stop("mpiCommunication");
+}
 
+void ParallelBlockCommunicator3D::finishCommunication (
+        CommunicationStructure3D& communication,
+        MultiBlock3D const& originMultiBlock,
+        MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const
+{
+    global::profiler().start("mpiCommunication");
+    bool staticMessage = whichData == modif::staticVariables;
     // 3. Local copies which require no communication.
     for (unsigned iSendRecv=0; iSendRecv<communication.sendRecvPackage.size(); ++iSendRecv) {
         CommunicationInfo3D const& info = communication.sendRecvPackage[iSendRecv];
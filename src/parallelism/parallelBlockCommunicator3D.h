@@ -66,6 +66,67 @@ struct CommunicationStructure3D
     RecvPoolCommunicator recvComm;
 };
 
+/// Pre-packed plan for the exchange of static data between the blocks
+///   of a multi-block.
+/** All messages to and from a given process are merged into one contiguous
+ *  buffer which is allocated once, together with a persistent MPI request.
+ *  The data is serialized in place into the buffers, and no memory is
+ *  allocated or subscribed during the exchange.
+ *
+ *  An oriented plan only transmits the data which points from each envelope
+ *  region away from the bulk of its block (see BlockDataTransfer3D::sendOriented()).
+ *
+ *  With processes on the same node, the sender packs the messages into a
+ *  window of shared memory, and the receiver unpacks them from there. Only
+ *  empty messages go through MPI, to signal that the data is ready and that
+ *  it has been read. Processes on other nodes get the data through MPI.
+ **/
+class CommunicationPlan3D {
+public:
+    CommunicationPlan3D( CommunicationStructure3D const& communication,
+                         MultiBlock3D const& multiBlock, bool oriented_ );
+    ~CommunicationPlan3D();
+    /// Start the receives, and pack and start the sends.
+    void start(MultiBlock3D const& originMultiBlock);
+    /// Do the local copies, unpack the messages as they arrive and
+    ///   complete the sends.
+    void finish(MultiBlock3D const& originMultiBlock, MultiBlock3D& destinationMultiBlock);
+private:
+    /// Messages exchanged with one process, and their offset in the buffer.
+    struct Channel {
+        int processId;
+        CommunicationPackage3D messages;
+        std::vector<Dot3D> orientations;
+        std::vector<plint> offsets;
+        std::vector<char> buffer;
+        /// Packed data, in the buffer or in a shared window.
+        char* data;
+        /// Index of the request which signals that the data has been read,
+        ///   or -1 if the data goes through MPI.
+        plint readSignal;
+    };
+    void createChannels( CommunicationPackage3D const& package, bool sending,
+                         MultiBlock3D const& multiBlock, std::vector<Channel>& channels );
+    /// Move the channels to the processes of the same node into a shared window.
+    void createSharedWindow();
+    /// Position of the domain of a message relative to the bulk of the receiving block.
+    static Dot3D computeOrientation(CommunicationInfo3D const& info, MultiBlock3D const& multiBlock);
+    void send(AtomicBlock3D const& fromBlock, Box3D domain, char* buffer, Dot3D orientation) const;
+    void receive( AtomicBlock3D& toBlock, Box3D domain, char const* buffer,
+                  Dot3D orientation, Dot3D absoluteOffset ) const;
+private:
+    CommunicationPlan3D(CommunicationPlan3D const& rhs);
+    CommunicationPlan3D& operator=(CommunicationPlan3D const& rhs);
+private:
+    bool oriented;
+    Channel localChannel;
+    std::vector<Channel> sendChannels, recvChannels;
+    std::vector<MPI_Request> sendRequests, recvRequests;
+    std::vector<MPI_Request> readSendRequests, readRecvRequests;
+    bool hasSharedWindow;
+    MPI_Win sharedWindow;
+};
+
 
 class ParallelBlockCommunicator3D : public BlockCommunicator3D {
 public:
@@ -77,21 +138,41 @@ public:
     void swap(ParallelBlockCommunicator3D& rhs);
     virtual ParallelBlockCommunicator3D* clone() const;
     virtual void duplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const;
+    virtual void startDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const;
+    virtual void finishDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const;
+    virtual void duplicateOrientedOverlaps(MultiBlock3D& multiBlock) const;
     virtual void communicate( std::vector<Overlap3D> const& overlaps,
                               MultiBlock3D const& originMultiBlock,
                               MultiBlock3D& destinationMultiBlock,
                               modif::ModifT whichData ) const;
     virtual void signalPeriodicity() const;
 private:
+    /// Recompute the cached communication structure if the overlaps changed,
+    ///   and discard the plans built for the previous one.
+    void updateCommunication(MultiBlock3D const& multiBlock) const;
+    /// Build the plan of the current communication structure, if not done yet.
+    void updatePlan(MultiBlock3D const& multiBlock) const;
+    /// Tell whether the exchange goes through the pre-packed plan.
+    bool usesPlan(MultiBlock3D const& multiBlock, modif::ModifT whichData) const;
     void communicate( CommunicationStructure3D& communication,
                       MultiBlock3D const& originMultiBlock,
                       MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const;
+    /// Post the receives, and pack and post the sends.
+    void startCommunication( CommunicationStructure3D& communication,
+                             MultiBlock3D const& originMultiBlock,
+                             modif::ModifT whichData ) const;
+    /// Do the local copies, unpack the receives and wait for the sends.
+    void finishCommunication( CommunicationStructure3D& communication,
+                              MultiBlock3D const& originMultiBlock,
+                              MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const;
     void subscribeOverlap (
         Overlap3D const& overlap, MultiBlockManagement3D const& multiBlockManagement,
         SendRecvPool& sendPool, SendRecvPool& recvPool, plint sizeOfCell ) const;
 private:
     mutable bool overlapsModified;
     mutable CommunicationStructure3D* communication;
+    mutable CommunicationPlan3D* plan;
+    mutable CommunicationPlan3D* orientedPlan;
 };
 
 
@@ -45,41 +45,39 @@ void ParallelCombinedStatistics::reduceStatistics (
             std::vector<double>& maxObservables,
             std::vector<plint>& intSumObservables ) const
 {
-    // Averages
-    for (pluint iAverage=0; iAverage<averageObservables.size(); ++iAverage) {
-        double globalAverage, globalWeight;
-        global::mpi().reduce(averageObservables[iAverage]*sumWeights[iAverage], globalAverage, MPI_SUM);
-        global::mpi().reduce(sumWeights[iAverage], globalWeight, MPI_SUM);
-        if (global::mpi().isMainProcessor() && std::fabs(globalWeight) > 0.5) {
+    // All observables of a given reduction operation are packed into a
+    // single vector, so that the number of collective communications does
+    // not grow with the number of subscribed observables.
+
+    // Averages and sums: [ average*weight | weight | sum ]
+    pluint numAverages = averageObservables.size();
+    pluint numSums = sumObservables.size();
+    std::vector<double> packedSums(2*numAverages+numSums);
+    for (pluint iAverage=0; iAverage<numAverages; ++iAverage) {
+        packedSums[iAverage] = averageObservables[iAverage]*sumWeights[iAverage];
+        packedSums[numAverages+iAverage] = sumWeights[iAverage];
+    }
+    for (pluint iSum=0; iSum<numSums; ++iSum) {
+        packedSums[2*numAverages+iSum] = sumObservables[iSum];
+    }
+    global::mpi().allReduceVect(packedSums, MPI_SUM);
+    for (pluint iAverage=0; iAverage<numAverages; ++iAverage) {
+        double globalAverage = packedSums[iAverage];
+        double globalWeight  = packedSums[numAverages+iAverage];
+        if (std::fabs(globalWeight) > 0.5) {
             globalAverage /= globalWeight;
         }
-        global::mpi().bCast(&globalAverage, 1);
         averageObservables[iAverage] = globalAverage;
     }
-
-    // Sum
-    for (pluint iSum=0; iSum<sumObservables.size(); ++iSum) {
-        double globalSum;
-        global::mpi().reduce(sumObservables[iSum], globalSum, MPI_SUM);
-        global::mpi().bCast(&globalSum, 1);
-        sumObservables[iSum] = globalSum;
+    for (pluint iSum=0; iSum<numSums; ++iSum) {
+        sumObservables[iSum] = packedSums[2*numAverages+iSum];
     }
 
     // Max
-    for (pluint iMax=0; iMax<maxObservables.size(); ++iMax) {
-        double globalMax;
-        global::mpi().reduce(maxObservables[iMax], globalMax, MPI_MAX);
-        global::mpi().bCast(&globalMax, 1);
-        maxObservables[iMax] = globalMax;
-    }
+    global::mpi().allReduceVect(maxObservables, MPI_MAX);
 
     // Integer sum
-    for (pluint iSum=0; iSum<intSumObservables.size(); ++iSum) {
-        plint globalSum;
-        global::mpi().reduce(intSumObservables[iSum], globalSum, MPI_SUM);
-        global::mpi().bCast(&globalSum, 1);
-        intSumObservables[iSum] = globalSum;
-    }
+    global::mpi().allReduceVect(intSumObservables, MPI_SUM);
 }
 
 #endif  // PLB_MPI_PARALLEL
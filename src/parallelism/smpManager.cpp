@@ -0,0 +1,124 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Threads which share the work on the local blocks of a process.
+ */
+
+#include "parallelism/smpManager.h"
+#include "core/plbProfiler.h"
+#include <cstdlib>
+#ifdef PLB_SMP_PARALLEL
+#include <omp.h>
+#endif
+
+namespace plb {
+
+namespace global {
+
+SmpManager::SmpManager()
+    : numThreads(1),
+      singleThreaded(false)
+{
+#ifdef PLB_SMP_PARALLEL
+    if (std::getenv("OMP_NUM_THREADS")) {
+        numThreads = omp_get_max_threads();
+    }
+#endif
+}
+
+int SmpManager::getNumThreads() const {
+    return numThreads;
+}
+
+void SmpManager::setNumThreads(int numThreads_) {
+    PLB_PRECONDITION( numThreads_>=1 );
+#ifdef PLB_SMP_PARALLEL
+    if (!singleThreaded) {
+        numThreads = numThreads_;
+    }
+#endif
+}
+
+int SmpManager::getThreadId() const {
+#ifdef PLB_SMP_PARALLEL
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+void SmpManager::restrictToSingleThread() {
+    singleThreaded = true;
+    numThreads = 1;
+}
+
+}  // namespace global
+
+
+BlockSchedule::BlockSchedule (
+        std::vector<plint> const& blocks, ThreadAttribution const& attribution,
+        bool concurrent )
+    : numThreads( (!concurrent || global::profiler().doProfiling()) ?
+                  1 : global::smp().getNumThreads() )
+{
+    if ((plint)blocks.size() < numThreads) {
+        numThreads = std::max((int)blocks.size(), 1);
+    }
+    queues.resize(numThreads);
+    positions.resize(numThreads, 0);
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        int thread = attribution.getLocalThreadId(blocks[iBlock]) % numThreads;
+        queues[thread].push_back(iBlock);
+    }
+}
+
+int BlockSchedule::getNumThreads() const {
+    return numThreads;
+}
+
+bool BlockSchedule::next(plint& iBlock) {
+    int threadId = global::smp().getThreadId();
+    for (int iQueue=0; iQueue<numThreads; ++iQueue) {
+        if (take((threadId+iQueue)%numThreads, iBlock)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BlockSchedule::take(int iQueue, plint& iBlock) {
+    plint position;
+#ifdef PLB_SMP_PARALLEL
+    #pragma omp atomic capture
+#endif
+    position = positions[iQueue]++;
+    if (position < (plint)queues[iQueue].size()) {
+        iBlock = queues[iQueue][position];
+        return true;
+    }
+    return false;
+}
+
+}  // namespace plb
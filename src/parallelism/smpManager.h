@@ -0,0 +1,113 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Threads which share the work on the local blocks of a process -- header file.
+ */
+
+#ifndef SMP_MANAGER_H
+#define SMP_MANAGER_H
+
+#include "core/globalDefs.h"
+#include "multiBlock/threadAttribution.h"
+#include <vector>
+
+namespace plb {
+
+namespace global {
+
+/// Number of threads which execute the loops over the local blocks of a process
+/** Without PLB_SMP_PARALLEL, there is always one thread. With it, the
+ *  default is the value of OMP_NUM_THREADS if this environment variable is
+ *  set, and one thread otherwise, so that runs with one MPI process per core
+ *  are not oversubscribed. Only the main thread calls MPI; if the MPI library
+ *  does not provide MPI_THREAD_FUNNELED, a single thread is used.
+ */
+class SmpManager {
+public:
+    /// Number of threads used for the block loops
+    int getNumThreads() const;
+    /// Change the number of threads used for the block loops
+    void setNumThreads(int numThreads_);
+    /// Id of the calling thread in the current block loop (0 outside of it)
+    int getThreadId() const;
+    /// Use a single thread from now on, whatever is requested later; called
+    ///   when the MPI library cannot be used next to threads
+    void restrictToSingleThread();
+private:
+    SmpManager();
+private:
+    int numThreads;
+    bool singleThreaded;
+friend SmpManager& smp();
+};
+
+inline SmpManager& smp() {
+    static SmpManager instance;
+    return instance;
+}
+
+}  // namespace global
+
+/// Distribution of the local blocks of a process on the threads of a block loop
+/** Every thread first processes the blocks attributed to it by
+ *  ThreadAttribution::getLocalThreadId() (modulo the number of threads), in
+ *  order, and then steals the remaining blocks from the queues of the other
+ *  threads. A block loop reads:
+ *  \code
+ *  BlockSchedule schedule(blocks, threadAttribution);
+ *  #ifdef PLB_SMP_PARALLEL
+ *  #pragma omp parallel num_threads(schedule.getNumThreads())
+ *  #endif
+ *  {
+ *      plint iBlock;
+ *      while (schedule.next(iBlock)) {
+ *          // Process blocks[iBlock].
+ *      }
+ *  }
+ *  \endcode
+ *  The profiler is not thread-safe: while it is active, a single thread is used.
+ *  A single thread is also used if concurrent is false, for work which is
+ *  not independent from block to block.
+ */
+class BlockSchedule {
+public:
+    BlockSchedule( std::vector<plint> const& blocks, ThreadAttribution const& attribution,
+                   bool concurrent=true );
+    int getNumThreads() const;
+    /// Get the position in the list of blocks of the next block to be processed
+    ///   by the calling thread. Returns false when all blocks are taken.
+    bool next(plint& iBlock);
+private:
+    /// Take the next block of a queue, if any is left.
+    bool take(int iQueue, plint& iBlock);
+private:
+    int numThreads;
+    std::vector<std::vector<plint> > queues;
+    std::vector<plint> positions;
+};
+
+}  // namespace plb
+
+#endif  // SMP_MANAGER_H